@@ -53,10 +53,10 @@ int do_gc_for_split(struct SSD *ssd, struct STATS *stats, class GROUP *group[],
     //whole group is naive MiDA mode (HOT group is naive MiDA too)
     if (ssd_spec->naive_start == 1) select_group = ssd_spec->naive_start;
     int victim_seg = victim_selection(ssd, stats,group, select_group); //victim segment selection
-    int victim_idx = victim_seg*ssd_spec->PPS; //victim segment entry point (page)
+    ppa_t victim_idx = (ppa_t)victim_seg*ssd_spec->PPS; //victim segment entry point (page)
     int target_group; //destination group of valid page (copy target group)
-    int copy_lba; //valid page lba 
-    int new_ppa; //new assigned ppa for valid copy
+    lba_t copy_lba; //valid page lba 
+    ppa_t new_ppa; //new assigned ppa for valid copy
     int victim_gnum = ssd->gnum_info[victim_seg];
 
     if (victim_gnum < ssd_spec->GROUPNUM-1) target_group = victim_gnum + 1; //goto next group if victim group is not last group
@@ -96,14 +96,14 @@ int do_gc_for_split(struct SSD *ssd, struct STATS *stats, class GROUP *group[],
             ssd->seg_stamp[now_active]=-1;
         }
 
-        if(ssd->itable[victim_idx+i] == false && ssd->oob[victim_idx+i].lba != -1){ //if the page in the victim segment is valid,
+        if(itable_get(ssd, victim_idx+i) == false && ssd->oob[victim_idx+i].lba != -1){ //if the page in the victim segment is valid,
             local_copy += 1;
             copy_lba = ssd->oob[victim_idx+i].lba; //get lba of valid page
             gc_compacted_lbas.push_back(copy_lba);
             if (victim_gnum == 0 || victim_gnum == 1) {
                 hf_generate (ssd, copy_lba, victim_seg, group, hf_gen, 0);
             }
-            new_ppa = now_active*ssd_spec->PPS + ssd->active[target_group][1]; //assign new ppa for valid page
+            new_ppa = (ppa_t)now_active*ssd_spec->PPS + ssd->active[target_group][1]; //assign new ppa for valid page
             ssd->mtable[copy_lba] = new_ppa; //update mapping entry for valid page
             ssd->oob[new_ppa].lba = copy_lba; //record lba in the oob space 
             //setting segment age when the first page is written
@@ -292,14 +292,15 @@ int mida_off(struct SSD *ssd, struct STATS *stats, class GROUP *group[]){
 
 //Active Segment Merge (by Group merge)
 int active_merge(struct SSD *ssd, struct STATS *stats, class GROUP *group[], int target_g, int victim_g){
-    int copy_lba, new_ppa;
+    lba_t copy_lba;
+    ppa_t new_ppa;
     int local_copy = 0;
     int fill_idx = -1;
     int old_active = ssd->active[victim_g][0];
     if (old_active == -1) {
         return -1;
     }
-    int victim_idx = old_active*ssd_spec->PPS;
+    ppa_t victim_idx = (ppa_t)old_active*ssd_spec->PPS;
     int old_active_fill = ssd->active[victim_g][1];
     int now_active = ssd->active[target_g][0];
     for (int i = 0; i < old_active_fill; i++){
@@ -319,19 +320,19 @@ int active_merge(struct SSD *ssd, struct STATS *stats, class GROUP *group[], int
             //ssd->seg_stamp[now_active]=stats->cur_wp;
         }
 
-        if(ssd->itable[victim_idx+i] == false){ //if the page in the victim segment is valid,
+        if(itable_get(ssd, victim_idx+i) == false){ //if the page in the victim segment is valid,
             local_copy += 1;
             copy_lba = ssd->oob[victim_idx+i].lba; //get lba of valid page
             gc_compacted_lbas.push_back(copy_lba);
-            new_ppa = now_active*ssd_spec->PPS + ssd->active[target_g][1]; //assign new ppa for valid page
+            new_ppa = (ppa_t)now_active*ssd_spec->PPS + ssd->active[target_g][1]; //assign new ppa for valid page
             ssd->mtable[copy_lba] = new_ppa; //update mapping entry for valid page
             ssd->oob[new_ppa].lba = copy_lba; //record lba in the oob space
             ssd->active[target_g][1] += 1; //update appending point of target group
         }
     }
     compacted_blocks_global.fetch_add(static_cast<unsigned long long>(local_copy), std::memory_order_relaxed);
+    memset(&ssd->itable[victim_idx >> 6], 0, ssd_spec->PPS/8); //invalid T/F clear
     for (int i = 0; i < ssd_spec->PPS; i++) { //erase segment
-        ssd->itable[victim_idx+i] = 0; //invalid T/F clear
         ssd->oob[victim_idx+i].lba = -1; //oob clear
     }
     ssd->irtable[old_active] = 0; //invalid page counter clear
@@ -506,9 +507,31 @@ int change_config_2(struct SSD* ssd, struct STATS *stats, class GROUP *group[]){
     return margin_fseg;
 }
 
+//take the model worker's result (if it has finished) and move it into ginfo
+static void taking_model_result() {
+    MODEL_RESULT *res = model_take_result(mmodel);
+    if (res == NULL) return;
+    if (res->action == MODEL_APPLY) {
+        ginfo->model_ver = res->model_ver;
+        memcpy(ginfo->gsize, res->gsize, sizeof(uint32_t)*10);
+        memcpy(ginfo->vr, res->vr, sizeof(double)*10);
+        ginfo->gnum = res->gnum;
+        ginfo->WAF = res->WAF;
+        ginfo->g0_traffic = res->g0_traffic;
+        ginfo->valid = true;
+    } else if (res->action == MODEL_RESIZE) {
+        model_resizing_timewindow(mmodel, mmodel->time_window*2);
+        model_initialize(mmodel, true);
+    } else if (res->action == MODEL_RESTART) {
+        model_initialize(mmodel, true);
+    }
+    free(res);
+}
+
 //checking if ginfo is valid
 //if ginfo is valid, then compare the WAF and apply the new configuration
 int checking_ginfo(struct SSD* ssd, struct STATS* stats, class GROUP *group[]) {
+    taking_model_result();
     if ((ginfo->valid == false)) return 0;
     int APPLY_FLAG=0;
     //check if the new WAF is lower than the current WAF
@@ -558,7 +581,7 @@ void checking_err_time(struct SSD* ssd, struct STATS* stats, class GROUP *group[
     return;
 }
 
-void modeling_check(struct SSD* ssd, struct STATS* stats, class GROUP *group[], int user_group, int lba) {
+void modeling_check(struct SSD* ssd, struct STATS* stats, class GROUP *group[], int user_group, lba_t lba) {
     //TODO change the condition to checking interval
     if (mmodel->model_on) {
         int res = check_time_window(mmodel, WRITE);
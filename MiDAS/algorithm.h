@@ -15,7 +15,7 @@ int move_margin_seg(struct SSD* ssd, struct STATS *stats, class GROUP *group[],
 int change_config_2(struct SSD* ssd, struct STATS *stats, class GROUP *group[]);
 int checking_ginfo(struct SSD* ssd, struct STATS* stats, class GROUP *group[]);
 void checking_err_time(struct SSD* ssd, struct STATS* stats, class GROUP *group[]);
-void modeling_check(struct SSD* ssd, struct STATS* stats, class GROUP *group[], int user_group, int lba);
+void modeling_check(struct SSD* ssd, struct STATS* stats, class GROUP *group[], int user_group, lba_t lba);
 void checking_config_apply(struct SSD* ssd, struct STATS* stats, class GROUP *group[], int gc_group);
 int infinite_gc_handling(struct SSD* ssd, struct STATS* stats, class GROUP *group[], int gc_group);
 void group_number_check(struct SSD *ssd);
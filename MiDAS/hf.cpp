@@ -49,15 +49,19 @@ void hf_init(struct SSD* ssd, struct HotFilter **hotf){
         (*hotf)->hot_lba_num = 0;
         (*hotf)->valid_lba_num=0.;
 
-        (*hotf)->cur_hf = (int*)malloc(sizeof(int)*ssd_spec->LBANUM);
+        (*hotf)->cur_hf = (uint64_t*)calloc(HF_WORDS(ssd_spec->LBASPACE), sizeof(uint64_t));
         //hotf->new_hf = (int*)malloc(sizeof(int)*ssd_spec->LBANUM);
 
-        memset((*hotf)->cur_hf, 0, sizeof(int)*ssd_spec->LBANUM);
-        //memset(hotf->new_hf, 0, sizeof(int)*ssd_spec->LBANUM);
-
         (*hotf)->err_cnt=0;
 }
 
+//grow the per-lba counters together with the mapping table (new lbas start cold)
+void hf_grow(struct HotFilter *hotf, long long old_space, long long new_space) {
+        long long old_words = HF_WORDS(old_space), new_words = HF_WORDS(new_space);
+        hotf->cur_hf = (uint64_t*)realloc(hotf->cur_hf, sizeof(uint64_t)*new_words);
+        memset(hotf->cur_hf+old_words, 0, sizeof(uint64_t)*(new_words-old_words));
+}
+
 void hf_destroy(struct HotFilter *hotf) {
         free(hotf->cur_hf);
         //free(hotf->new_nf);
@@ -83,7 +87,7 @@ void hf_metadata_reset(struct HotFilter *hotf){
 
 //Hot filter reset default: flag->0
 void hf_reset(int flag, struct HotFilter *hotf){
-        memset(hotf->cur_hf, 0, sizeof(int)*ssd_spec->LBANUM);
+        memset(hotf->cur_hf, 0, sizeof(uint64_t)*HF_WORDS(ssd_spec->LBASPACE));
         hotf->left_tw = hotf->tw;        
         if (flag == 1) hotf->make_flag = 1; // not used 
         hotf->use_flag = 0;
@@ -173,7 +177,7 @@ void hf_convert_generate_to_run(struct HotFilter *hotf) {
 //Hot filter generate code
 //old seg: segment that the lba was placed before
 //user_group: group number that the lba is moving
-void hf_generate(struct SSD *ssd, int lba, int old_seg, class GROUP *group[], struct HotFilter *hotf, int hflag){
+void hf_generate(struct SSD *ssd, lba_t lba, int old_seg, class GROUP *group[], struct HotFilter *hotf, int hflag){
         //if the hotfilter is not generating
         if (hotf->make_flag == 0) {
                 return;
@@ -202,12 +206,13 @@ void hf_generate(struct SSD *ssd, int lba, int old_seg, class GROUP *group[], st
         }
 
 
+        int cnt = hf_get(hotf, lba);
         if (hflag) {
                 if (ssd->gnum_info[old_seg] == 0) {
                         //LBA in group 0 is pretended HOT regardless of the age
-                        if (hotf->cur_hf[lba] <= hotf->max_val-1) {
-                                hotf->cur_hf[lba]++; //increase counter of the LBA
-                                if (hotf->cur_hf[lba] == hotf->hot_val) hotf->hot_lba_num++;
+                        if (cnt <= hotf->max_val-1) {
+                                cnt++; //increase counter of the LBA
+                                if (cnt == hotf->hot_val) hotf->hot_lba_num++;
                         }
                 } else if (ssd->gnum_info[old_seg] == 1) {
                         //LBA in group 1 is not in current hotfilter
@@ -221,32 +226,33 @@ void hf_generate(struct SSD *ssd, int lba, int old_seg, class GROUP *group[], st
                         //(hotf->tw / tw_ratio) is the average G0 age
                         double tmp_age = hotf->tw/hotf->tw_ratio;
                         if (seg_age <= tmp_age) {
-                                if (hotf->cur_hf[lba] <= hotf->max_val-1) {
-                                        hotf->cur_hf[lba]++;
-                                        if (hotf->cur_hf[lba] == hotf->hot_val) hotf->hot_lba_num++;
+                                if (cnt <= hotf->max_val-1) {
+                                        cnt++;
+                                        if (cnt == hotf->hot_val) hotf->hot_lba_num++;
                                 }
                         }
                         else {
                                 //invalid lba in group 1 victim, but the age is too long
-                                if (hotf->cur_hf[lba] > 0) {
-                                        hotf->cur_hf[lba]--;
-                                        //if (hotf->cur_hf[lba] == (hotf->max_val-1)) hotf->hot_lba_num--;
-                                        if (hotf->cur_hf[lba] == (hotf->hot_val-1)) hotf->hot_lba_num--;
+                                if (cnt > 0) {
+                                        cnt--;
+                                        //if (cnt == (hotf->max_val-1)) hotf->hot_lba_num--;
+                                        if (cnt == (hotf->hot_val-1)) hotf->hot_lba_num--;
                                 }
                         }
                 }
         } else {
                 //valid lba in group 0 victim
                 //TODO --? or avg_age check?
-                if (hotf->cur_hf[lba] > 0) {
-                        hotf->cur_hf[lba]--;
-                        if (hotf->cur_hf[lba] == hotf->hot_val-1) hotf->hot_lba_num--;
-                        if (ssd->gnum_info[old_seg] == 0) hotf->cur_hf[lba]--; //hot penalty
+                if (cnt > 0) {
+                        cnt--;
+                        if (cnt == hotf->hot_val-1) hotf->hot_lba_num--;
+                        if ((ssd->gnum_info[old_seg] == 0) && (cnt > 0)) cnt--; //hot penalty (saturates at 0)
                 }
         }
+        hf_set(hotf, lba, cnt);
 }
 
-void hf_calculate_valid_lba(int lba, int group_num, char vflag, struct HotFilter *hotf) {
+void hf_calculate_valid_lba(lba_t lba, int group_num, char vflag, struct HotFilter *hotf) {
         if (vflag == 0) {
                 //write (valid)
                 if (group_num == 0) hotf->valid_lba_num++;
@@ -261,18 +267,12 @@ void hf_calculate_valid_lba(int lba, int group_num, char vflag, struct HotFilter
 }
 
 //check wthether the LBA is assigned to G0 or G1
-int hf_check(int lba, struct HotFilter *hotf){
+int hf_check(lba_t lba, struct HotFilter *hotf){
         if (hotf->use_flag == 0) return 1; //if hot filter not available
         else { //if hot filter available
                 hotf->tot_traffic ++; //increase total traffic
-                if (hotf->cur_hf[lba] > hotf->max_val) {
-                        printf("hotfilter value over!!! (LBA: %d, value: %d)\n", lba, hotf->cur_hf[lba]);
-                        abort();
-                } else if (hotf->cur_hf[lba] < 0) {
-                        printf("hotfilter value over!!! (LBA: %d, value: %d)\n", lba, hotf->cur_hf[lba]);
-                        abort();
-                }
-                if (hotf->cur_hf[lba] >= hotf->hot_val) { //if the LBA is hot
+                //2-bit counter: always in [0, max_val]
+                if (hf_get(hotf, lba) >= hotf->hot_val) { //if the LBA is hot
                         hotf->G0_traffic ++; //increase the traffic of G0
                         return 0; //HOT
                 }
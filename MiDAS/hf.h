@@ -3,8 +3,8 @@ namespace midas {
 using namespace std;
 
 typedef struct HotFilter {
-        int *cur_hf; // hot filter
-        int max_val; //maximum value of bits per LBA (if 1bit: 1, 2bit: 3, 3bit: 7)
+        uint64_t *cur_hf; // hot filter, 2-bit saturating counter per lba (32 lbas per word, LBASPACE entries)
+        int max_val; //maximum value of bits per LBA (2bit: 3, hf_get/hf_set hold at most 3)
         int hot_val;
         double tw_ratio;
         int make_flag; //generate flag, 0: don't modifiying, 1: modifiying...
@@ -33,18 +33,29 @@ typedef struct HotFilter {
  	int tmp_err_cnt;
 }HF;
 
+/* packed 2-bit counter access */
+#define HF_WORDS(space) (((space)+31)/32)
+static inline int hf_get(const struct HotFilter *hotf, lba_t lba) {
+        return (int)((hotf->cur_hf[lba >> 5] >> ((lba & 31) << 1)) & 3);
+}
+static inline void hf_set(struct HotFilter *hotf, lba_t lba, int val) {
+        int sh = (int)((lba & 31) << 1);
+        hotf->cur_hf[lba >> 5] = (hotf->cur_hf[lba >> 5] & ~(3ULL << sh)) | ((uint64_t)val << sh);
+}
+
 void hf_reset(int flag, struct HotFilter *hotf);
-void hf_generate(struct SSD *ssd, int lba, int old_seg, class GROUP *group[], struct HotFilter *hotf, int hflag);
-void hf_calculate_valid_lba(int lba, int group_num, char vflag, struct HotFilter *hotf);
+void hf_generate(struct SSD *ssd, lba_t lba, int old_seg, class GROUP *group[], struct HotFilter *hotf, int hflag);
+void hf_calculate_valid_lba(lba_t lba, int group_num, char vflag, struct HotFilter *hotf);
 
 void hf_init(struct SSD* ssd, struct HotFilter **hotf);
+void hf_grow(struct HotFilter *hotf, long long old_space, long long new_space);
 void hf_destroy(struct HotFilter *hotf);
 void hf_metadata_reset(struct HotFilter *hotf);
 
 void hf_convert_generate_to_run(struct HotFilter *hotf);
 void hf_update_model(double traffic, struct HotFilter *hotf);
 
-void hf_calculate_valid_lba(int lba, int group_num, char vflag, struct HotFilter *hotf);
-int hf_check(int lba, struct HotFilter *hotf);
+void hf_calculate_valid_lba(lba_t lba, int group_num, char vflag, struct HotFilter *hotf);
+int hf_check(lba_t lba, struct HotFilter *hotf);
 
 } // namespace midas
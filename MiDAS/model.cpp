@@ -7,6 +7,7 @@
 #include <cmath>
 #include <cassert>
 #include <mutex>
+#include <atomic>
 
 namespace midas {
 
@@ -14,7 +15,7 @@ namespace midas {
 using boost::math::lambert_w0;
 using boost::math::lambert_wm1;
 
-extern uint32_t utilization;
+extern uint64_t utilization;
 extern struct SSD_SPEC *ssd_spec;
 extern char workload_name[64];
 
@@ -23,6 +24,18 @@ extern G_INFO *ginfo;
 extern MODEL_Q *model_q;
 extern struct SSD *ssd;
 std::mutex model_mutex;
+
+/* time window 끝에서 worker thread 로 넘기는 snapshot
+ * - model_count, mm_time 은 복사본, ssd 상태(no_access_lba, last group 크기)와 utilization 도 여기서 고정
+ * - time_stamp 는 공유한다: model_on==false 인 동안 update_count 가 불리지 않고,
+ *   model_initialize 는 write 경로가 결과를 가져가서 thread 를 join 한 뒤에만 불린다
+ * - model_q 도 같은 이유로 worker 가 돌 동안은 worker 전용 (hf_update_model 은 model_on 일 때만) */
+struct model_job {
+	mini_model snap;
+	uint32_t last_group_segs;
+};
+static std::atomic<MODEL_RESULT*> model_pending{nullptr};
+static bool model_worker_live = false; // write 경로에서만 접근
 #define RESIZING 1 
 #define DES 2//desnoyer, DES=2 means Greedy
 #define ADD_TWO 0 //+=2
@@ -117,8 +130,9 @@ void model_create(mini_model *mmodel, int write_size, int type) {
 	printf("- RESIZING: %s \n", RESIZING? "true":"false");
 	printf("- extra load timing: %lluGB */\n\n", mmodel->mm_time->extra_load/1024/1024*4);
 	
-	mmodel->time_stamp = (unsigned long long*)malloc(sizeof(unsigned long long)*ssd_spec->LBANUM/mmodel->lba_sampling_ratio);
-	for (int i=0; i<ssd_spec->LBANUM/mmodel->lba_sampling_ratio; i++){
+	mmodel->ts_num = ssd_spec->LBASPACE/mmodel->lba_sampling_ratio;
+	mmodel->time_stamp = (unsigned long long*)malloc(sizeof(unsigned long long)*mmodel->ts_num);
+	for (long long i=0; i<mmodel->ts_num; i++){
 		mmodel->time_stamp[i]=UINT_MAX;
 	}
 	
@@ -142,7 +156,7 @@ void model_create(mini_model *mmodel, int write_size, int type) {
  */
 void model_initialize(mini_model *mmodel, bool on) {
 	std::lock_guard<std::mutex> lk(model_mutex);
-	for (int i=0;i<ssd_spec->LBANUM/mmodel->lba_sampling_ratio; i++) {
+	for (long long i=0;i<mmodel->ts_num; i++) {
 		mmodel->time_stamp[i] = UINT_MAX;
 	}
 	for (int i=0;i<mmodel->entry_num; i++) {
@@ -221,8 +235,44 @@ int check_time_window(mini_model *mmodel, char mode) {
 	return 1;
 }
 
+/* copy the counters the group configuration search needs (write path, once per time window) */
+static model_job *model_snapshot(mini_model *mmodel) {
+	model_job *job = new model_job;
+	job->snap = *mmodel;
+	job->snap.model_count = (unsigned long long*)malloc(sizeof(unsigned long long)*mmodel->entry_num);
+	memcpy(job->snap.model_count, mmodel->model_count, sizeof(unsigned long long)*mmodel->entry_num);
+	job->snap.mm_time = (mtime*)malloc(sizeof(mtime));
+	memcpy(job->snap.mm_time, mmodel->mm_time, sizeof(mtime));
+	job->snap.utilization = utilization;
+
+	long no_access_lba = 0;
+	for (int i = 0; i < ssd_spec->SEGNUM; i++){
+		if (ssd->gnum_info[i] >= ssd_spec->naive_start && ssd->irtable[i] == 0) {
+			no_access_lba += ssd_spec->PPS;
+		}
+	}
+	no_access_lba -= ssd_spec->PPS*ssd->TOTAL_GNUM[ssd_spec->GROUPNUM-1]*0.05;
+	if (ssd_spec->mida_on == 1) {
+		for (int i = 0; i < 4; i++)
+		no_access_lba -= ssd_spec->PPS*ssd->TOTAL_GNUM[ssd_spec->naive_start+i]*0.05;
+	}
+	job->snap.no_access_lba = no_access_lba;
+	job->last_group_segs = ssd->TOTAL_GNUM[ssd_spec->GROUPNUM-1];
+	return job;
+}
+
+/* called from the write path; returns the finished search result or NULL if the worker is still busy */
+MODEL_RESULT *model_take_result(mini_model *mmodel) {
+	if (!model_worker_live) return NULL;
+	MODEL_RESULT *res = model_pending.exchange(nullptr, std::memory_order_acquire);
+	if (res == NULL) return NULL;
+	pthread_join(mmodel->thread_id, NULL);
+	model_worker_live = false;
+	return res;
+}
+
 /* checking lba's interval */
-int check_interval(mini_model *mmodel, uint32_t lba, char mode) {
+int check_interval(mini_model *mmodel, int64_t lba, char mode) {
 	/* fixing first interval's count
 	 * in this time, we only check one interval unit */
 	if (mode == WRITE) {
@@ -241,7 +291,9 @@ int check_interval(mini_model *mmodel, uint32_t lba, char mode) {
 			 */
 			mmodel->model_on=false;
 			mmodel->modeling_num += 1;
-			int status = pthread_create(&mmodel->thread_id, NULL, making_group_configuration3, (void*)mmodel);
+			model_job *job = model_snapshot(mmodel);
+			model_worker_live = true;
+			int status = pthread_create(&mmodel->thread_id, NULL, making_group_configuration3, (void*)job);
 			if (status != 0) {
 				perror("miniature model can't make thread\n");
 				abort();
@@ -252,12 +304,13 @@ int check_interval(mini_model *mmodel, uint32_t lba, char mode) {
 	/* sampling */
 	if (lba%mmodel->lba_sampling_ratio) return 0;
 	lba = lba/mmodel->lba_sampling_ratio;
+	if (lba >= mmodel->ts_num) return 0; //lba space grew after model creation, not sampled
 	update_count(mmodel,lba, mode);
 	return 1;
 }
 
 /* updating count by lba */
-int update_count(mini_model *mmodel, uint32_t lba, char mode) {
+int update_count(mini_model *mmodel, int64_t lba, char mode) {
 	//TODO
 	//check if run correctly
 	unsigned long long cur_interval=0;
@@ -323,20 +376,31 @@ int update_count(mini_model *mmodel, uint32_t lba, char mode) {
 double valid_thresh=0.1;
 double traffic_thresh=0.15;
 bool real_flag=false;
-/*complete miniature model and make optimal group configuration using markov chain */
+static int group_configuration_search(mini_model *mmodel, uint32_t last_group_segs, MODEL_RESULT *res);
+
+/* worker thread: run the search on the snapshot and publish the result for the write path */
 void *making_group_configuration3(void *arg) {
-	if (arg == nullptr || ginfo == nullptr || model_q == nullptr) {
-		fprintf(stderr, "[model] null pointer detected: arg=%p ginfo=%p model_q=%p\n",
-		        arg, (void*)ginfo, (void*)model_q);
+	if (arg == nullptr || model_q == nullptr) {
+		fprintf(stderr, "[model] null pointer detected: arg=%p model_q=%p\n",
+		        arg, (void*)model_q);
 		fflush(stderr);
-		assert(arg && ginfo && model_q);
+		assert(arg && model_q);
 		return (void*)0;
 	}
-	std::lock_guard<std::mutex> lk(model_mutex);
+	model_job *job = (model_job*)arg;
+	MODEL_RESULT *res = (MODEL_RESULT*)calloc(1, sizeof(MODEL_RESULT));
+	res->action = group_configuration_search(&job->snap, job->last_group_segs, res);
+	free(job->snap.model_count);
+	free(job->snap.mm_time);
+	delete job;
+	model_pending.store(res, std::memory_order_release);
+	return (void*)0;
+}
+
+/*complete miniature model and make optimal group configuration using markov chain */
+static int group_configuration_search(mini_model *mmodel, uint32_t last_group_segs, MODEL_RESULT *res) {
 	/* resizing interval count using time stamp (first group, last group, other groups) */
-	mini_model *mmodel = (mini_model*)arg;
 	mmodel->total_count = 0;
-	mmodel->no_access_lba = 0;
 	int fixed_G0_size=0;
 
 	//calculate traffic, valid ratio, size of group 0 (HOT)
@@ -351,17 +415,6 @@ void *making_group_configuration3(void *arg) {
 	model_q->calc_traffic=0.;
 	model_q->calc_size=0;
 
-	for (int i = 0; i < ssd_spec->SEGNUM; i++){
-		if (ssd->gnum_info[i] >= ssd_spec->naive_start && ssd->irtable[i] == 0) {
-			mmodel->no_access_lba += ssd_spec->PPS;
-		}
-	}
-	mmodel->no_access_lba -= ssd_spec->PPS*ssd->TOTAL_GNUM[ssd_spec->GROUPNUM-1]*0.05;
-	if (ssd_spec->mida_on == 1) {
-		for (int i = 0; i < 4; i++)
-		mmodel->no_access_lba -= ssd_spec->PPS*ssd->TOTAL_GNUM[ssd_spec->naive_start+i]*0.05;
-	}
-
 	int qsize = model_q->g0_traffic_queue.size();
 
 	double t=0.0;
@@ -393,22 +446,16 @@ void *making_group_configuration3(void *arg) {
 	
 	if (model_q->g0_size > 1.0) {
 		if (model_q->g0_valid > 0.18) {
-			model_resizing_timewindow(mmodel, mmodel->time_window*2);
-			model_initialize(mmodel, true);
-			return (void*)0;
+			return MODEL_RESIZE;
 		}
 
 	} else {
 		if (model_q->g0_valid > 0.3) {
-			model_resizing_timewindow(mmodel, mmodel->time_window*2);
-			model_initialize(mmodel, true);
-			return (void*)0;
+			return MODEL_RESIZE;
 		}
 	}
-	if (ssd->TOTAL_GNUM[ssd_spec->GROUPNUM-1]<1) {
-		model_resizing_timewindow(mmodel, mmodel->time_window*2);
-		model_initialize(mmodel, true);
-		return (void*)0;
+	if (last_group_segs<1) {
+		return MODEL_RESIZE;
 	}
 	
 	mmodel->total_count = resizing_model(mmodel);
@@ -460,13 +507,11 @@ void *making_group_configuration3(void *arg) {
 		model_q->calc_unit=0;
 		valid_ratio_list=two_valid_ratio_predictor(mmodel, group_config, 1, mmodel->total_count, g0_desig_size);
 		if (valid_ratio_list==NULL) {
-		       model_initialize(mmodel, true);
-		       return (void*)0;
+		       return MODEL_RESTART;
 		}	       
 		double predicted_WAF = two_WAF_predictor(mmodel, valid_ratio_list, 1);
 		if (predicted_WAF > 100) {
-			model_initialize(mmodel, true);
-			return (void*)0;
+			return MODEL_RESTART;
 		}
 		opt_waf[0] = predicted_WAF;
 		opt_config[0][0]=group_config[0];
@@ -703,17 +748,17 @@ void *making_group_configuration3(void *arg) {
 
 	//set group information
 	if (final_gnum > 2) {
-		ginfo->model_ver = mmodel->model_idx;
-		memcpy(ginfo->gsize, final_config, sizeof(uint32_t)*10);
-		memcpy(ginfo->vr, final_valid_ratio_list, sizeof(double)*10);
-		ginfo->gnum = final_gnum;
-		ginfo->WAF = final_waf;
-		ginfo->g0_traffic = final_traffic;
-		print_config_new(ginfo->gnum, ginfo->gsize, ginfo->WAF, ginfo->vr, ginfo->g0_traffic);
-		ginfo->valid=true;
+		res->model_ver = mmodel->model_idx;
+		memcpy(res->gsize, final_config, sizeof(uint32_t)*10);
+		memcpy(res->vr, final_valid_ratio_list, sizeof(double)*10);
+		res->gnum = final_gnum;
+		res->WAF = final_waf;
+		res->g0_traffic = final_traffic;
+		print_config_new(res->gnum, res->gsize, res->WAF, res->vr, res->g0_traffic);
+		return MODEL_APPLY;
 	} 
 
-	return (void*)0;
+	return MODEL_NONE;
 }
 
 /* print final results by miniature model */
@@ -832,7 +877,7 @@ unsigned long long resizing_model(mini_model *mmodel) {
 
 	/* last interval unit */
 	//mmodel->model_count[mmodel->time_window-1] = utilization/mmodel->lba_sampling_ratio;
-	for (int i=0;i<ssd_spec->LBANUM/mmodel->lba_sampling_ratio; i++) {
+	for (long long i=0;i<mmodel->ts_num; i++) {
 		if ((mmodel->time_stamp[i] != UINT_MAX) && ((mmodel->time_stamp[i]&1) == 1) && (mmodel->time_stamp[i] != UINT_MAX-1)) {
 			mmodel->model_count[mmodel->entry_num-1]++;
 		}
@@ -908,7 +953,7 @@ double None_FIFO_predict(mini_model *mmodel, double op){
 
 double one_group_predictor(mini_model *mmodel, uint32_t *group_config, uint32_t group_num, unsigned long long tot_cnt) {	//input values are same as vlid_ratio_predictor, return valid ratio
 	double last_vr;
-	double last_group_vp = (double)utilization;  //global var
+	double last_group_vp = (double)mmodel->utilization;  //snapshot of global var
 	double last_waf = None_FIFO_predict(mmodel,(double)group_config[group_num-1]*ssd_spec->PPS/(double)last_group_vp);	//None_FIFO_predict()'s input is op 
 	if (DES == 1){	//FIFO
 		last_vr = 1.-1./last_waf;
@@ -1142,7 +1187,7 @@ double *two_valid_ratio_predictor(mini_model *mmodel, uint32_t *group_config, ui
 		mmodel->no_access_lba = 0;
 	}
 
-	new_util = (double)utilization - (double)mmodel->no_access_lba;
+	new_util = (double)mmodel->utilization - (double)mmodel->no_access_lba;
 	double new_group_size = (double)group_config[group_num-1]*ssd_spec->PPS - (double)mmodel->no_access_lba;
 	if (new_util < global_valid_cnt) {
 		return NULL;
@@ -1191,13 +1236,15 @@ END:
 
 /*initialize data structures for first interval search*/
 void initialize_first_interval(mini_model *mmodel) {
-	mmodel->updated_lbas = (uint32_t*)malloc(sizeof(uint32_t)*(mmodel->mm_time->interval_unit_size+1));
-	for (std::size_t i = 0; i < static_cast<std::size_t>(mmodel->mm_time->interval_unit_size+1); i++) mmodel->updated_lbas[i]=UINT_MAX;
+	/* size_t 로 계산해야 +1 이 uint32_t 에서 넘치지 않는다. 0xff 로 채우면 전부 ULLONG_MAX (빈 칸) */
+	const std::size_t n = static_cast<std::size_t>(mmodel->mm_time->interval_unit_size) + 1;
+	mmodel->updated_lbas = (unsigned long long*)malloc(sizeof(unsigned long long)*n);
+	memset(mmodel->updated_lbas, 0xff, sizeof(unsigned long long)*n);
 }
 
 /* fixing first interval's count
  * there is no sampling */
-int check_first_interval(mini_model *mmodel, uint32_t lba, char mode) {
+int check_first_interval(mini_model *mmodel, int64_t lba, char mode) {
 	//initialize
 	if (mmodel->mm_time->request_time == 0) {
 		initialize_first_interval(mmodel);
@@ -1205,8 +1252,8 @@ int check_first_interval(mini_model *mmodel, uint32_t lba, char mode) {
 	//lba search
 	int j=0;
 	int indx=-1;
-	while (mmodel->updated_lbas[j] != UINT_MAX) {
-		if (mmodel->updated_lbas[j] == lba) {
+	while (mmodel->updated_lbas[j] != ULLONG_MAX) {
+		if (mmodel->updated_lbas[j] == (unsigned long long)lba) {
 			indx = j;
 			break;
 		}
@@ -1225,12 +1272,17 @@ int check_first_interval(mini_model *mmodel, uint32_t lba, char mode) {
 
 void remove_first_interval(mini_model *mmodel) {
 	int j=0;
-	while (mmodel->updated_lbas[j] != UINT_MAX) j++;
+	while (mmodel->updated_lbas[j] != ULLONG_MAX) j++;
 	free(mmodel->updated_lbas);
 }
 
 
 void model_destroy(mini_model *mmodel) {
+	if (model_worker_live) {
+		pthread_join(mmodel->thread_id, NULL);
+		model_worker_live = false;
+		free(model_pending.exchange(nullptr));
+	}
 	//free(mmodel->time_stamp);
 	free(mmodel->model_count);
 	free(mmodel);
@@ -47,6 +47,23 @@ typedef struct group_configuration{
 	double g0_traffic;
 }G_INFO;
 
+/* worker 가 group configuration search 를 끝내고 write 경로로 넘기는 결과
+ * action 에 따라 write 경로(checking_ginfo)가 ginfo 적용 / model 재시작을 한다 */
+#define MODEL_NONE 0	// config 없음, model off 유지
+#define MODEL_RESTART 1	// 같은 time window 로 다시 수집
+#define MODEL_RESIZE 2	// time window 2 배로 늘리고 다시 수집
+#define MODEL_APPLY 3	// gsize/vr 을 ginfo 로 적용
+
+typedef struct model_result {
+	int action;
+	int model_ver;
+	int gnum;
+	uint32_t gsize[10];
+	double vr[10];
+	double WAF;
+	double g0_traffic;
+}MODEL_RESULT;
+
 
 struct miniature_model {
 	uint32_t lba_sampling_ratio; //sampling ratio
@@ -64,8 +81,9 @@ struct miniature_model {
 	pthread_t thread_id;
 
 	unsigned long long* time_stamp; //time stamp
+	long long ts_num; //# of time_stamp entries (LBASPACE/lba_sampling_ratio at creation)
 	unsigned long long* model_count; // counting update count per intervals
-	uint32_t* updated_lbas; // for first interval's LBAs
+	unsigned long long* updated_lbas; // for first interval's LBAs
 
 	int one_op;
 	unsigned long long hot_req_count;
@@ -75,6 +93,7 @@ struct miniature_model {
 	int modeling_num=-1;
 
 	long no_access_lba;
+	uint64_t utilization; //valid page count at the end of time window (snapshot for worker)
 	unsigned long long total_count;
 	bool model_on;
 	mtime *mm_time;
@@ -114,11 +133,12 @@ void time_managing(mini_model *mmodel, char mode);
 void model_initialize(mini_model *mmodel, bool on);
 void model_resizing_timewindow(mini_model *mmodel, unsigned long long timewindow);
 int check_time_window(mini_model *mmodel, char mode);
-int check_interval(mini_model *mmodel, uint32_t lba, char mode);
-int check_first_interval(mini_model *mmodel, uint32_t lba, char mode);
+int check_interval(mini_model *mmodel, int64_t lba, char mode);
+int check_first_interval(mini_model *mmodel, int64_t lba, char mode);
 void *making_group_configuration(void *arg);
 void *making_group_configuration2(void *arg);
 void *making_group_configuration3(void *arg);
+MODEL_RESULT *model_take_result(mini_model *mmodel);
 void print_config(int, uint32_t*, double, double*);
 void print_config_new(int, uint32_t*, double, double*, double);
 void print_config_into_log(int, uint32_t*, double, double*);
@@ -135,7 +155,7 @@ double *valid_ratio_predictor(mini_model *mmodel, uint32_t*, uint32_t, unsigned
 void initialize_first_interval(mini_model *mmodel);
 void remove_first_interval(mini_model *mmodel);
 void model_destroy(mini_model *mmodel);
-int update_count(mini_model *mmodel, uint32_t lba, char mode);
+int update_count(mini_model *mmodel, int64_t lba, char mode);
 
 // Desnoyer
 
@@ -10,6 +10,7 @@
 #include <time.h>
 #include <cmath>
 #include <signal.h>
+#include <cassert>
 
 #include "ssd_config.h"
 #include "queue.h"
@@ -52,7 +53,7 @@ int policy_to_int(char *policy){
 	else return 1;
 }
 
-void ssd_init(struct SSD* ssd, class GROUP* group[], int gnum, int vs_policy, int naive_start, int dev_gb, int seg_mb){
+void ssd_init(struct SSD* ssd, class GROUP* group[], int gnum, int vs_policy, int naive_start, int dev_gb, int seg_mb, lba_t lba_space){
 	//Spec initialization
 	ssd_spec = (struct SSD_SPEC*)malloc(sizeof(struct SSD_SPEC));
 	ssd_spec->MAXGNUM = 20; //for group configuration change (not used yet)
@@ -72,17 +73,20 @@ void ssd_init(struct SSD* ssd, class GROUP* group[], int gnum, int vs_policy, in
 	ssd_spec->PPB = 512; // page per block
 	ssd_spec->BPS = seg_mb/2; // block per segment to 128 
 	ssd_spec->PPS = ssd_spec->PPB*ssd_spec->BPS;
+	/* itable 은 victim segment 를 PPS/8 byte memset 으로 지우므로 segment 가 64-bit word 경계에 맞아야 한다 */
+	assert(ssd_spec->PPS > 0 && ssd_spec->PPS % 64 == 0);
 	ssd_spec->FREENUM = 4; //GC trigger point
 	ssd_spec->NAIVE_N = 4; 
 	ssd_spec->BLKSIZE = ssd_spec->PGSIZE*ssd_spec->PPB;
 	ssd_spec->SEGSIZE = (long long)ssd_spec->BLKSIZE*ssd_spec->BPS;
 	ssd_spec->SEGNUM = (int)(ssd_spec->DEVSIZE/ssd_spec->SEGSIZE);
 	ssd_spec->BLKNUM = ssd_spec->SEGNUM*ssd_spec->BPS;
-	ssd_spec->PGNUM = ssd_spec->BLKNUM*ssd_spec->PPB;
-	ssd_spec->LBANUM = (int)(ssd_spec->LOGSIZE/ssd_spec->PGSIZE);
+	ssd_spec->PGNUM = (long long)ssd_spec->BLKNUM*ssd_spec->PPB;
+	ssd_spec->LBANUM = (long long)(ssd_spec->LOGSIZE/ssd_spec->PGSIZE);
+	ssd_spec->LBASPACE = (lba_space > ssd_spec->LBANUM) ? lba_space : ssd_spec->LBANUM;
 	//simulation data structure
-	ssd->itable = (bool*)malloc(sizeof(bool)*(ssd_spec->PGNUM+1));
-	ssd->mtable = (int*)malloc(sizeof(int)*ssd_spec->LBANUM);
+	ssd->itable = (uint64_t*)calloc(ssd_spec->PGNUM/64+1, sizeof(uint64_t));
+	ssd->mtable = (ppa_t*)malloc(sizeof(ppa_t)*ssd_spec->LBASPACE);
 	ssd->oob = (struct OOB*)malloc(sizeof(struct OOB)*ssd_spec->PGNUM);
 
 	//malloc data structure
@@ -119,8 +123,7 @@ void ssd_init(struct SSD* ssd, class GROUP* group[], int gnum, int vs_policy, in
 	printf("here\n");
 
 	//data structure initialization
-	memset(ssd->itable, 0, sizeof(bool)*ssd_spec->PGNUM);
-	memset(ssd->mtable, -1, sizeof(int)*ssd_spec->LBANUM);
+	memset(ssd->mtable, -1, sizeof(ppa_t)*ssd_spec->LBASPACE);
 	memset(ssd->irtable, 0, sizeof(int)*ssd_spec->SEGNUM);
 	memset(ssd->gnum_info, ssd_spec->MAXGNUM-1, sizeof(unsigned char)*ssd_spec->SEGNUM);
 	memset(ssd->fill_info, 0, sizeof(bool)*ssd_spec->SEGNUM);
@@ -140,6 +143,7 @@ void ssd_init(struct SSD* ssd, class GROUP* group[], int gnum, int vs_policy, in
 
 	printf("Device size: %.2f GiB\n", (double)(ssd_spec->DEVSIZE/(1024*1024*1024)));
 	printf("Logical size: %.2f GB\n", (double)(ssd_spec->LOGSIZE/(1000*1000*1000)));
+	printf("LBA space: %lld pages\n", ssd_spec->LBASPACE);
 	printf("# of segments: %d\n", ssd_spec->SEGNUM);
 	printf("Segment size: %.2f MB\n", (double)ssd_spec->SEGSIZE/(1024.*1024));
 	printf("===========================================================\n");
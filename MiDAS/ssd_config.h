@@ -1,14 +1,18 @@
 #include <atomic>
 #include <mutex>
 #include <vector>
+#include <stdint.h>
  
  namespace midas {
 
 using namespace std;
 
+typedef int64_t lba_t; // logical page number (-1: none)
+typedef int64_t ppa_t; // physical page number (-1: unmapped)
+
 struct SSD {
-	bool *itable; // valid: 0, invalid: 1
-	int *mtable; // mapping table (idx: lba, value: physical position)
+	uint64_t *itable; // 1 bit per page, valid: 0, invalid: 1 (itable_get/itable_set)
+	ppa_t *mtable; // mapping table (idx: lba, value: physical position)
 	int *irtable; // invalid page count of each block
 	unsigned char *gnum_info; // group number of each block
 	bool *fill_info; // filled: 0, not filled: 1
@@ -47,11 +51,12 @@ struct SSD_SPEC {
 	int PGSIZE; // page size (4KB)
 	int BLKNUM; // # of blocks in SSD
 	int BLKSIZE; // block size (PPB*PGSIZE)
-	int PGNUM; // BLKNUM*PPB
+	long long PGNUM; // BLKNUM*PPB
 	long long SEGSIZE; // segment size (BPS*BLKSIZE)
 	int SEGNUM; // # of segments in SSD
 	int fifo_mode; // victim selection of last group
-	int LBANUM; // # of LBAs in SSD (LOGSIZE/PGSIZE)
+	long long LBANUM; // # of LBAs in SSD (LOGSIZE/PGSIZE)
+	long long LBASPACE; // mapping table size (max lba + 1), >= LBANUM when lbas are sparse
 	int FREENUM; // # of free segments in SSD
 	int MAXGNUM; // Maximum # of groups for MiDAS
 	int naive_start;
@@ -90,7 +95,7 @@ struct STATS {
 };
 
 struct OOB {
-	int lba; //lba of page
+	lba_t lba; //lba of page
 	int gnum; //group number of page
 };
 
@@ -100,7 +105,15 @@ class GROUP{
 		int size; //group size
 };
 
-void ssd_init(struct SSD* ssd, class GROUP* group[], int gnum, int vs_policy, int naive_start, int dev_gb, int seg_mb);
+/* invalid bitmap helpers (PPS is a multiple of 64, so a segment covers whole words) */
+static inline bool itable_get(const struct SSD *ssd, ppa_t ppa) {
+	return (ssd->itable[ppa >> 6] >> (ppa & 63)) & 1;
+}
+static inline void itable_set(struct SSD *ssd, ppa_t ppa) {
+	ssd->itable[ppa >> 6] |= 1ULL << (ppa & 63);
+}
+
+void ssd_init(struct SSD* ssd, class GROUP* group[], int gnum, int vs_policy, int naive_start, int dev_gb, int seg_mb, lba_t lba_space = 0);
 void group_init(struct SSD* ssd, class GROUP *group[], int gnum, int mida_on, int size[]);
 void stats_init(struct STATS *stats);
 int policy_to_int(char *policy);
@@ -108,6 +121,6 @@ int policy_to_int(char *policy);
 extern std::atomic<unsigned long long> compacted_blocks_global;
 extern std::atomic<unsigned long long> valid_pages_global;
 extern std::mutex model_mutex;
-extern std::vector<int> gc_compacted_lbas;  // LBAs compacted during GC (consumed by MidasCache)
+extern std::vector<lba_t> gc_compacted_lbas;  // LBAs compacted during GC (consumed by MidasCache)
 
 } // namespace midas
@@ -35,13 +35,13 @@ using namespace std;
 #define GB_P (1024*1024/4)
 #define SW_GENERATE 1 // 0: No 1: Yes
 
-uint32_t utilization=0;
+uint64_t utilization=0;
 struct SSD_SPEC *ssd_spec;
 struct SSD *ssd;
 struct STATS *stats;
 std::atomic<unsigned long long> compacted_blocks_global{0};
 std::atomic<unsigned long long> valid_pages_global{0};
-std::vector<int> gc_compacted_lbas;
+std::vector<lba_t> gc_compacted_lbas;
 
 char *workload;
 char *c_workload;
@@ -178,9 +178,9 @@ void update_gc_results(struct SSD* ssd, struct STATS* stats, int local_copy, int
 }
 
 //initialize segment information when the segment is erased
-void initialize_segment(struct SSD *ssd, int victim_idx, int victim_seg, int victim_gnum) {
+void initialize_segment(struct SSD *ssd, ppa_t victim_idx, int victim_seg, int victim_gnum) {
+	memset(&ssd->itable[victim_idx >> 6], 0, ssd_spec->PPS/8); //invalid T/F clear
 	for (int i = 0; i < ssd_spec->PPS; i++) { //erase segment
-		ssd->itable[victim_idx+i] = 0; //invalid T/F clear
 		ssd->oob[victim_idx+i].lba = -1; //oob clear
 		ssd->page_stamp[victim_idx+i] = 0; //page timestamp clear
 	}
@@ -199,10 +199,10 @@ int do_gc(struct SSD *ssd, struct STATS *stats, class GROUP *group[], int gc_gro
 	//whole group is naive MiDA mode (HOT group is naive MiDA too)
 	if (ssd_spec->naive_start == 1) select_group = ssd_spec->naive_start;
 	int victim_seg = victim_selection(ssd, stats,group, select_group); //victim segment selection
-	int victim_idx = victim_seg*ssd_spec->PPS; //victim segment entry point (page)
+	ppa_t victim_idx = (ppa_t)victim_seg*ssd_spec->PPS; //victim segment entry point (page)
 	int target_group; //destination group of valid page (copy target group)
-	int copy_lba; //valid page lba 
-	int new_ppa; //new assigned ppa for valid copy
+	lba_t copy_lba; //valid page lba 
+	ppa_t new_ppa; //new assigned ppa for valid copy
 	int victim_gnum = ssd->gnum_info[victim_seg];
 
 	if (victim_gnum < ssd_spec->GROUPNUM-1) target_group = victim_gnum + 1; //goto next group if victim group is not last group
@@ -242,14 +242,14 @@ int do_gc(struct SSD *ssd, struct STATS *stats, class GROUP *group[], int gc_gro
 					ssd->seg_stamp[now_active]=-1;
 			}
 
-		if(ssd->itable[victim_idx+i] == false && ssd->oob[victim_idx+i].lba != -1){ //if the page in the victim segment is valid,
+		if(itable_get(ssd, victim_idx+i) == false && ssd->oob[victim_idx+i].lba != -1){ //if the page in the victim segment is valid,
 			local_copy += 1;
 			copy_lba = ssd->oob[victim_idx+i].lba; //get lba of valid page
 			gc_compacted_lbas.push_back(copy_lba);
 			if (victim_gnum == 0 || victim_gnum == 1) {
 				hf_generate (ssd, copy_lba, victim_seg, group, hf_gen, 0);
 			}
-			new_ppa = now_active*ssd_spec->PPS + ssd->active[target_group][1]; //assign new ppa for valid page
+			new_ppa = (ppa_t)now_active*ssd_spec->PPS + ssd->active[target_group][1]; //assign new ppa for valid page
 			ssd->mtable[copy_lba] = new_ppa; //update mapping entry for valid page
 			ssd->oob[new_ppa].lba = copy_lba; //record lba in the oob space
 			ssd->page_stamp[new_ppa] = ssd->page_stamp[victim_idx+i]; //preserve original write timestamp
@@ -306,18 +306,18 @@ int GC(struct SSD* ssd, struct STATS *stats, class GROUP *group[]) {
 	return 0;
 }
 
-int write(int lba, struct SSD *ssd, struct STATS *stats, class GROUP *group[], bool sw){
+int write(lba_t lba, struct SSD *ssd, struct STATS *stats, class GROUP *group[], bool sw){
 	int user_group = 0;
 
 	//TODO hf_generate timing
 	//if hf_generate first, then the lba will be assigned to HOT group immediately when the past lba has the short interval
 	
-	int old_ppa = ssd->mtable[lba]; //get the previous ppa of lba
-	int old_seg = old_ppa/ssd_spec->PPS; //get the previous segment of lba
+	ppa_t old_ppa = ssd->mtable[lba]; //get the previous ppa of lba
+	int old_seg = (int)(old_ppa/ssd_spec->PPS); //get the previous segment of lba
 	int old_group = ssd->gnum_info[old_seg];
 	(void)old_group;
 	if(old_ppa != -1){ //if there is old data of lba in SSD:
-		ssd->itable[old_ppa] = 1; //mark as invalid
+		itable_set(ssd, old_ppa); //mark as invalid
 		ssd->irtable[old_seg] ++; //increase invalid count of segment
 		hf_generate(ssd, lba, old_seg, group, hf_gen, 1);
 	} else utilization++;
@@ -361,7 +361,7 @@ int write(int lba, struct SSD *ssd, struct STATS *stats, class GROUP *group[], b
 		}
 
 
-	int new_ppa = ssd->active[user_group][0]*ssd_spec->PPS+ssd->active[user_group][1];
+	ppa_t new_ppa = (ppa_t)ssd->active[user_group][0]*ssd_spec->PPS+ssd->active[user_group][1];
 	
 	if (ssd->mtable[lba] == -1) {
 		stats->vp += 1;
@@ -393,8 +393,8 @@ int write(int lba, struct SSD *ssd, struct STATS *stats, class GROUP *group[], b
 	return 0;
 }
 
-int trim(int lba, struct SSD *ssd, struct STATS *stats){
-	int trim_ppa = ssd->mtable[lba];
+int trim(lba_t lba, struct SSD *ssd, struct STATS *stats){
+	ppa_t trim_ppa = ssd->mtable[lba];
 
 	if (ssd->mtable[lba] == -1) return 0;
 
@@ -402,7 +402,7 @@ int trim(int lba, struct SSD *ssd, struct STATS *stats){
 		utilization--;	
 		stats->vp--;
 		valid_pages_global.store(stats->vp, std::memory_order_relaxed);
-		ssd->itable[trim_ppa] = 1;
+		itable_set(ssd, trim_ppa);
 		ssd->mtable[lba] = -1;
 		ssd->irtable[(int)(trim_ppa/ssd_spec->PPS)] += 1;
 	}
@@ -412,6 +412,19 @@ int trim(int lba, struct SSD *ssd, struct STATS *stats){
 	}
 	return 0;
 }
+//grow the lba-indexed tables (mapping table, hot filter) so that lba fits; capacity doubles
+//the miniature model keeps its original table and only samples lbas inside it
+void ssd_grow_lba_space(struct SSD *ssd, lba_t lba){
+	if (lba < ssd_spec->LBASPACE) return;
+	long long old_space = ssd_spec->LBASPACE;
+	long long new_space = old_space;
+	while (new_space <= lba) new_space *= 2;
+	ssd->mtable = (ppa_t*)realloc(ssd->mtable, sizeof(ppa_t)*new_space);
+	memset(ssd->mtable+old_space, -1, sizeof(ppa_t)*(new_space-old_space));
+	if (hf_gen) hf_grow(hf_gen, old_space, new_space);
+	ssd_spec->LBASPACE = new_space;
+}
+
 char workload_name[64]=""; // move to here for valid ratio graph by soyoung
 
 //display the information of simulation for each 1% progress
@@ -449,13 +462,13 @@ int simul_info(struct SSD *ssd, struct STATS *stats, class GROUP* group[], int t
 void req_processing(char* raw_req, struct REQUEST *req, struct STATS *stats){
 	req->timestamp = stats->checktime + (double)(atof(strtok(raw_req, " \t")));
 	req->type = (int)(atoi(strtok(NULL, " \t")));
-	req->lba = (int)(atoi(strtok(NULL, " \t")));
+	req->lba = (lba_t)(atoll(strtok(NULL, " \t")));
 	req->io_size = (int)(atoi(strtok(NULL, " \t")));
 	req->stream=0;
 	req->sw=false;
 }
 
-void req_processing_sw(struct REQUEST *req, struct STATS *stats, int lba){
+void req_processing_sw(struct REQUEST *req, struct STATS *stats, lba_t lba){
 	req->timestamp = 0.;
 	req->type = 1;
 	req->lba = lba;
@@ -535,7 +548,7 @@ int ssd_simulation_sw(struct SSD* ssd, struct STATS* stats, class GROUP* group[]
 	int type = 0;
 	req = (struct REQUEST*)malloc(sizeof(struct REQUEST));
 	int time_gap = ssd_spec->dev_gb;
-	for (int i = 0; i < ssd_spec->LBANUM; i++){
+	for (lba_t i = 0; i < ssd_spec->LBANUM; i++){
 		if (stats->cur_wp%(time_gap*GB_P)==3) simul_info(ssd, stats, group, time_gap);
 		req_processing_sw(req,stats,i);
 		ret = submit_io(ssd, stats, group, req); //submit io request
@@ -5,7 +5,7 @@ using namespace std;
 struct REQUEST{
     double time;
     int type;
-    int lba;
+    lba_t lba;
     int io_size;
     int stream;
     double timestamp;
@@ -19,13 +19,14 @@ int FIFO_VS(class GROUP *group[], int gc_group);
 int GREEDY_VS(struct SSD *ssd, class GROUP *group[], int gc_group);
 int victim_selection(struct SSD *ssd, struct STATS *stats, class GROUP *group[], int gc_group);
 void update_gc_results(struct SSD* ssd, struct STATS* stats, int local_copy, int victim_gnum, int victim_seg);
-void initialize_segment(struct SSD *ssd, int victim_idx, int victim_seg, int victim_gnum);
+void initialize_segment(struct SSD *ssd, ppa_t victim_idx, int victim_seg, int victim_gnum);
 int do_gc(struct SSD *ssd, struct STATS *stats, class GROUP *group[], int gc_group);
 int gc_victim_group(struct SSD *ssd, class GROUP *group[]);
 int GC(struct SSD* ssd, struct STATS *stats, class GROUP *group[]);
 
-int write(int lba, struct SSD *ssd, struct STATS *stats, class GROUP *group[], bool sw);
-int trim(int lba, struct SSD *ssd, struct STATS *stats);
+int write(lba_t lba, struct SSD *ssd, struct STATS *stats, class GROUP *group[], bool sw);
+int trim(lba_t lba, struct SSD *ssd, struct STATS *stats);
+void ssd_grow_lba_space(struct SSD *ssd, lba_t lba);
 
 
 void req_processing(char* raw_req, struct REQUEST *req, struct STATS *stats);
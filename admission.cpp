@@ -0,0 +1,85 @@
+#include "admission.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+
+std::string g_admission_policy;
+
+bool admission_enabled()
+{
+    return !g_admission_policy.empty() && g_admission_policy != "none";
+}
+
+LifetimeAdmission::LifetimeAdmission()
+    : observed_evict_age_(DBL_MAX)
+{
+    printf("admission: lifetime\n");
+}
+
+bool LifetimeAdmission::admit(uint64_t key, const AdmissionSignals& sig)
+{
+    recs_.reserve_index(key);
+    Rec& r = recs_[key];
+    uint64_t now = sig.now >> TS_SHIFT;
+    double evict_age = sig.evict_age ? static_cast<double>(sig.evict_age)
+                     : observed_evict_age_ != DBL_MAX ? observed_evict_age_ : 0.0;
+    evict_age_ = evict_age;
+
+    if (sig.ghost_hit) ++ghost_hits_;
+    if (r.last) {
+        uint64_t iv = now - (r.last - 1);
+        if (evict_age > 0.0) {
+            bool short_lived = static_cast<double>(iv << TS_SHIFT) < evict_age;
+            if (r.admitted) short_lived ? ++admit_hit_ : ++admit_miss_;
+            else            short_lived ? ++false_bypass_ : ++true_bypass_;
+        }
+        uint64_t pred = r.pred ? (r.pred + iv) / 2 : iv;
+        r.pred = static_cast<uint32_t>(std::min<uint64_t>(std::max<uint64_t>(pred, 1), (1u << 31) - 1));
+    }
+    // 이력이 없거나 eviction age 를 아직 모르면 admit
+    bool long_lived = r.pred && evict_age > 0.0 &&
+                      static_cast<double>(static_cast<uint64_t>(r.pred) << TS_SHIFT) >= evict_age;
+    bool admit = sig.ghost_hit || !long_lived;
+    r.last = static_cast<uint32_t>(now) + 1;
+    r.admitted = admit;
+    if (admit) {
+        ++admitted_;
+    } else {
+        ++bypassed_;
+    }
+    return admit;
+}
+
+void LifetimeAdmission::on_evict(uint64_t key, uint64_t now)
+{
+    if (key >= recs_.size() || recs_[key].last == 0) return;
+    double age = static_cast<double>((now >> TS_SHIFT) - (recs_[key].last - 1)) * (1u << TS_SHIFT);
+    observed_evict_age_ = (observed_evict_age_ == DBL_MAX) ? age : observed_evict_age_ + (age - observed_evict_age_) * EVICT_AGE_ALPHA;
+}
+
+// hit rate = admit 중 eviction 전에 다시 쓰인 비율, false bypass rate = bypass 중 eviction age 안에 다시 쓰인 비율
+// (한 번도 다시 안 쓰인 bypass 는 분모에만 들어간다)
+void LifetimeAdmission::print_stats(FILE* fp) const
+{
+    if (!fp) return;
+    uint64_t resolved_admits = admit_hit_ + admit_miss_;
+    fprintf(fp, "admission admitted: %lu bypassed: %lu evict_age: %.0f admit_hit: %lu admit_miss: %lu "
+                "false_bypass: %lu true_bypass: %lu ghost_hits: %lu hit_rate: %.4f false_bypass_rate: %.4f\n",
+            admitted_, bypassed_, evict_age_ > 0.0 ? evict_age_ : -1.0, admit_hit_, admit_miss_,
+            false_bypass_, true_bypass_, ghost_hits_,
+            resolved_admits ? static_cast<double>(admit_hit_) / resolved_admits : 0.0,
+            bypassed_ ? static_cast<double>(false_bypass_) / bypassed_ : 0.0);
+}
+
+IAdmission* createAdmissionPolicy(const std::string& type)
+{
+    if (type.empty() || type == "none") {
+        return nullptr;
+    }
+    if (type == "lifetime") {
+        return new LifetimeAdmission();
+    }
+    assert(false);
+    return nullptr;
+}
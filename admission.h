@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include "lazy_array.h"
+
+// ===== host write admission =====
+// cache 는 host write block 마다 admit() 을 묻고, false 면 cache 에 넣지 않고 cold tier 로 바로 쓴다
+// (cache 에 있던 copy 는 무효화). block 을 cold tier 로 evict 할 때는 on_evict() 를 불러준다.
+// 판단 근거 (시각, eviction age, ghost hit) 는 cache 가 이미 들고 있는 것을 AdmissionSignals 로 넘긴다.
+struct AdmissionSignals {
+    uint64_t now = 0;           // cache 의 host write timestamp (block 단위, bypass 한 block 은 안 센다)
+    uint64_t evict_age = 0;     // 지금 evict 되는 block 의 age (LogCache: GC age threshold), 0 = cache 가 모름
+    bool     ghost_hit = false; // 최근 evict / bypass 되어 cache 의 ghost 에 있던 block
+};
+
+class IAdmission {
+public:
+    virtual ~IAdmission() = default;
+    virtual bool admit(uint64_t key, const AdmissionSignals& sig) = 0;
+    virtual void on_evict(uint64_t key, uint64_t now) = 0;
+    virtual void print_stats(FILE* fp) const = 0;
+};
+
+// "lifetime": LBA 별 rewrite interval 예측
+//  - 예측 lifetime = rewrite interval 의 EWMA. 이력이 없는 block (처음 쓰임) 은 admit 한다
+//  - 예측이 eviction age 보다 길면 bypass, 단 ghost hit 이면 admit
+//  - eviction age 는 cache 가 주는 값을 쓰고, 안 주는 cache (MiDAS, FairyWren) 는 on_evict 로 본
+//    write→evict 시간의 EWMA 를 쓴다. 둘 다 없으면 (첫 eviction 전) 전부 admit
+//  - 다음 write 때 이전 결정을 채점: interval < eviction age 면 admit 은 hit, bypass 는 false bypass
+class LifetimeAdmission : public IAdmission {
+public:
+    LifetimeAdmission();
+
+    bool admit(uint64_t key, const AdmissionSignals& sig) override;
+    void on_evict(uint64_t key, uint64_t now) override;
+    void print_stats(FILE* fp) const override;
+
+private:
+    // LBA 별 8 B
+    struct Rec {
+        uint32_t last;                // 마지막 write (clock >> TS_SHIFT) + 1, 0 = 아직 없음
+        uint32_t pred     : 31;       // 예측 rewrite interval (2^TS_SHIFT block 단위), 0 = 모름
+        uint32_t admitted : 1;        // 마지막 write 를 cache 에 넣었는지
+    };
+    static constexpr unsigned TS_SHIFT = 4;
+    static constexpr double EVICT_AGE_ALPHA = 1.0 / 1024;
+
+    LazyArray<Rec> recs_;
+    double   observed_evict_age_;     // on_evict 로 본 eviction age EWMA (block), 첫 eviction 전에는 DBL_MAX
+    double   evict_age_ = 0.0;        // 마지막 admit 때 쓴 eviction age (통계용), 0 = 없음
+
+    uint64_t admitted_ = 0;
+    uint64_t bypassed_ = 0;
+    uint64_t ghost_hits_ = 0;
+    uint64_t admit_hit_ = 0;          // admit 했고 eviction age 안에 다시 쓰임
+    uint64_t admit_miss_ = 0;         // admit 했는데 eviction age 를 넘겨서 다시 쓰임
+    uint64_t false_bypass_ = 0;       // bypass 했는데 eviction age 안에 다시 쓰임
+    uint64_t true_bypass_ = 0;        // bypass 했고 eviction age 를 넘겨서 다시 쓰임
+};
+
+// type: "none"/"" = admission 없음 (nullptr), "lifetime"
+IAdmission* createAdmissionPolicy(const std::string& type);
+
+// cache_sim --admission: LogCache / MidasCache / FairyWrenCache 가 생성 때 읽는다
+extern std::string g_admission_policy;
+bool admission_enabled();
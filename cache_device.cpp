@@ -0,0 +1,46 @@
+#include "cache_device.h"
+#include "evict_policy_greedy.h"
+
+#include <cmath>
+
+bool   g_cache_ftl = false;
+double g_cache_ftl_op = 0.07;
+
+// active / GC active block 과 GC trigger 여유분만큼 block 을 더 둬야 OP 0 에서도 GC 가 victim 을 찾는다
+uint64_t CacheDevice::device_bytes(uint64_t cache_bytes, double op_ratio)
+{
+    const uint64_t nand_block = g_nand_geometry.block_size;
+    uint64_t blocks = static_cast<uint64_t>(std::ceil(cache_bytes * (1.0 + op_ratio) / nand_block));
+    return (blocks + GC_TRIGGER_THRESHOLD + 2) * nand_block;
+}
+
+CacheDevice::CacheDevice(uint64_t cache_bytes, uint64_t segment_bytes, int block_size, double op_ratio)
+    : ftl_(device_bytes(cache_bytes, op_ratio), new GreedyEvictPolicy()),
+      segment_bytes_(segment_bytes),
+      block_size_(block_size),
+      capacity_(device_bytes(cache_bytes, op_ratio))
+{
+    printf("cache device: %lu bytes (cache %lu, op %.3f), segment %lu bytes = %.3f NAND blocks\n",
+           capacity_, cache_bytes, op_ratio, segment_bytes_,
+           static_cast<double>(segment_bytes_) / g_nand_geometry.block_size);
+}
+
+void CacheDevice::write(std::size_t seg_id, std::size_t idx)
+{
+    ftl_.Write(seg_id * segment_bytes_ + idx * static_cast<uint64_t>(block_size_), block_size_, 0);
+}
+
+void CacheDevice::trim_segment(std::size_t seg_id)
+{
+    ++trimmed_segments_;
+    ftl_.Trim(seg_id * segment_bytes_, segment_bytes_);
+}
+
+void CacheDevice::print_stats(FILE* fp)
+{
+    if (!fp) return;
+    uint64_t host = ftl_.GetHostWriteBytes();
+    uint64_t nand = ftl_.GetNandWriteBytes();
+    fprintf(fp, "cache_device host_bytes: %lu nand_bytes: %lu waf: %.4f trimmed_segments: %lu capacity: %lu\n",
+            host, nand, host ? static_cast<double>(nand) / host : 0.0, trimmed_segments_, capacity_);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "ftl.h"
+
+// ===== cache device FTL =====
+// log 구조 cache (LogCache / FairyWrenCache) 의 segment 가 erase block 에 딱 맞는다고 가정하지 않고,
+// cache device 의 page-mapping FTL 위에 올려서 device 안의 GC 비용을 본다.
+//  - segment i 의 j 번째 block 은 device 주소 (i * segment_blocks + j) * block_size 로 write
+//  - segment 를 비울 때 (free pool 로 돌아갈 때) 그 segment 구간 전체를 trim
+//  - device 는 stream 을 모르는 일반 SSD 라서 active segment 여러 개의 write 가 한 erase block 에 섞인다
+// segment 크기가 NAND block 크기의 배수가 아니거나 segment 들이 섞여 쓰이면 device GC (nand > host) 가 생긴다.
+// device 용량 = cache 용량 × (1 + op) + GC 예비 block (--cache_ftl_op)
+class CacheDevice {
+public:
+    CacheDevice(uint64_t cache_bytes, uint64_t segment_bytes, int block_size, double op_ratio);
+
+    void write(std::size_t seg_id, std::size_t idx);
+    void trim_segment(std::size_t seg_id);
+    void print_stats(FILE* fp);
+
+private:
+    static uint64_t device_bytes(uint64_t cache_bytes, double op_ratio);
+
+    PageMappingFTL ftl_;
+    uint64_t segment_bytes_;
+    int      block_size_;
+    uint64_t capacity_;
+    uint64_t trimmed_segments_ = 0;
+};
+
+// cache_sim --cache_ftl / --cache_ftl_op: LogCache / FairyWrenCache 가 생성 때 읽는다
+extern bool   g_cache_ftl;
+extern double g_cache_ftl_op;
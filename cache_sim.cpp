@@ -1,12 +1,25 @@
 #include "cache_sim.h"
 #include "trace_parser.h"
 #include "icache.h"
+#include "mini_sim.h"
+#include "oracle_stream.h"
+#include "key_table.h"
+#include "ghost_cache.h"
+#include "valid_mpc.h"
+#include "gc_stream_tuner.h"
+#include "sketch_stream.h"
+#include "log_cache.h"
+#include "admission.h"
+#include "cache_device.h"
+#include "write_buffer.h"
+#include "tiered_cache.h"
 
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <map>
+#include <unordered_map>
 #include <tuple>   // std::tuple
 #include <signal.h>
 #include <execinfo.h>
@@ -41,8 +54,8 @@ void signal_handler(int signum) {
     exit(signum);
 }
 
-// LRU 정책: 주어진 lba 범위의 블록들을 캐시에 추가
-void issue_op_to_cache(ICache& cache, long long lba_offset, int lba_size, OP_TYPE op_type) {
+// LRU 정책: 주어진 lba 범위의 블록들을 캐시에 추가 (write buffer 가 있으면 buffer 로)
+void issue_op_to_cache(ICache& cache, long long lba_offset, int lba_size, OP_TYPE op_type, WriteBuffer* wb = nullptr, int volume = 0) {
     int block_size = cache.get_block_size();
     long start_block = static_cast<long>(lba_offset / block_size);
     long end_block = static_cast<long>((lba_offset + lba_size) / block_size);
@@ -59,7 +72,13 @@ void issue_op_to_cache(ICache& cache, long long lba_offset, int lba_size, OP_TYP
         }
         newBlocks[block] = right_offset - left_offset;
     }
+    if (wb) {
+        wb->submit(lba_offset, lba_size, newBlocks, op_type, volume);
+        return;
+    }
+    cache.set_request(lba_offset, lba_size, volume);
     cache.batch_insert(0, newBlocks, op_type);
+    cache.set_request(-1, 0);
 }
 
 // Read/Write hit ratio 계산 (퍼센트)
@@ -76,7 +95,7 @@ static void trace_prefill(ICache& cache,
                           ITraceParser& parser,
                           uint64_t byte_limit,
                           int block_size, uint64_t cold_capacity) {
-    const uint64_t align_unit = std::max<uint64_t>(block_size, SECTOR_SIZE);
+    const uint64_t align_unit = std::max<uint64_t>(block_size, g_nand_geometry.sector_size);
     const uint64_t aligned_limit = (byte_limit / align_unit) * align_unit;
     uint64_t target_bytes = static_cast<uint64_t>(cold_capacity * PREFILL_RATE);
     target_bytes = (target_bytes / align_unit) * align_unit;
@@ -209,7 +228,7 @@ int main(int argc, char* argv[]) {
     signal(SIGFPE, signal_handler);
     signal(SIGINT, signal_handler);
     if (argc < 3) {
-        std::cerr << "Usage: " << argv[0] << " trace_file cache_size [--block_size N] [--rw_policy all|write-only] [--trace_format csv|blktrace] [--cache_policy LRU/FIFO] [--cache_trace] [--cold_capacity [bytes]] [--waf_log_file [filename]] [--valid_ratio [%]] [--stat_log_file [filename]] [--no_fill]" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " trace_file cache_size [--block_size N] [--rw_policy all|write-only] [--trace_format csv|blktrace] [--cache_policy LRU/FIFO] [--cache_trace] [--cold_capacity [bytes]] [--waf_log_file [filename]] [--valid_ratio [%]] [--stat_log_file [filename]] [--no_fill] [--mini_sim size1,size2,... [--mini_sample_rate R] [--mini_threads N] [--mini_out csv]] [--oracle_annotate sidecar] [--oracle sidecar --cache_policy LOG_ORACLE] [--track_reinsert|--track_compacted|--track_rewrite|--track_inv_snapshot off|dense|sampled] [--track_sample_rate R] [--ghost_fingerprint] [--ghost_shadow r1,r2,...] [--valid_mpc horizon [--valid_mpc_step_gb G]] [--gc_model [--model_threads N]] [--sketch_mb MB [--sketch_accuracy]] [--bypass_blocks N] [--admission none|lifetime] [--write_buffer_mb MB [--write_buffer_policy fifo|lru|clock]] [--cache_policy TIERED --tiers TYPE:SIZE[:SEG_SCALE],...] [--cache_ftl [--cache_ftl_op R]] [--nand_page_size B] [--nand_block_size B] [--sector_size B] [--cold_mapping page|extent] [--evict_batch [--evict_stream]] [--sector_valid]" << std::endl;
         return 1;
     }
     std::string trace_file = argv[1];
@@ -229,6 +248,11 @@ int main(int argc, char* argv[]) {
     bool no_fill = true;
     uint64_t cold_capacity = 0;
     int lba_scale = 1;
+    uint64_t write_buffer_mb = 0;
+    WriteBuffer::Policy write_buffer_policy = WriteBuffer::Policy::FIFO;
+    MiniSimOptions mini_opt;
+    bool mini_sim = false;
+    std::string oracle_annotate_file = "";
 
     // 추가 인자 파싱
     for (int i = 3; i < argc; i++) {
@@ -261,12 +285,139 @@ int main(int argc, char* argv[]) {
             lba_scale = std::stoi(argv[++i]);
         } else if (arg == "--periodic_ratio" && i + 1 < argc) {
             periodic_ratio = std::stod(argv[++i]);
+        } else if (arg == "--mini_sim" && i + 1 < argc) {
+            mini_opt.cache_sizes = parse_mini_sim_sizes(argv[++i]);
+            mini_sim = true;
+        } else if (arg == "--mini_sample_rate" && i + 1 < argc) {
+            mini_opt.sample_rate = std::stod(argv[++i]);
+        } else if (arg == "--mini_threads" && i + 1 < argc) {
+            mini_opt.threads = std::stoi(argv[++i]);
+        } else if (arg == "--mini_out" && i + 1 < argc) {
+            mini_opt.out_file = argv[++i];
+        } else if (arg == "--oracle_annotate" && i + 1 < argc) {
+            oracle_annotate_file = argv[++i];
+        } else if (arg == "--oracle" && i + 1 < argc) {
+            g_oracle_sidecar_file = argv[++i];
+        } else if ((arg == "--track_reinsert" || arg == "--track_compacted" ||
+                    arg == "--track_rewrite" || arg == "--track_inv_snapshot") && i + 1 < argc) {
+            // LogCache per-LBA 통계 table: off | dense (key 당 4 B) | sampled (--track_sample_rate)
+            KeyTable::Mode mode;
+            if (!KeyTable::parse_mode(argv[++i], mode)) {
+                std::cerr << "Unknown tracking mode for " << arg << ": " << argv[i] << std::endl;
+                return 1;
+            }
+            if (arg == "--track_reinsert")       g_side_tables.reinsert = mode;
+            else if (arg == "--track_compacted") g_side_tables.compacted = mode;
+            else if (arg == "--track_rewrite")   g_side_tables.rewrite = mode;
+            else                                 g_side_tables.inv_snapshot = mode;
+        } else if (arg == "--track_sample_rate" && i + 1 < argc) {
+            g_side_tables.sample_rate = std::stod(argv[++i]);
+        } else if (arg == "--ghost_fingerprint") {
+            g_ghost_fingerprint_only = true;   // ghost cache 에 key 대신 32-bit fingerprint 만 저장
+        } else if (arg == "--ghost_shadow" && i + 1 < argc) {
+            // ghost 용량 비율 목록 (예: 0.02,0.05,0.1). ghost 사용 policy 의 valid rate 제어를 다중 용량 방식으로 바꾼다
+            std::stringstream ss(argv[++i]);
+            std::string tok;
+            while (std::getline(ss, tok, ',')) {
+                if (!tok.empty()) g_ghost_shadow_ratios.push_back(std::stod(tok));
+            }
+        } else if (arg == "--valid_mpc" && i + 1 < argc) {
+            g_valid_mpc_horizon = std::stoi(argv[++i]);    // ghost 사용 policy 의 valid rate 를 online DP 로 제어
+        } else if (arg == "--valid_mpc_step_gb" && i + 1 < argc) {
+            g_valid_mpc_step_gb = std::stod(argv[++i]);
+        } else if (arg == "--gc_model") {
+            g_gc_stream_model = true;   // MultiHotCold GC stream 수 / interval 을 midas_model 로 조정
+        } else if (arg == "--model_threads" && i + 1 < argc) {
+            g_model_threads = std::max(1, std::stoi(argv[++i]));   // --gc_model 후보 탐색 병렬도 (MIDAS_CACHE 와 무관)
+        } else if (arg == "--sketch_mb" && i + 1 < argc) {
+            g_sketch_mb = std::max(1, std::stoi(argv[++i]));       // LOG_*_SKETCH 메모리 상한
+        } else if (arg == "--sketch_accuracy") {
+            g_sketch_accuracy = true;   // 정확한 SepBIT 을 옆에서 돌려 분류 일치율 출력
+        } else if (arg == "--bypass_blocks" && i + 1 < argc) {
+            g_bypass_blocks = std::stoull(argv[++i]);   // LogCache 순차 write bypass run 길이 (block)
+        } else if (arg == "--write_buffer_mb" && i + 1 < argc) {
+            write_buffer_mb = std::stoull(argv[++i]);   // cache 앞단 DRAM write buffer 크기
+        } else if (arg == "--write_buffer_policy" && i + 1 < argc) {
+            if (!WriteBuffer::parse_policy(argv[++i], write_buffer_policy)) {
+                std::cerr << "Unknown write buffer policy: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--tiers" && i + 1 < argc) {
+            g_tiers = argv[++i];                        // --cache_policy TIERED 의 tier 목록 (TYPE:SIZE[:SEG_SCALE],...)
+            std::vector<TierSpec> specs;
+            std::string error;
+            if (!TieredCache::parse_tiers(g_tiers, specs, error)) {
+                std::cerr << "Bad --tiers: " << error << std::endl;
+                return 1;
+            }
+        } else if (arg == "--nand_page_size" && i + 1 < argc) {
+            g_nand_geometry.page_size = std::stoull(argv[++i]);     // FTL geometry (bytes), 기본값은 ftl.h macro
+        } else if (arg == "--nand_block_size" && i + 1 < argc) {
+            g_nand_geometry.block_size = std::stoull(argv[++i]);
+        } else if (arg == "--sector_size" && i + 1 < argc) {
+            g_nand_geometry.sector_size = std::stoull(argv[++i]);
+        } else if (arg == "--cold_mapping" && i + 1 < argc) {
+            std::string mapping = argv[++i];            // cold tier ftl L2P: page (hash) | extent (연속 run)
+            if (mapping == "page") {
+                g_cold_ftl_mapping = FtlMapping::PAGE;
+            } else if (mapping == "extent") {
+                g_cold_ftl_mapping = FtlMapping::EXTENT;
+            } else {
+                std::cerr << "Unknown cold mapping: " << mapping << std::endl;
+                return 1;
+            }
+        } else if (arg == "--sector_valid") {
+            g_sector_valid = true;                      // LogCache 가 block 안 sector 단위 valid mask 와 RMW 를 모델링
+        } else if (arg == "--evict_batch") {
+            g_evict_batch = true;                       // victim segment 의 eviction 을 LBA 순 run 으로 합쳐 cold tier 에
+        } else if (arg == "--evict_stream") {
+            g_evict_stream = true;                      // 합친 run 은 cold ftl 의 전용 stream 으로
+        } else if (arg == "--cache_ftl") {
+            g_cache_ftl = true;                         // LogCache / FairyWren segment 를 cache device FTL 위에 올린다
+        } else if (arg == "--cache_ftl_op" && i + 1 < argc) {
+            g_cache_ftl_op = std::stod(argv[++i]);      // cache device over-provisioning 비율
+            if (g_cache_ftl_op < 0.0) {
+                std::cerr << "--cache_ftl_op must be >= 0" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--admission" && i + 1 < argc) {
+            g_admission_policy = argv[++i];             // host write admission (none|lifetime)
+            if (g_admission_policy != "none" && g_admission_policy != "lifetime") {
+                std::cerr << "Unknown admission policy: " << g_admission_policy << std::endl;
+                return 1;
+            }
         }
         else {
             std::cerr << "Unknown argument: " << arg << std::endl;
             return 1;
         }
     }
+    {
+        std::string error;
+        if (!g_nand_geometry.Validate(error)) {
+            std::cerr << "Bad NAND geometry: " << error << std::endl;
+            return 1;
+        }
+    }
+    if (g_sector_valid && (block_size % g_nand_geometry.sector_size != 0 ||
+                           block_size / g_nand_geometry.sector_size > 64)) {
+        std::cerr << "--sector_valid needs block_size to be a multiple of sector_size with at most 64 sectors per block" << std::endl;
+        return 1;
+    }
+    // LOG_ORACLE 의 sidecar 는 trace 의 block write 순서 그대로라서 host write 를 건너뛰거나 (bypass, admission)
+    // 순서를 바꾸는 (write buffer, mini_sim sampling, tier 간 eviction) 기능과는 같이 쓸 수 없다
+    if (cache_policy == "LOG_ORACLE" || (cache_policy == "TIERED" && g_tiers.find("LOG_ORACLE") != std::string::npos)) {
+        const char* conflict = nullptr;
+        if (cache_policy == "TIERED")                                     conflict = "--cache_policy TIERED";
+        else if (g_bypass_blocks > 0)                                     conflict = "--bypass_blocks";
+        else if (admission_enabled()) conflict = "--admission";
+        else if (write_buffer_mb > 0)                                     conflict = "--write_buffer_mb";
+        else if (mini_sim)                                                conflict = "--mini_sim";
+        if (conflict) {
+            std::cerr << "LOG_ORACLE follows the sidecar in trace order and cannot be combined with " << conflict << std::endl;
+            return 1;
+        }
+    }
     // printf parameter
     printf("trace_file = %s\n", trace_file.c_str());
     printf("cache_size = %ld\n", cache_size);
@@ -280,12 +431,78 @@ int main(int argc, char* argv[]) {
     printf("lba_scale = %d\n", lba_scale);
     printf("periodic_ratio = %.2f\n", periodic_ratio);
     printf("prefill = %s\n", no_fill ? "disabled" : "enabled");
+    printf("track reinsert = %s, compacted = %s, rewrite = %s, inv_snapshot = %s, sample_rate = %.4f\n",
+           KeyTable::mode_name(g_side_tables.reinsert), KeyTable::mode_name(g_side_tables.compacted),
+           KeyTable::mode_name(g_side_tables.rewrite), KeyTable::mode_name(g_side_tables.inv_snapshot),
+           g_side_tables.sample_rate);
+    if (g_bypass_blocks > 0) printf("bypass_blocks = %lu\n", g_bypass_blocks);
+    if (write_buffer_mb > 0) printf("write_buffer = %lu MB, %s\n", write_buffer_mb, WriteBuffer::policy_name(write_buffer_policy));
+    printf("nand geometry = page %lu, block %lu, sector %lu (%s)\n", g_nand_geometry.page_size,
+           g_nand_geometry.block_size, g_nand_geometry.sector_size,
+           g_nand_geometry.PowerOfTwo() ? "shift/mask" : "divide");
+    printf("cold_mapping = %s\n", g_cold_ftl_mapping == FtlMapping::EXTENT ? "extent" : "page");
+    if (g_cache_ftl) printf("cache_ftl = enabled, op = %.3f\n", g_cache_ftl_op);
+    if (g_sector_valid) printf("sector_valid = enabled, %lu sectors per block\n", block_size / g_nand_geometry.sector_size);
+    if (g_evict_batch) printf("evict_batch = enabled%s\n", g_evict_stream ? ", dedicated cold stream" : "");
+    if (!g_tiers.empty()) printf("tiers = %s\n", g_tiers.c_str());
+    if (!g_admission_policy.empty()) printf("admission = %s\n", g_admission_policy.c_str());
+    if (g_gc_stream_model) printf("gc_model = enabled, model_threads = %d\n", g_model_threads);
+    else if (g_model_threads > 1) printf("model_threads = %d has no effect without --gc_model (MIDAS_CACHE group search is serial)\n", g_model_threads);
+    if (g_valid_mpc_horizon > 0) {
+        if (g_ghost_shadow_ratios.empty()) g_ghost_shadow_ratios = {0.02, 0.05, 0.1};
+        printf("valid_mpc horizon = %d, step = %.1f GB\n", g_valid_mpc_horizon, g_valid_mpc_step_gb);
+    }
+    if (!g_ghost_shadow_ratios.empty()) {
+        printf("ghost_shadow =");
+        for (double r : g_ghost_shadow_ratios) {
+            if (r <= 0.0 || r >= 1.0) {
+                std::cerr << "--ghost_shadow ratios must be in (0, 1)" << std::endl;
+                return 1;
+            }
+            printf(" %.3f", r);
+        }
+        printf("\n");
+    }
     assert (cold_capacity > 0);
+    if (!oracle_annotate_file.empty()) {
+        // oracle pass 1: block write 별 다음 overwrite 시각을 sidecar 로 기록하고 종료
+        return write_oracle_sidecar(trace_file, trace_format, policy, block_size, lba_scale, oracle_annotate_file);
+    }
+    if (!g_oracle_sidecar_file.empty()) {
+        printf("oracle_sidecar = %s\n", g_oracle_sidecar_file.c_str());
+        std::ifstream sidecar(g_oracle_sidecar_file);
+        if (!sidecar) {
+            // sidecar 가 없으면 pass 1 을 먼저 돌린다
+            int ret = write_oracle_sidecar(trace_file, trace_format, policy, block_size, lba_scale, g_oracle_sidecar_file);
+            if (ret != 0) return ret;
+        }
+    }
+    if (mini_sim) {
+        // 여러 cache size 를 spatial sampling 된 miniature LogCache 로 한 번에 평가
+        mini_opt.trace_file = trace_file;
+        mini_opt.trace_format = trace_format;
+        mini_opt.cache_policy = cache_policy;
+        mini_opt.rw_policy = policy;
+        mini_opt.cold_capacity = cold_capacity;
+        mini_opt.block_size = block_size;
+        mini_opt.lba_scale = lba_scale;
+        mini_opt.valid_ratio = valid_ratio;
+        mini_opt.periodic_ratio = periodic_ratio;
+        mini_opt.write_buffer_mb = write_buffer_mb;
+        mini_opt.write_buffer_policy = WriteBuffer::policy_name(write_buffer_policy);
+        return run_mini_sim(mini_opt);
+    }
     // Factory 함수를 이용해 적절한 TraceParser 생성
     ITraceParser* parser = createTraceParser(trace_format);
     long max_cache_blocks = cache_size / block_size;
     printf("max_cache_blocks = %ld\n", max_cache_blocks);
     std::unique_ptr<ICache> cache(createCache(cache_policy, max_cache_blocks, cold_capacity, block_size, cache_trace, cache_trace_output, cold_trace_output, waf_log_file, valid_ratio, stat_log_file, periodic_ratio));
+    // valid_mpc 는 ghost cache 를 쓰는 LOG_* policy 에서만 돈다: 조용히 무시하지 않는다
+    if (g_valid_mpc_horizon > 0 && !cache->valid_mpc_enabled()) {
+        std::cerr << "--valid_mpc needs a ghost-tracking LOG_* policy (e.g. LOG_GREEDY_COST_BENEFIT_10), "
+                  << cache_policy << " has none" << std::endl;
+        return 1;
+    }
 
     if (!no_fill) {
         std::cout << "[prefill] start: trace=" << trace_file
@@ -295,6 +512,15 @@ int main(int argc, char* argv[]) {
         trace_prefill(*cache, trace_file, *parser, CACHE_WRITE_SIZE_LIMIT, block_size, cold_capacity);
     }
 
+    // 여기부터 host write 는 oracle sidecar 의 trace 순서와 1:1 대응
+    g_oracle_trace_started = true;
+
+    // prefill 은 buffer 를 거치지 않고, 여기부터 host I/O 는 write buffer 를 먼저 지난다
+    std::unique_ptr<WriteBuffer> write_buffer;
+    if (write_buffer_mb > 0) {
+        write_buffer.reset(new WriteBuffer(*cache, (write_buffer_mb << 20) / block_size, write_buffer_policy));
+    }
+
     // 통계 변수 초기화
     long long total_read = 0, total_write = 0;
     long long total_read_size = 0, total_write_size = 0;
@@ -311,11 +537,13 @@ int main(int argc, char* argv[]) {
     std::string line;
     long long line_count = 0;
     const long long line_count_limit = 270000000000000000ULL;
+    std::unordered_map<std::string, int> volume_ids;   // dev_id → volume 번호
     
     while (std::getline(infile, line) && line_count < line_count_limit) {
         line_count++;
         if (line_count % 1000000 == 0) {
             print_stats(true, total_read, total_write, total_read_size, total_write_size, read_hit_size, write_hit_size, cache_write_size, cold_tier_write_size, cold_tier_read_size, max_cache_blocks, cache->size());
+            if (write_buffer) write_buffer->print_stats(stdout);
         }
         cache->print_stats();
         if (static_cast<uint64_t>(cache_write_size) > CACHE_WRITE_SIZE_LIMIT) {
@@ -329,6 +557,7 @@ int main(int argc, char* argv[]) {
         }
         parsed.lba_offset *= lba_scale;
         parsed.lba_size   *= lba_scale;
+        const int volume = volume_ids.emplace(parsed.dev_id, static_cast<int>(volume_ids.size())).first->second;
         long long write_bytes_to_cache;
         long long evicted_blocks;
         if (parsed.op_type == "R" || parsed.op_type == "RS") {
@@ -338,7 +567,7 @@ int main(int argc, char* argv[]) {
                 total_read_size += parsed.lba_size;
             //}
             if (policy == "all" || policy == "read-only") {
-                issue_op_to_cache(*cache, parsed.lba_offset, parsed.lba_size, OP_TYPE::READ);
+                issue_op_to_cache(*cache, parsed.lba_offset, parsed.lba_size, OP_TYPE::READ, write_buffer.get(), volume);
             }
         } else if (parsed.op_type == "W" || parsed.op_type == "WS") {
             std::tie(write_bytes_to_cache, evicted_blocks, write_hit_size) = cache->get_status();
@@ -350,7 +579,7 @@ int main(int argc, char* argv[]) {
                 cold_tier_write_size = block_size * evicted_blocks;
             //}
             if (policy == "all" || policy == "write-only") {
-                issue_op_to_cache(*cache, parsed.lba_offset, parsed.lba_size, OP_TYPE::WRITE);
+                issue_op_to_cache(*cache, parsed.lba_offset, parsed.lba_size, OP_TYPE::WRITE, write_buffer.get(), volume);
             }
             if (policy == "write-only") {
              //   cache->print_cache_trace(parsed.lba_offset, parsed.lba_size, OP_TYPE::WRITE);
@@ -358,11 +587,26 @@ int main(int argc, char* argv[]) {
 
         }
     }
+
+    if (write_buffer) {
+        // buffer 에 남은 block 도 cache 로 내려보낸 뒤의 값으로 최종 통계를 낸다
+        write_buffer->flush();
+        long long write_bytes_to_cache, evicted_blocks;
+        std::tie(write_bytes_to_cache, evicted_blocks, write_hit_size) = cache->get_status();
+        cache_write_size = write_bytes_to_cache;
+        cold_tier_write_size = block_size * evicted_blocks;
+    }
     
     double final_read_hit_ratio, final_write_hit_ratio;
     calc_hit_ratio(read_hit_size, total_read_size, write_hit_size, total_write_size, final_read_hit_ratio, final_write_hit_ratio);
     
     print_stats(false, total_read, total_write, total_read_size, total_write_size, read_hit_size, write_hit_size, cache_write_size, cold_tier_write_size, cold_tier_read_size, max_cache_blocks, cache->size());
     cache->print_stats();
+    if (write_buffer) {
+        write_buffer->print_stats(stdout);
+        write_buffer->print_stats(cache->fp_stats);
+    }
+    printf("cold_ftl mapping: %s entries: %lu\n",
+           cache->ftl.Mapping() == FtlMapping::EXTENT ? "extent" : "page", cache->ftl.MappingEntries());
     return 0;
 }
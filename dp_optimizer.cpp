@@ -5,7 +5,8 @@
 // If multiple dp files map to the same (bin, step), uses the higher dp filename number.
 //
 // Build: g++ -O2 -std=c++17 -o dp_optimizer dp_optimizer.cpp
-// Usage: ./dp_optimizer [--dir DIR] [--tmax N] [--warmup_tb TB] [--step_skip N] [--decision_interval N]
+// Usage: ./dp_optimizer [--dir DIR] [--tmax N] [--warmup_tb TB] [--step_skip N] [--decision_interval N] [--compare STAT_LOG]
+//   --compare: 실제 run(예: cache_sim --valid_mpc)의 stat log 비용을 같은 step 범위에서 DP 최적값과 비교
 
 #include <bits/stdc++.h>
 #include <filesystem>
@@ -84,6 +85,7 @@ int main(int argc, char** argv) {
     double warmup_tb = 0.0;
     int step_skip = 1;
     int decision_interval = 1;
+    string compare_file;
 
     for (int i = 1; i < argc; ++i) {
         string a = argv[i];
@@ -99,9 +101,11 @@ int main(int argc, char** argv) {
             decision_interval = atoi(argv[++i]);
         } else if (a == "--qlc_factor" && i + 1 < argc) {
             QLC_FACTOR = atof(argv[++i]);
+        } else if (a == "--compare" && i + 1 < argc) {
+            compare_file = argv[++i];
         } else {
             cerr << "Unknown or incomplete argument: " << a << "\n";
-            cerr << "Usage: " << argv[0] << " [--dir DIR] [--tmax N] [--warmup_tb TB] [--step_skip N] [--decision_interval N]\n";
+            cerr << "Usage: " << argv[0] << " [--dir DIR] [--tmax N] [--warmup_tb TB] [--step_skip N] [--decision_interval N] [--compare STAT_LOG]\n";
             return 2;
         }
     }
@@ -389,7 +393,41 @@ int main(int argc, char** argv) {
     cout << "Host write:  " << total_host * BLK_TO_TB << "\n";
     cout << "Compaction:  " << total_compaction * BLK_TO_TB << "\n";
     cout << "Eviction:    " << total_eviction * BLK_TO_TB << " (x" << QLC_FACTOR << " = " << total_eviction * QLC_FACTOR * BLK_TO_TB << ")\n";
-    cout << "Total:       " << (total_host + total_compaction + total_eviction * QLC_FACTOR) * BLK_TO_TB << "\n";
+    double dp_total = total_host + total_compaction + total_eviction * QLC_FACTOR;
+    cout << "Total:       " << dp_total * BLK_TO_TB << "\n";
+
+    // ---- Compare: 실제 run 의 같은 T step 비용 ----
+    if (!compare_file.empty()) {
+        ifstream ifs(compare_file);
+        if (!ifs) { cerr << "Error: cannot open " << compare_file << "\n"; return 1; }
+        vector<long long> comp, evict;
+        string line;
+        int line_skip_cnt = 0;
+        while (getline(ifs, line)) {
+            if (line.find("invalidate_blocks:") == string::npos) continue;
+            long long cval=0, eval=0, tcval=0, wval=0, gval=0;
+            if (!parse_line_values(line, cval, eval, tcval, wval, gval)) continue;
+            if (warmup_bytes > 0 && wval < warmup_bytes) continue;
+            if (step_skip > 1 && (line_skip_cnt++ % step_skip) != 0) continue;
+            comp.push_back(cval);
+            evict.push_back(eval);
+        }
+        size_t n = min(T, comp.size());
+        double run_compaction = 0.0, run_eviction = 0.0;
+        for (size_t t = 1; t < n; ++t) {
+            run_compaction += max(0.0, (double)(comp[t] - comp[t-1]));
+            run_eviction += max(0.0, (double)(evict[t] - evict[t-1]));
+        }
+        double run_host = n * HOST_BLOCKS_PER_STEP;
+        double run_total = run_host + run_compaction + run_eviction * QLC_FACTOR;
+        cout << "\n=== Compare: " << compare_file << " (" << n << "/" << T << " steps) ===\n";
+        cout << "Host write:  " << run_host * BLK_TO_TB << "\n";
+        cout << "Compaction:  " << run_compaction * BLK_TO_TB << "\n";
+        cout << "Eviction:    " << run_eviction * BLK_TO_TB << " (x" << QLC_FACTOR << " = " << run_eviction * QLC_FACTOR * BLK_TO_TB << ")\n";
+        cout << "Total:       " << run_total * BLK_TO_TB << "\n";
+        if (n < T) cerr << "Warning: run has fewer steps than DP, totals are not comparable\n";
+        else cout << "vs DP optimum: " << (run_total / dp_total - 1.0) * 100.0 << "%\n";
+    }
 
     return 0;
 }
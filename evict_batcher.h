@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// ===== eviction batcher =====
+// victim segment 하나를 비우는 동안 cold tier 로 갈 write (block 단위 key 구간) 를 모았다가
+// flush 때 LBA 순으로 정렬하고, 이어지거나 겹치는 구간을 합쳐 run 마다 한 번씩 내보낸다.
+// run 은 MAX_RUN_BLOCKS 에서 끊는다 (_evict_one_block 의 lba_size 가 int)
+class EvictBatcher {
+public:
+    static constexpr uint64_t MAX_RUN_BLOCKS = 65536;   // 4 KiB block 기준 256 MiB
+
+    void add(uint64_t key, uint64_t blocks)
+    {
+        ranges_.push_back({key, blocks});
+    }
+
+    bool empty() const { return ranges_.empty(); }
+
+    // emit(start_key, blocks) 를 run 마다 부른다
+    template <class F>
+    void flush(F&& emit)
+    {
+        if (ranges_.empty()) return;
+        std::sort(ranges_.begin(), ranges_.end(),
+                  [](const Range& a, const Range& b) { return a.key < b.key; });
+        uint64_t start = ranges_[0].key;
+        uint64_t end = start + ranges_[0].blocks;
+        for (std::size_t i = 1; i <= ranges_.size(); ++i) {
+            if (i < ranges_.size() && ranges_[i].key <= end && ranges_[i].key + ranges_[i].blocks - start <= MAX_RUN_BLOCKS) {
+                end = std::max(end, ranges_[i].key + ranges_[i].blocks);
+                continue;
+            }
+            emit(start, end - start);
+            ++runs_;
+            if (i < ranges_.size()) {
+                start = ranges_[i].key;
+                end = start + ranges_[i].blocks;
+            }
+        }
+        ranges_added_ += ranges_.size();
+        ++flushes_;
+        ranges_.clear();
+    }
+
+    uint64_t ranges_added() const { return ranges_added_; }
+    uint64_t runs() const { return runs_; }
+    uint64_t flushes() const { return flushes_; }
+
+private:
+    struct Range {
+        uint64_t key;
+        uint64_t blocks;
+    };
+    std::vector<Range> ranges_;
+    uint64_t ranges_added_ = 0;
+    uint64_t runs_ = 0;
+    uint64_t flushes_ = 0;
+};
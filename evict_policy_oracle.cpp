@@ -0,0 +1,51 @@
+#include "evict_policy_oracle.h"
+#include "log_cache_segment.h"
+#include "oracle_stream.h"
+#include <cassert>
+
+std::size_t OracleEvictPolicy::cost(Segment* seg) const
+{
+    auto it = never_cnt_.find(seg);
+    std::size_t never = it == never_cnt_.end() ? 0 : it->second;
+    // 이웃 64K eviction 으로 never block 이 빠져도 never_cnt 는 그대로라 clamp
+    return seg->valid_cnt > never ? seg->valid_cnt - never : 0;
+}
+
+void OracleEvictPolicy::add(Segment* seg)
+{
+    assert(seg);
+    auto it = handle_.find(seg);
+    if (it != handle_.end()) {          // compaction 경로에서 재등록되는 경우
+        heap_.update(it->second, { cost(seg), seg });
+        return;
+    }
+    // never-rewritten 여부는 write 시점에 정해지므로 segment 가 닫힐 때 한 번만 센다
+    std::size_t never = 0;
+    for (auto& blk : static_cast<LogCacheSegment*>(seg)->blocks) {
+        if (blk.valid && oracle_->NextWrite(blk.key) == ORACLE_NEVER) ++never;
+    }
+    never_cnt_[seg] = never;
+    handle_[seg] = heap_.push({ cost(seg), seg });
+}
+
+void OracleEvictPolicy::remove(Segment* seg)
+{
+    auto it = handle_.find(seg);
+    if (it == handle_.end()) return;
+    heap_.erase(it->second);
+    handle_.erase(it);
+    never_cnt_.erase(seg);
+}
+
+void OracleEvictPolicy::update(Segment* seg)
+{
+    auto it = handle_.find(seg);
+    if (it == handle_.end()) return;
+    heap_.update(it->second, { cost(seg), seg });
+}
+
+Segment* OracleEvictPolicy::choose_segment()
+{
+    if (heap_.empty()) return nullptr;
+    return heap_.top().seg;
+}
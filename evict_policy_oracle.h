@@ -0,0 +1,31 @@
+#pragma once
+#include "evict_policy.h"
+#include "evict_policy_greedy.h"
+#include <unordered_map>
+
+class OracleStream;
+
+// Oracle victim 선택: 앞으로 다시 쓰이지 않을 block 은 어차피 cold tier 로 내려가야 하므로
+// 비용 = valid_cnt - (never-rewritten valid block 수), 즉 relocate 해야 할 "살아날" block 수.
+// 이 값이 가장 작은 segment 부터 고른다 (greedy 의 oracle 버전).
+class OracleEvictPolicy : public EvictPolicy {
+public:
+    explicit OracleEvictPolicy(const OracleStream* oracle) : oracle_(oracle) {}
+
+    Segment* choose_segment() override;
+
+    void add   (Segment* seg) override;
+    void remove(Segment* seg) override;
+    void update(Segment* seg) override;
+
+    bool   empty() const override { return heap_.empty(); }
+    size_t segment_count() const override { return heap_.size(); }
+
+private:
+    std::size_t cost(Segment* seg) const;
+
+    const OracleStream* oracle_;
+    Heap heap_;
+    std::unordered_map<Segment*, Heap::handle_type> handle_;
+    std::unordered_map<Segment*, std::size_t> never_cnt_;
+};
@@ -43,7 +43,7 @@ Segment* SelectiveFifoEvictPolicy::choose_segment()
         }
     }
     else {
-        static int status_index = 0;
+        static thread_local int status_index = 0;
         if (status_index % 100 == 0) {
             for (int i = 0; i < 10; ++i) {
                 printf("%d %ld\n", i, queue[i].size());
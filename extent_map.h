@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+
+// ===== LPN → PPN extent mapping =====
+// 연속된 LPN 이 연속된 PPN 에 있으면 (start LPN, 길이, start PPN) 한 entry 로 들고,
+// 일부만 overwrite / trim 되면 앞뒤 조각으로 나눈다. 새로 넣는 extent 는 앞뒤와 이어지면 합친다.
+// memory 와 write 당 비용이 page 수가 아니라 extent 수에 비례한다 (순차 위주 cold tier 용)
+class ExtentMap {
+public:
+    // [lpn, lpn + n) 의 mapping 을 지우고, 지워진 조각마다 on_removed(ppn, len) 를 부른다
+    template <class F>
+    void Remove(uint64_t lpn, uint64_t n, F&& on_removed)
+    {
+        const uint64_t end = lpn + n;
+        auto it = map_.upper_bound(lpn);
+        if (it != map_.begin()) {
+            auto prev = std::prev(it);
+            if (prev->first + prev->second.len > lpn) it = prev;
+        }
+        while (it != map_.end() && it->first < end) {
+            const uint64_t s = it->first;
+            const Extent   e = it->second;
+            const uint64_t cut_s = std::max(s, lpn);
+            const uint64_t cut_e = std::min(s + e.len, end);
+            on_removed(e.ppn + (cut_s - s), cut_e - cut_s);
+            it = map_.erase(it);
+            if (cut_s > s) {
+                map_.emplace_hint(it, s, Extent{cut_s - s, e.ppn});
+            }
+            if (s + e.len > cut_e) {
+                // 오른쪽 조각은 end 에서 시작하므로 loop 는 여기서 끝난다
+                map_.emplace_hint(it, cut_e, Extent{s + e.len - cut_e, e.ppn + (cut_e - s)});
+                break;
+            }
+        }
+    }
+
+    // [lpn, lpn + n) → [ppn, ppn + n), 비어 있는 구간이어야 한다
+    void Insert(uint64_t lpn, uint64_t n, uint64_t ppn)
+    {
+        auto it = map_.emplace(lpn, Extent{n, ppn}).first;
+        auto next = std::next(it);
+        if (next != map_.end() && next->first == lpn + n && next->second.ppn == ppn + n) {
+            it->second.len += next->second.len;
+            map_.erase(next);
+        }
+        if (it != map_.begin()) {
+            auto prev = std::prev(it);
+            if (prev->first + prev->second.len == lpn && prev->second.ppn + prev->second.len == ppn) {
+                prev->second.len += it->second.len;
+                map_.erase(it);
+            }
+        }
+    }
+
+    bool Contains(uint64_t lpn) const
+    {
+        auto it = map_.upper_bound(lpn);
+        if (it == map_.begin()) return false;
+        --it;
+        return it->first + it->second.len > lpn;
+    }
+
+    std::size_t ExtentCount() const { return map_.size(); }
+
+private:
+    struct Extent {
+        uint64_t len;
+        uint64_t ppn;
+    };
+    std::map<uint64_t, Extent> map_;   // start LPN → extent
+};
@@ -20,7 +20,7 @@ void fw_assert(bool cond, const char* msg) {
 }
 }
 
-extern uint64_t interval;
+extern thread_local uint64_t interval;
 
 FairyWrenCache::FairyWrenCache(uint64_t           cold_capacity,
                                uint64_t           cache_block_count,
@@ -60,9 +60,20 @@ FairyWrenCache::FairyWrenCache(uint64_t           cold_capacity,
     regions_[region_index(RegionKind::COLD)].name  = "cold";
 
     initialize_regions(cache_block_count);
+    admission_.reset(createAdmissionPolicy(g_admission_policy));
+    if (g_cache_ftl) {
+        cache_device_.reset(new CacheDevice(total_segments_ * cfg_.segment_bytes, cfg_.segment_bytes,
+                                            cache_block_size_, g_cache_ftl_op));
+    }
 }
 
-FairyWrenCache::~FairyWrenCache() = default;
+FairyWrenCache::~FairyWrenCache() {
+    if (admission_) admission_->print_stats(stdout);
+    if (cache_device_) {
+        cache_device_->print_stats(stdout);
+        cache_device_->print_stats(fp_stats);
+    }
+}
 
 bool FairyWrenCache::exists(long key) {
     return mapping_.find(key) != mapping_.end();
@@ -76,6 +87,15 @@ void FairyWrenCache::batch_insert(int /*stream_id*/,
     }
 
     for (auto [key, lba_sz] : newBlocks) {
+        // eviction age threshold 도 ghost 도 없으니 시각만 넘긴다
+        if (admission_ && !admission_->admit(key, {log_cache_timestamp_, 0, false})) {
+            // cache copy 를 무효화하고 cold tier 로 바로
+            if (exists(key)) {
+                invalidate(key, lba_sz);
+            }
+            _evict_one_block(key * cache_block_size_, lba_sz, OP_TYPE::WRITE);
+            continue;
+        }
         append_host_block(key, lba_sz);
         maybe_run_gc();
     }
@@ -123,6 +143,7 @@ void FairyWrenCache::initialize_regions(uint64_t /*cache_block_count*/) {
     for (std::size_t i = 0; i < total_segments_; ++i) {
         all_segments_.push_back(
             std::make_unique<LogCacheSegment>(segment_size_blocks_, log_cache_timestamp_));
+        all_segments_.back()->id = i;
     }
 
     auto it = all_segments_.begin();
@@ -231,6 +252,7 @@ void FairyWrenCache::release_segment_to_free(RegionKind kind, LogCacheSegment* s
     fw_assert(seg->blocks.size() == segment_size_blocks_,
               "segment size mismatch when releasing to free list");
     fw_assert(seg->valid_cnt == 0, "releasing segment with valid blocks");
+    if (cache_device_) cache_device_->trim_segment(seg->id);
     seg->reset();
     region(kind).free_segments.push_back(seg);
     move_segment_region(seg, kind);
@@ -299,6 +321,7 @@ void FairyWrenCache::append_block(LogCacheSegment* seg, long key, uint64_t times
     fw_assert(seg->write_ptr < seg->blocks.size(), "write pointer exceeds segment bounds");
     seg->blocks[seg->write_ptr] = { key, true, timestamp };
     mapping_[key]               = { seg, seg->write_ptr };
+    if (cache_device_) cache_device_->write(seg->id, seg->write_ptr);
     ++seg->write_ptr;
     ++seg->valid_cnt;
     adjust_region_valid(seg, 1);
@@ -334,6 +357,7 @@ bool FairyWrenCache::migrate_block(LogCacheSegment* src,
     dst_blk.create_timestamp = blk.create_timestamp;
 
     it->second = { dest_seg, dest_seg->write_ptr };
+    if (cache_device_) cache_device_->write(dest_seg->id, dest_seg->write_ptr);
     ++dest_seg->write_ptr;
     ++dest_seg->valid_cnt;
     adjust_region_valid(dest_kind, 1);
@@ -395,6 +419,9 @@ void FairyWrenCache::drop_segment(LogCacheSegment* seg) {
         }
         mapping_.erase(blk.key);
         blk.valid = false;
+        if (admission_) {
+            admission_->on_evict(blk.key, log_cache_timestamp_);
+        }
         if (evicted_ages_histogram_) {
             evicted_ages_histogram_->inc(log_cache_timestamp_ - blk.create_timestamp);
         }
@@ -583,6 +610,12 @@ void FairyWrenCache::print_stats() {
                  static_cast<unsigned long long>(fwlog_valid),
                  static_cast<unsigned long long>(hot_valid),
                  static_cast<unsigned long long>(cold_valid));
+    if (admission_) {
+        admission_->print_stats(fp_stats);
+    }
+    if (cache_device_) {
+        cache_device_->print_stats(fp_stats);
+    }
     std::fflush(fp_stats);
     next_stats_print_bytes_ += STATS_PRINT_INTERVAL;
 }
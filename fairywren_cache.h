@@ -3,6 +3,8 @@
 #include "icache.h"
 #include "log_cache_segment.h"
 #include "histogram.h"
+#include "admission.h"
+#include "cache_device.h"
 
 #include <array>
 #include <cstdint>
@@ -42,6 +44,8 @@ public:
     int         get_block_size() override { return cache_block_size_; }
     void        evict_one_block() override;
     void        print_stats() override;
+    void        trim(long key, int lba_sz) override { invalidate(key, lba_sz); }
+    uint64_t    gc_write_blocks() override { return migrated_blocks_; }
 
 private:
     enum class RegionKind { FWLOG = 0, HOT = 1, COLD = 2, COUNT };
@@ -115,4 +119,6 @@ private:
     std::unique_ptr<Histogram> evicted_ages_with_segment_histogram_;
     std::unique_ptr<Histogram> migrated_ages_with_segment_histogram_;
     std::unique_ptr<Histogram> migrated_ages_histogram_;
+    std::unique_ptr<IAdmission> admission_;   // --admission, nullptr = 전부 admit
+    std::unique_ptr<CacheDevice> cache_device_; // --cache_ftl, nullptr = segment 가 erase block 에 딱 맞는다고 가정
 };
@@ -1,72 +1,91 @@
 #pragma once
-#include <sys/types.h>
-#include <sys/stat.h>
-#include <sys/mman.h>
-#include <fcntl.h>
-#include <unistd.h>
+#include <algorithm>
 #include <cassert>
-#include <map>
-#include <cstring>
 #include <cstdint>
+#include <cstring>
+#include <vector>
+#include "lazy_array.h"
 
+// SepBIT lifespan 추정용 FIFO: 최근 write 된 block 들의 ring 과 block -> ring 위치 index.
+//  - 위치 index 는 block 주소로 바로 찾는 dense 배열 (32bit, 0 = 없음, 나머지는 위치+1).
+//    lba_space 만큼 lazy 하게 잡고, 더 큰 주소가 오면 늘린다
+//  - ring 은 live 길이에 맞춰 두 배씩 늘린다 (늘릴 때 live 구간을 0 부터 다시 깔고 index 갱신)
 class FIFO
 {
   public:
-    FIFO()
-    {
-        mArray = new uint64_t[kFileSize];
-    }
+    explicit FIFO(uint64_t lba_space = 0) : mPos(lba_space), mArray(kInitRing) {}
 
     void Update(uint64_t blockAddr, double threshold, uint64_t num_valid_blocks)
     {
       double nValidBlocks = num_valid_blocks;
-      //int res = 0;
+
+      if (Length() + 1 == mArray.size()) GrowRing();
 
       mArray[mTail] = blockAddr;
-      mMap[blockAddr] = mTail;
+      mPos.reserve_index(blockAddr);
+      mPos[blockAddr] = static_cast<uint32_t>(mTail) + 1;
       mTail += 1;
-      if (mTail == kFileSize) mTail = 0;
+      if (mTail == mArray.size()) mTail = 0;
 
-      if ((mTail + kFileSize - mHead) % kFileSize > std::min(threshold, nValidBlocks))
+      if (Length() > std::min(threshold, nValidBlocks))
       {
-        uint64_t oldBlockAddr = mArray[mHead];
-        if (mMap[oldBlockAddr] == mHead)
+        PopHead();
+        if (Length() > threshold)
         {
-          mMap.erase(oldBlockAddr);
-        }
-        mHead += 1;
-        if (mHead == kFileSize) mHead = 0;
-
-        if ((mTail + kFileSize - mHead) % kFileSize > threshold)
-        {
-          oldBlockAddr = mArray[mHead];
-
-          if (mMap[oldBlockAddr] == mHead)
-          {
-            mMap.erase(oldBlockAddr);
-          }
-          mHead += 1;
-          if (mHead == kFileSize) mHead = 0;
+          PopHead();
         }
       }
     }
 
-    uint64_t Query(uint64_t blockAddr)
+    uint64_t Query(uint64_t blockAddr) const
     {
-      auto it = mMap.find(blockAddr);
-      if (it == mMap.end())
+      if (blockAddr >= mPos.size() || mPos[blockAddr] == 0)
       {
         return UINT32_MAX;
       }
-      uint64_t position = it->second;
+      uint64_t position = mPos[blockAddr] - 1;
       uint64_t lifespan = (mTail < position) ?
-        mTail + kFileSize - position : mTail - position;
+        mTail + mArray.size() - position : mTail - position;
       return lifespan;
     }
 
+  private:
+    uint64_t Length() const { return (mTail + mArray.size() - mHead) % mArray.size(); }
+
+    void PopHead()
+    {
+      uint64_t oldBlockAddr = mArray[mHead];
+      if (mPos[oldBlockAddr] == static_cast<uint32_t>(mHead) + 1)
+      {
+        mPos[oldBlockAddr] = 0;
+      }
+      mHead += 1;
+      if (mHead == mArray.size()) mHead = 0;
+    }
+
+    void GrowRing()
+    {
+      uint64_t len = Length();
+      uint64_t oldSize = mArray.size();
+      assert(oldSize * 2 < UINT32_MAX);
+      std::vector<uint64_t> live(len);
+      for (uint64_t i = 0; i < len; i++) live[i] = mArray[(mHead + i) % oldSize];
+      mArray.grow(oldSize * 2);
+      for (uint64_t i = 0; i < len; i++)
+      {
+        uint64_t addr = live[i];
+        uint32_t old = static_cast<uint32_t>((mHead + i) % oldSize) + 1;
+        mArray[i] = addr;
+        if (mPos[addr] == old) mPos[addr] = static_cast<uint32_t>(i) + 1;
+      }
+      mHead = 0;
+      mTail = len;
+    }
+
+    static constexpr uint64_t kInitRing = 1024 * 1024;
+
     uint64_t mTail = 0;
     uint64_t mHead = 0;
-    std::map<uint64_t, uint64_t> mMap;
-    uint64_t* mArray = NULL;
-    const uint64_t kFileSize = 128 * 1024 * 1024;
+    LazyArray<uint32_t> mPos;
+    LazyArray<uint64_t> mArray;
 };
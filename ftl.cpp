@@ -8,44 +8,116 @@
 #include <string>
 #include <cstring>
 
+NandGeometry g_nand_geometry;
+FtlMapping   g_cold_ftl_mapping = FtlMapping::PAGE;
+
+bool NandGeometry::PowerOfTwo() const {
+    auto pow2 = [](u64 v) { return v != 0 && (v & (v - 1)) == 0; };
+    return pow2(sector_size) && pow2(SectorsPerPage()) && pow2(PagesPerBlock());
+}
+
+bool NandGeometry::Validate(std::string& error) const {
+    if (sector_size == 0 || page_size == 0 || block_size == 0) {
+        error = "geometry sizes must be > 0";
+        return false;
+    }
+    if (page_size % sector_size != 0) {
+        error = "page size must be a multiple of the sector size";
+        return false;
+    }
+    if (block_size % page_size != 0) {
+        error = "block size must be a multiple of the page size";
+        return false;
+    }
+    return true;
+}
+
 // ---------------- Block helpers ----------------
-Block::Block(u64 id_) : Segment(0), id(id_), valid(PAGES_PER_BLOCK,false) {}
+Block::Block(u64 id_, u64 pagesPerBlock) : Segment(0), id(id_), valid(pagesPerBlock,false) {}
 
 void Block::reset() {  
     isFree = true;      
     write_ptr = 0;
     valid_cnt = 0;
+    runs.clear();
 }
 bool Block::full() { 
-    return write_ptr >= PAGES_PER_BLOCK; 
+    return write_ptr >= valid.size(); 
 }
 
-u64 Block::NextPpn() const { return id * PAGES_PER_BLOCK + write_ptr; }
+u64 Block::NextPpn() const { return id * valid.size() + write_ptr; }
+
+void Block::AppendRun(u64 off, u64 len, u64 lpn) {
+    if (!runs.empty()) {
+        LpnRun& last = runs.back();
+        if (last.off + last.len == off && last.lpn + last.len == lpn) {
+            last.len += static_cast<uint32_t>(len);
+            return;
+        }
+    }
+    runs.push_back({static_cast<uint32_t>(off), static_cast<uint32_t>(len), lpn});
+}
+
+// runs 는 off 순 (append 순서) 이라 이분 탐색
+u64 Block::LpnAt(u64 off) const {
+    auto it = std::upper_bound(runs.begin(), runs.end(), off,
+                               [](u64 o, const LpnRun& r) { return o < r.off; });
+    assert(it != runs.begin());
+    --it;
+    assert(off < static_cast<u64>(it->off) + it->len);
+    return it->lpn + (off - it->off);
+}
 
 // ---------------- FTL ctor ---------------------
-PageMappingFTL::PageMappingFTL(u64 totalBytes, EvictPolicy* policy)
-    : blocks_(), gcPolicy_(std::move(policy)) {
-    u64 totalBlocks = totalBytes / NAND_BLOCK_SIZE;
+PageMappingFTL::PageMappingFTL(u64 totalBytes, EvictPolicy* policy, const NandGeometry& geometry,
+                               FtlMapping mapping)
+    : blocks_(), gcPolicy_(std::move(policy)), geo_(geometry),
+      pages_per_block_(geometry.PagesPerBlock()), pow2_(geometry.PowerOfTwo()), mapping_(mapping) {
+    const bool extent = mapping_ == FtlMapping::EXTENT;
+    if (pow2_) {
+        write_fn_      = extent ? &PageMappingFTL::WriteExtentImpl<Pow2Div> : &PageMappingFTL::WriteImpl<Pow2Div>;
+        trim_fn_       = extent ? &PageMappingFTL::TrimExtentImpl<Pow2Div>  : &PageMappingFTL::TrimImpl<Pow2Div>;
+        invalidate_fn_ = &PageMappingFTL::InvalidatePpnImpl<Pow2Div>;
+    } else {
+        write_fn_      = extent ? &PageMappingFTL::WriteExtentImpl<PlainDiv> : &PageMappingFTL::WriteImpl<PlainDiv>;
+        trim_fn_       = extent ? &PageMappingFTL::TrimExtentImpl<PlainDiv>  : &PageMappingFTL::TrimImpl<PlainDiv>;
+        invalidate_fn_ = &PageMappingFTL::InvalidatePpnImpl<PlainDiv>;
+    }
+    u64 totalBlocks = totalBytes / geo_.block_size;
     blocks_.reserve(totalBlocks);
-    for (u64 i=0;i<totalBlocks;++i) blocks_.emplace_back(i);
+    for (u64 i=0;i<totalBlocks;++i) blocks_.emplace_back(i, pages_per_block_);
     for (u64 i=0;i<totalBlocks;++i) freePool_.push_back(i);
-    AllocateNewActiveBlock(0);
+    if (totalBlocks) AllocateNewActiveBlock(0);   // 0 이면 쓰이지 않는 ftl (tier 의 evict_sink 가 대신 받는다)
     nand_write_pages = 0;
     host_write_pages = 0;
-    total_nand_pages = totalBytes / NAND_PAGE_SIZE;
-    printf("total_nand_pages : %llu \n", (unsigned long long)total_nand_pages);
+    total_nand_pages = totalBlocks * pages_per_block_;
+    printf("total_nand_pages : %llu%s\n", (unsigned long long)total_nand_pages, extent ? " (extent mapping)" : " ");
 
-    // ▶▶ 희소 매핑: 필요한 만큼만 저장
-    lpnToPpn_.reserve(total_nand_pages); // 동시에 유효한 LPN 수는 PPN 수를 넘지 않음
-    ppnToLpn_.reserve(total_nand_pages);
+    // ▶▶ 희소 매핑: 필요한 만큼만 저장 (extent mode 는 hash 를 안 쓴다)
+    if (!extent) {
+        lpnToPpn_.reserve(total_nand_pages); // 동시에 유효한 LPN 수는 PPN 수를 넘지 않음
+        ppnToLpn_.reserve(total_nand_pages);
+    }
+}
+
+bool PageMappingFTL::IsMapped(u64 lbaOffset) {
+    const u64 lpn = lbaOffset / geo_.page_size;
+    if (mapping_ == FtlMapping::EXTENT) return extents_.Contains(lpn);
+    return GetPpn(lpn) != NOT_ALLOCATED;
 }
 
 // ---------------- invalidate helper ------------
 void PageMappingFTL::InvalidatePpn(u64 ppn) {
+    (this->*invalidate_fn_)(ppn);
+}
+
+template <class D>
+void PageMappingFTL::InvalidatePpnImpl(u64 ppn) {
     if (ppn == NOT_ALLOCATED) return;
 
-    u64 blkId   = ppn / PAGES_PER_BLOCK;
-    u64 pageIdx = ppn % PAGES_PER_BLOCK;
+    const D perBlock(pages_per_block_);
+    u64 blkId   = perBlock.Div(ppn);
+    u64 pageIdx = perBlock.Mod(ppn);
     Block& blk = blocks_[blkId];
 
     if (blk.valid[pageIdx]) {
@@ -92,14 +164,21 @@ u64 PageMappingFTL::GetNandWritePages() {
 }
 // ---------------- Write (fixed span calc) ------
 void PageMappingFTL::Write(u64 lbaOffset, u64 byteSize, int streamId) {
-    assert(lbaOffset % SECTOR_SIZE == 0 && byteSize % SECTOR_SIZE == 0);
+    (this->*write_fn_)(lbaOffset, byteSize, streamId);
+}
+
+template <class D>
+void PageMappingFTL::WriteImpl(u64 lbaOffset, u64 byteSize, int streamId) {
+    const D sector(geo_.sector_size);
+    const D perPage(geo_.SectorsPerPage());
+    assert(sector.Mod(lbaOffset) == 0 && sector.Mod(byteSize) == 0);
     assert(byteSize > 0);
 
-    const u64 firstSector = lbaOffset / SECTOR_SIZE;
-    const u64 lastSector  = (lbaOffset + byteSize - 1) / SECTOR_SIZE;
+    const u64 firstSector = sector.Div(lbaOffset);
+    const u64 lastSector  = sector.Div(lbaOffset + byteSize - 1);
 
-    const u64 startLpn = firstSector / SECTORS_PER_PAGE;
-    const u64 endLpn   = lastSector  / SECTORS_PER_PAGE;
+    const u64 startLpn = perPage.Div(firstSector);
+    const u64 endLpn   = perPage.Div(lastSector);
     const u64 numPages = endLpn - startLpn + 1;          // inclusive span
 
     host_write_pages += numPages;
@@ -108,7 +187,7 @@ void PageMappingFTL::Write(u64 lbaOffset, u64 byteSize, int streamId) {
     for (u64 i=0;i<numPages;++i) {
         u64 curLpn = startLpn + i;
         auto old = GetPpn(curLpn);
-        InvalidatePpn(old);
+        InvalidatePpnImpl<D>(old);
 
         u64 blkId = GetOrAllocateActiveBlock(streamId);
         if (blkId == NOT_ALLOCATED) return;
@@ -132,25 +211,149 @@ void PageMappingFTL::Write(u64 lbaOffset, u64 byteSize, int streamId) {
 
 // ---------------- Trim (fixed span calc) -------
 void PageMappingFTL::Trim(u64 lbaOffset, u64 byteSize) {
-    if (!(lbaOffset % SECTOR_SIZE == 0 && byteSize % SECTOR_SIZE == 0)){
+    (this->*trim_fn_)(lbaOffset, byteSize);
+}
+
+template <class D>
+void PageMappingFTL::TrimImpl(u64 lbaOffset, u64 byteSize) {
+    const D sector(geo_.sector_size);
+    const D perPage(geo_.SectorsPerPage());
+    if (!(sector.Mod(lbaOffset) == 0 && sector.Mod(byteSize) == 0)){
         printf("%lu %lu\n", lbaOffset, byteSize);
-        assert(lbaOffset % SECTOR_SIZE == 0 && byteSize % SECTOR_SIZE == 0);
+        assert(sector.Mod(lbaOffset) == 0 && sector.Mod(byteSize) == 0);
     }
     if (byteSize == 0) return;
 
-    const u64 firstSector = lbaOffset / SECTOR_SIZE;
-    const u64 lastSector  = (lbaOffset + byteSize - 1) / SECTOR_SIZE;
-    const u64 startLpn = firstSector / SECTORS_PER_PAGE;
-    const u64 endLpn   = lastSector  / SECTORS_PER_PAGE;
+    const u64 firstSector = sector.Div(lbaOffset);
+    const u64 lastSector  = sector.Div(lbaOffset + byteSize - 1);
+    const u64 startLpn = perPage.Div(firstSector);
+    const u64 endLpn   = perPage.Div(lastSector);
 
     for (u64 curLpn = startLpn; curLpn <= endLpn; ++curLpn) {
         u64 old = GetPpn(curLpn);
         if (old == NOT_ALLOCATED) continue;
-        InvalidatePpn(old);
+        InvalidatePpnImpl<D>(old);
         Unmap(curLpn);
     }
 }
 
+// ---------------- extent mode ------------------
+// page mode 와 같은 순서 (옛 mapping 무효화 → active block 에 append) 지만
+// L2P 는 extent 단위, P2L 은 block 의 LpnRun 이라 page 마다 hash 를 건드리지 않는다
+void PageMappingFTL::InvalidateRun(u64 ppn, u64 len) {
+    while (len > 0) {
+        Block& blk = blocks_[ppn / pages_per_block_];
+        u64 idx  = ppn % pages_per_block_;
+        u64 take = std::min(len, pages_per_block_ - idx);
+        for (u64 i = idx; i < idx + take; ++i) {
+            if (blk.valid[i]) {
+                blk.valid[i] = false;
+                --blk.valid_cnt;
+            }
+        }
+        if (blk.full()) {
+            gcPolicy_->update(&blk);
+        }
+        ppn += take;
+        len -= take;
+    }
+}
+
+template <class D>
+void PageMappingFTL::WriteExtentImpl(u64 lbaOffset, u64 byteSize, int streamId) {
+    const D sector(geo_.sector_size);
+    const D perPage(geo_.SectorsPerPage());
+    assert(sector.Mod(lbaOffset) == 0 && sector.Mod(byteSize) == 0);
+    assert(byteSize > 0);
+
+    const u64 startLpn = perPage.Div(sector.Div(lbaOffset));
+    const u64 endLpn   = perPage.Div(sector.Div(lbaOffset + byteSize - 1));
+    const u64 numPages = endLpn - startLpn + 1;
+
+    host_write_pages += numPages;
+    nand_write_pages += numPages;
+
+    extents_.Remove(startLpn, numPages, [this](u64 ppn, u64 len) { InvalidateRun(ppn, len); });
+
+    u64 lpn  = startLpn;
+    u64 left = numPages;
+    while (left > 0) {
+        u64 blkId = GetOrAllocateActiveBlock(streamId);
+        if (blkId == NOT_ALLOCATED) return;
+        Block& ab = blocks_[blkId];
+        u64 take = std::min(left, pages_per_block_ - ab.write_ptr);
+        u64 ppn  = ab.NextPpn();
+        std::fill(ab.valid.begin() + ab.write_ptr, ab.valid.begin() + ab.write_ptr + take, true);
+        ab.AppendRun(ab.write_ptr, take, lpn);
+        ab.valid_cnt += take;
+        ab.write_ptr += take;
+        if (ab.full()) {
+            gcPolicy_->add(&ab);
+        }
+        ab.isFree = false;
+        extents_.Insert(lpn, take, ppn);
+        lpn  += take;
+        left -= take;
+    }
+}
+
+template <class D>
+void PageMappingFTL::TrimExtentImpl(u64 lbaOffset, u64 byteSize) {
+    const D sector(geo_.sector_size);
+    const D perPage(geo_.SectorsPerPage());
+    assert(sector.Mod(lbaOffset) == 0 && sector.Mod(byteSize) == 0);
+    if (byteSize == 0) return;
+
+    const u64 startLpn = perPage.Div(sector.Div(lbaOffset));
+    const u64 endLpn   = perPage.Div(sector.Div(lbaOffset + byteSize - 1));
+    extents_.Remove(startLpn, endLpn - startLpn + 1, [this](u64 ppn, u64 len) { InvalidateRun(ppn, len); });
+}
+
+// victim 의 valid page 를 LPN 과 목적지가 둘 다 이어지는 run 단위로 옮긴다
+bool PageMappingFTL::RunGCExtent() {
+    Block* victim = (Block*)gcPolicy_->choose_segment();
+    if (!victim) {
+        printf("No victim found for GC\n");
+        return false;
+    }
+    if (victim->valid_cnt == pages_per_block_) {
+        printf("GC victim %llu is full (%zu valid); no space can be reclaimed. Need TRIM/OP.\n",
+               (unsigned long long)victim->id, victim->valid_cnt);
+        return false;
+    }
+    Block& src = *victim;
+    u64 idx = 0;
+    while (idx < pages_per_block_) {
+        if (!src.valid[idx]) { ++idx; continue; }
+        Block& dest = blocks_[GetOrAllocateGCActiveBlock(0)];
+        u64 lpn = src.LpnAt(idx);
+        u64 len = 1;
+        u64 room = pages_per_block_ - dest.write_ptr;
+        while (len < room && idx + len < pages_per_block_ && src.valid[idx + len] &&
+               src.LpnAt(idx + len) == lpn + len) {
+            ++len;
+        }
+        u64 newPpn = dest.NextPpn();
+        std::fill(dest.valid.begin() + dest.write_ptr, dest.valid.begin() + dest.write_ptr + len, true);
+        dest.AppendRun(dest.write_ptr, len, lpn);
+        dest.valid_cnt += len;
+        dest.write_ptr += len;
+        if (dest.full()) {
+            gcPolicy_->add(&dest);
+        }
+        nand_write_pages += len;
+        // 옛 위치는 victim 이라 곧 erase, 무효화는 하지 않는다
+        extents_.Remove(lpn, len, [](u64, u64) {});
+        extents_.Insert(lpn, len, newPpn);
+        idx += len;
+    }
+    src.reset();
+    gcPolicy_->remove(&src);
+    std::fill(src.valid.begin(), src.valid.end(), false);
+    freePool_.push_back(src.id);
+    return true;
+}
+
 // ---------------- stats ------------------------
 void PageMappingFTL::PrintStats() const {
     /*std::cout << "=== FTL ===\n"
@@ -190,6 +393,7 @@ u64 PageMappingFTL::AllocateNewActiveBlock(int streamId) {
     b.valid_cnt = 0;
     b.isFree = false;
     std::fill(b.valid.begin(), b.valid.end(), false);
+    b.runs.clear();
     activeBlk_[streamId] = blkId;
     return blkId;
 }
@@ -207,6 +411,7 @@ u64 PageMappingFTL::AllocateNewGCActiveBlock(int streamId) {
     b.valid_cnt = 0;
     b.isFree = false;
     std::fill(b.valid.begin(), b.valid.end(), false);
+    b.runs.clear();
     gcActiveBlk_[streamId] = blkId;
     return blkId;
 }
@@ -214,6 +419,7 @@ u64 PageMappingFTL::AllocateNewGCActiveBlock(int streamId) {
 
 // ---------------- Garbage Collection ----------
 bool PageMappingFTL::RunGC() {
+    if (mapping_ == FtlMapping::EXTENT) return RunGCExtent();
     Block* victim = (Block*)gcPolicy_->choose_segment();
     u64 victimId = victim ? victim->id : NOT_ALLOCATED;
     if (victimId == NOT_ALLOCATED) {
@@ -221,7 +427,7 @@ bool PageMappingFTL::RunGC() {
         printf("No victim found for GC\n");
         return false;
     }
-    if (victim->valid_cnt == PAGES_PER_BLOCK) {
+    if (victim->valid_cnt == pages_per_block_) {
         // No reclaimable space (all valid). Avoid spinning forever.
         printf("GC victim %llu is full (%zu valid); no space can be reclaimed. Need TRIM/OP.\n",
                (unsigned long long)victimId, victim->valid_cnt);
@@ -232,7 +438,7 @@ bool PageMappingFTL::RunGC() {
     // Migrate live pages
     Block& src = blocks_[victimId];
     int valid_page = 0;
-    for (u64 idx = 0; idx < PAGES_PER_BLOCK; ++idx) {
+    for (u64 idx = 0; idx < pages_per_block_; ++idx) {
         if (!src.valid[idx]) continue;
         u64 blkId = GetOrAllocateGCActiveBlock(0);
         if (blocks_[blkId].full()) {
@@ -240,12 +446,12 @@ bool PageMappingFTL::RunGC() {
         }
         Block& dest = blocks_[blkId];
         nand_write_pages++;
-        u64 oldPpn = src.id * PAGES_PER_BLOCK + idx;
+        u64 oldPpn = src.id * pages_per_block_ + idx;
         u64 lpn    = GetLpn(oldPpn);
         assert (lpn != NOT_ALLOCATED);
 
         // copy to dest
-        u64 newPpn = dest.id * PAGES_PER_BLOCK + dest.write_ptr;
+        u64 newPpn = dest.id * pages_per_block_ + dest.write_ptr;
         dest.valid[dest.write_ptr] = true;
         ++dest.valid_cnt;
         ++dest.write_ptr;
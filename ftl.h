@@ -4,6 +4,7 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
 #include <vector>
 #include <unordered_map>
 #include <memory>
@@ -13,6 +14,7 @@
 
 #include "segment.h"
 #include "evict_policy.h"
+#include "extent_map.h"
 
 // ---------------------------------------------------------------------------
 // Tunable geometry parameters (override before including if you wish)
@@ -29,13 +31,32 @@
 
 #define NOT_ALLOCATED 0xFFFFFFFFFFFFFFFFULL
 #define GC_TRIGGER_THRESHOLD (4)
+
+using u64 = uint64_t;
+
 // ---------------------------------------------------------------------------
-// Derived constants (do not touch)
+// Runtime geometry – 위 macro 는 기본값, cache_sim --nand_page_size /
+// --nand_block_size / --sector_size 로 재컴파일 없이 바꾼다 (FTL 생성 전에)
 // ---------------------------------------------------------------------------
-static constexpr uint64_t SECTORS_PER_PAGE = NAND_PAGE_SIZE / SECTOR_SIZE;
-static constexpr uint64_t PAGES_PER_BLOCK  = NAND_BLOCK_SIZE / NAND_PAGE_SIZE;
+struct NandGeometry {
+    u64 page_size   = NAND_PAGE_SIZE;
+    u64 sector_size = SECTOR_SIZE;
+    u64 block_size  = NAND_BLOCK_SIZE;
+
+    u64  SectorsPerPage() const { return page_size / sector_size; }
+    u64  PagesPerBlock()  const { return block_size / page_size; }
+    bool PowerOfTwo()     const;
+    // sector | page | block 로 나누어떨어지지 않으면 false 와 이유
+    bool Validate(std::string& error) const;
+};
 
-using u64 = uint64_t;
+extern NandGeometry g_nand_geometry;
+
+// LPN → PPN mapping: PAGE = page 마다 hash entry, EXTENT = 연속 run 을 한 entry (extent_map.h)
+enum class FtlMapping { PAGE, EXTENT };
+
+// cache_sim --cold_mapping page|extent: ICache 의 cold tier ftl 만 이 값을 쓴다
+extern FtlMapping g_cold_ftl_mapping;
 
 // ---------------------------------------------------------------------------
 // Block metadata
@@ -45,11 +66,21 @@ struct Block : public Segment {
     std::vector<bool> valid;
     bool isFree     = true;
 
-    explicit Block(u64 id_);
+    Block(u64 id_, u64 pagesPerBlock);
 
     void reset() override;
     bool full() override;
-    u64  NextPpn() const;
+    u64  NextPpn() const;   // valid.size() = pages per block
+
+    // EXTENT mode 의 P2L: block 안에 append 된 (page offset, 길이, 첫 LPN) run. erase 때까지 stale run 도 남는다
+    struct LpnRun {
+        uint32_t off;
+        uint32_t len;
+        u64      lpn;
+    };
+    std::vector<LpnRun> runs;
+    void AppendRun(u64 off, u64 len, u64 lpn);
+    u64  LpnAt(u64 off) const;
 };
 
 
@@ -65,15 +96,44 @@ struct HeapNode {
 // ---------------------------------------------------------------------------
 class PageMappingFTL {
 public:
-    explicit PageMappingFTL(u64 totalBytes, EvictPolicy* policy);
+    PageMappingFTL(u64 totalBytes, EvictPolicy* policy, const NandGeometry& geometry = g_nand_geometry,
+                   FtlMapping mapping = FtlMapping::PAGE);
 
     void Write(u64 lbaOffset, u64 byteSize, int streamId);
     void Trim (u64 lbaOffset, u64 byteSize);
     void PrintStats() const;
     u64 GetHostWritePages();
     u64 GetNandWritePages();
+    u64 GetHostWriteBytes() { return host_write_pages * geo_.page_size; }
+    u64 GetNandWriteBytes() { return nand_write_pages * geo_.page_size; }
+    const NandGeometry& Geometry() const { return geo_; }
+    FtlMapping Mapping() const { return mapping_; }
+    u64 MappingEntries() const { return mapping_ == FtlMapping::EXTENT ? extents_.ExtentCount() : lpnToPpn_.size(); }
+    bool IsMapped(u64 lbaOffset);   // lbaOffset 이 든 page 가 valid 한가 (부분 block fill 때 읽을 게 있는지)
 
 private:
+    // 주소 나눗셈: 2의 거듭제곱 geometry 는 shift / mask (Pow2Div), 아니면 / % (PlainDiv).
+    // 생성자에서 한 번 골라 Write / Trim / InvalidatePpn 의 template 구현을 member pointer 로 부른다
+    struct Pow2Div {
+        unsigned shift; u64 mask;
+        explicit Pow2Div(u64 d) : shift(__builtin_ctzll(d)), mask(d - 1) {}
+        u64 Div(u64 x) const { return x >> shift; }
+        u64 Mod(u64 x) const { return x & mask; }
+    };
+    struct PlainDiv {
+        u64 d;
+        explicit PlainDiv(u64 d_) : d(d_) {}
+        u64 Div(u64 x) const { return x / d; }
+        u64 Mod(u64 x) const { return x % d; }
+    };
+    template <class D> void WriteImpl(u64 lbaOffset, u64 byteSize, int streamId);
+    template <class D> void TrimImpl(u64 lbaOffset, u64 byteSize);
+    template <class D> void InvalidatePpnImpl(u64 ppn);
+    template <class D> void WriteExtentImpl(u64 lbaOffset, u64 byteSize, int streamId);
+    template <class D> void TrimExtentImpl(u64 lbaOffset, u64 byteSize);
+    void InvalidateRun(u64 ppn, u64 len);
+    bool RunGCExtent();
+
     // helpers
     u64 GetPpn(u64 lpn);
     u64 GetLpn(u64 ppn);
@@ -100,5 +160,14 @@ private:
     u64 host_write_pages;
     u64 total_nand_pages;
 
+    NandGeometry geo_;
+    u64  pages_per_block_;
+    bool pow2_;
+    FtlMapping mapping_;
+    ExtentMap  extents_;   // EXTENT mode 의 L2P
+    void (PageMappingFTL::*write_fn_)(u64, u64, int);
+    void (PageMappingFTL::*trim_fn_)(u64, u64);
+    void (PageMappingFTL::*invalidate_fn_)(u64);
+
     FILE *wafLogFile = NULL;
 };
@@ -0,0 +1,97 @@
+#include "gc_stream_tuner.h"
+
+#include <algorithm>
+
+bool g_gc_stream_model = false;
+
+namespace {
+constexpr uint32_t kIntervalBuckets = 256;
+// cache 크기 대비 후보 age interval (기본값 set_stream_interval 은 1/3)
+constexpr double kGranularityFractions[] = {1.0 / 8, 1.0 / 6, 1.0 / 4, 1.0 / 3, 1.0 / 2, 2.0 / 3};
+}
+
+GcStreamTuner::GcStreamTuner(uint64_t lba_space_blocks, uint64_t cache_block_count, int max_gc_streams,
+                             uint64_t segment_size_blocks)
+    : max_gc_streams_(std::max(1, max_gc_streams))
+{
+    uint64_t window = std::max<uint64_t>(kIntervalBuckets, cache_block_count * 2);
+    model_ = midas_sim::model_create(window, static_cast<uint32_t>(window / kIntervalBuckets), 0);
+    // window 는 cache 기준이지만 LBA 는 backing device 전체에서 온다
+    model_->lba_space = lba_space_blocks;
+    model_->time_stamp.assign(lba_space_blocks / model_->lba_sampling_ratio + 1, UINT64_MAX);
+
+    for (double f : kGranularityFractions) {
+        uint64_t g = static_cast<uint64_t>(cache_block_count * f);
+        if (segment_size_blocks > 0) g = std::max<uint64_t>(1, (g + segment_size_blocks / 2) / segment_size_blocks) * segment_size_blocks;
+        if (g > 0 && std::find(granularities_.begin(), granularities_.end(), g) == granularities_.end())
+            granularities_.push_back(g);
+    }
+    thread_ = std::thread(&GcStreamTuner::worker, this);
+}
+
+GcStreamTuner::~GcStreamTuner() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+    midas_sim::model_destroy(model_);
+}
+
+void GcStreamTuner::on_host_write(uint64_t key) {
+    midas_sim::model_update_lba(model_, key);
+    if (!midas_sim::model_tick(model_, 1)) return;
+
+    // window 끝: worker 가 놀고 있을 때만 넘긴다
+    std::unique_lock<std::mutex> lk(mu_, std::try_to_lock);
+    if (lk.owns_lock() && !busy_ && !job_ready_) {
+        job_.model_count = model_->model_count;
+        job_.total_count = model_->total_count;
+        job_.interval_unit_size = model_->interval_unit_size;
+        job_.entry_num = model_->entry_num;
+        job_.real_tw = model_->real_tw;
+        job_ready_ = true;
+        lk.unlock();
+        cv_.notify_one();
+    } else {
+        ++dropped_;
+    }
+    midas_sim::model_reset(model_);
+}
+
+bool GcStreamTuner::poll(Layout& out) {
+    if (!result_ready_.load(std::memory_order_acquire)) return false;
+    std::lock_guard<std::mutex> lk(mu_);
+    out = result_;
+    result_ready_.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+void GcStreamTuner::worker() {
+    for (;;) {
+        midas_sim::MiniModel snap;
+        {
+            std::unique_lock<std::mutex> lk(mu_);
+            cv_.wait(lk, [&] { return stop_ || job_ready_; });
+            if (stop_) return;
+            snap.model_count.swap(job_.model_count);
+            snap.total_count = job_.total_count;
+            snap.interval_unit_size = job_.interval_unit_size;
+            snap.entry_num = job_.entry_num;
+            snap.real_tw = job_.real_tw;
+            job_ready_ = false;
+            busy_ = true;
+        }
+        midas_sim::GcLayoutChoice c = midas_sim::choose_gc_layout(&snap, max_gc_streams_, granularities_);
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            busy_ = false;
+            ++fitted_;
+            if (c.gc_groups > 0) {
+                result_ = Layout{c.gc_groups, c.granularity, c.WAF};
+                result_ready_.store(true, std::memory_order_release);
+            }
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "midas_model.h"
+
+// LogCache multi-stream GC (MultiHotCold) 의 GC stream 수 / age interval 을
+// midas_model 의 update-interval 모델 + waf_predict 로 주기적으로 고른다.
+//  - host 경로: on_host_write() 에서 sampling 된 LBA 의 update interval 만 기록 (MiniModel)
+//  - window(기본 cache 2 배 host write) 가 끝나면 histogram snapshot 을 worker thread 로 넘긴다.
+//    worker 가 아직 이전 fitting 중이면 이번 window 는 버린다 (host 경로는 절대 기다리지 않음)
+//  - worker 가 고른 결과는 poll() 로 host thread 에서 꺼내 IStream::SetGcLayout 으로 적용
+class GcStreamTuner {
+public:
+    struct Layout {
+        int      gc_streams = 0;
+        uint64_t granularity = 0;   // host write block 수
+        double   waf = 0.0;
+    };
+
+    GcStreamTuner(uint64_t lba_space_blocks, uint64_t cache_block_count, int max_gc_streams,
+                  uint64_t segment_size_blocks);
+    ~GcStreamTuner();
+
+    void on_host_write(uint64_t key);
+    bool poll(Layout& out);
+
+    uint64_t fitted_windows() const { return fitted_.load(); }
+    uint64_t dropped_windows() const { return dropped_; }
+
+private:
+    void worker();
+
+    midas_sim::MiniModel* model_;
+    int max_gc_streams_;
+    std::vector<uint64_t> granularities_;
+
+    std::thread thread_;
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    bool job_ready_ = false;
+    bool busy_ = false;
+    midas_sim::MiniModel job_;          // histogram 만 담은 snapshot (time_stamp 없음)
+
+    std::atomic<bool> result_ready_{false};
+    Layout result_;
+
+    std::atomic<uint64_t> fitted_{0};
+    uint64_t dropped_ = 0;
+};
+
+// cache_sim --gc_model
+extern bool g_gc_stream_model;
@@ -1,20 +1,199 @@
 #include "ghost_cache.h"
 
-GhostCache::GhostCache(std::size_t capacity)
-    : capacity_(capacity), evict_count_(0) {}
+#include <algorithm>
+#include <cassert>
+
+bool g_ghost_fingerprint_only = false;
+std::vector<double> g_ghost_shadow_ratios;
+
+// splitmix64 finalizer
+static inline uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+GhostCache::GhostCache(std::size_t capacity, bool fingerprint_only)
+    : capacity_(capacity), fingerprint_only_(fingerprint_only), evict_count_(0)
+{
+    if (capacity_ == 0) return;
+    // ring 은 capacity 의 1.25 배: 중간에서 빠진(hit) slot 은 tombstone 으로 두고 가득 차면 compaction
+    ring_size_ = capacity_ + capacity_ / 4 + 1;
+    assert(ring_size_ < EMPTY);
+    if (fingerprint_only_) fps_.assign(ring_size_, DEAD_FP);
+    else                   keys_.assign(ring_size_, DEAD_KEY);
+    // index load factor <= 2/3
+    std::size_t slots = 1;
+    while (slots < capacity_ + capacity_ / 2 + 1) slots <<= 1;   // 항상 빈 칸이 남도록
+    index_.assign(slots, EMPTY);
+    index_mask_ = slots - 1;
+}
 
 void GhostCache::reset() {
-    cache_.clear();
-    lookup_.clear();
+    std::fill(index_.begin(), index_.end(), EMPTY);
+    std::fill(keys_.begin(), keys_.end(), DEAD_KEY);
+    std::fill(fps_.begin(), fps_.end(), DEAD_FP);
+    head_ = tail_ = 0;
+    live_ = 0;
     evict_count_ = 0;
+    for (auto& sh : shadows_) sh = Shadow{sh.cap, 0, 0, 0, 0};
+}
+
+void GhostCache::setShadowCapacities(const std::vector<std::size_t>& caps) {
+    assert(live_ == 0);
+    shadows_.clear();
+    for (std::size_t c : caps) {
+        assert(c < capacity_);
+        shadows_.push_back(Shadow{c, 0, 0, 0, 0});
+    }
+}
+
+std::size_t GhostCache::memoryBytes() const {
+    return keys_.capacity() * sizeof(uint64_t) + fps_.capacity() * sizeof(uint32_t) +
+           index_.capacity() * sizeof(uint32_t);
+}
+
+/* fingerprint 모드에서는 32-bit fingerprint 자체가 index hash */
+uint64_t GhostCache::hash_of(uint64_t block_id) const {
+    uint64_t h = mix64(block_id);
+    if (!fingerprint_only_) return h;
+    uint32_t fp = static_cast<uint32_t>(h >> 32);
+    return fp == DEAD_FP ? 1 : fp;
+}
+
+uint64_t GhostCache::hash_at(uint32_t pos) const {
+    return fingerprint_only_ ? fps_[pos] : mix64(keys_[pos]);
+}
+
+bool GhostCache::match(uint32_t pos, uint64_t block_id, uint64_t h) const {
+    return fingerprint_only_ ? fps_[pos] == static_cast<uint32_t>(h) : keys_[pos] == block_id;
+}
+
+bool GhostCache::dead(uint32_t pos) const {
+    return fingerprint_only_ ? fps_[pos] == DEAD_FP : keys_[pos] == DEAD_KEY;
+}
+
+void GhostCache::kill(uint32_t pos) {
+    if (fingerprint_only_) fps_[pos] = DEAD_FP;
+    else                   keys_[pos] = DEAD_KEY;
+}
+
+std::size_t GhostCache::find_slot(uint64_t block_id, uint64_t h) const {
+    for (std::size_t i = h & index_mask_; index_[i] != EMPTY; i = (i + 1) & index_mask_) {
+        if (match(index_[i], block_id, h)) return i;
+    }
+    return EMPTY;
+}
+
+// linear probing backward-shift 삭제 (tombstone 없이 probe chain 유지)
+void GhostCache::erase_slot(std::size_t slot) {
+    std::size_t i = slot;
+    std::size_t j = slot;
+    for (;;) {
+        j = (j + 1) & index_mask_;
+        if (index_[j] == EMPTY) break;
+        std::size_t home = hash_at(index_[j]) & index_mask_;
+        // home 이 (i, j] 구간에 있으면 그대로, 아니면 i 로 당긴다
+        bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (!stays) {
+            index_[i] = index_[j];
+            i = j;
+        }
+    }
+    index_[i] = EMPTY;
+}
+
+void GhostCache::insert_index(uint64_t h, uint32_t pos) {
+    std::size_t i = h & index_mask_;
+    while (index_[i] != EMPTY) i = (i + 1) & index_mask_;
+    index_[i] = pos;
+}
+
+// FIFO eviction: 가장 오래된 live entry 하나 제거
+void GhostCache::pop_front() {
+    while (head_ < tail_) {
+        uint32_t pos = static_cast<uint32_t>(head_ % ring_size_);
+        ++head_;
+        if (dead(pos)) continue;
+        std::size_t i = hash_at(pos) & index_mask_;
+        while (index_[i] != pos) i = (i + 1) & index_mask_;
+        erase_slot(i);
+        kill(pos);
+        --live_;
+        ++evict_count_;
+        return;
+    }
+}
+
+// tombstone 을 걷어내고 live entry 를 head 부터 다시 채운다 (순서 유지)
+void GhostCache::compact_ring() {
+    uint64_t w = head_;
+    std::vector<uint64_t> markers(shadows_.size());
+    for (std::size_t k = 0; k < shadows_.size(); ++k) markers[k] = std::max(shadows_[k].marker, head_);
+    for (uint64_t r = head_; r < tail_; ++r) {
+        for (std::size_t k = 0; k < shadows_.size(); ++k) {
+            if (markers[k] == r) shadows_[k].marker = w;
+        }
+        uint32_t from = static_cast<uint32_t>(r % ring_size_);
+        if (dead(from)) continue;
+        if (w != r) {
+            uint32_t to = static_cast<uint32_t>(w % ring_size_);
+            std::size_t i = hash_at(from) & index_mask_;
+            while (index_[i] != from) i = (i + 1) & index_mask_;
+            index_[i] = to;
+            if (fingerprint_only_) fps_[to] = fps_[from];
+            else                   keys_[to] = keys_[from];
+            kill(from);
+        }
+        ++w;
+    }
+    for (std::size_t k = 0; k < shadows_.size(); ++k) {
+        if (markers[k] >= tail_) shadows_[k].marker = w;
+    }
+    tail_ = w;
+}
+
+// hit: index/ring 에서 제거하고, 그 entry 를 포함하던 shadow 들의 hit 로 센다
+void GhostCache::remove_at(std::size_t slot) {
+    uint32_t pos = index_[slot];
+    if (!shadows_.empty()) {
+        uint64_t seq = head_ + (pos + ring_size_ - head_ % ring_size_) % ring_size_;
+        for (auto& sh : shadows_) {
+            if (seq >= sh.marker) {
+                --sh.live;
+                ++sh.hits;
+            }
+        }
+    }
+    erase_slot(slot);
+    kill(pos);
+    --live_;
+}
+
+// 새 entry 가 추가된 뒤 shadow 별 FIFO eviction
+void GhostCache::shadow_push() {
+    for (auto& sh : shadows_) {
+        ++sh.live;
+        // [marker, head_) 는 전부 tombstone 이고 slot 이 재사용됐을 수 있으므로 건너뛴다
+        sh.marker = std::max(sh.marker, head_);
+        while (sh.live > sh.cap) {
+            if (!dead(static_cast<uint32_t>(sh.marker % ring_size_))) {
+                --sh.live;
+                ++sh.evicts;
+            }
+            ++sh.marker;
+        }
+    }
 }
 
 bool GhostCache::access(uint64_t block_id) {
-    auto it = lookup_.find(block_id);
-    if (it != lookup_.end()) {
-        // hit → 리스트에서 제거 + 맵에서도 제거
-        cache_.erase(it->second);
-        lookup_.erase(it);
+    if (live_ == 0) return false;
+    uint64_t h = hash_of(block_id);
+    std::size_t slot = find_slot(block_id, h);
+    if (slot != EMPTY) {
+        // hit → ring 에서 tombstone 처리 + index 에서도 제거
+        remove_at(slot);
         return true;
     }
     return false;
@@ -22,25 +201,32 @@ bool GhostCache::access(uint64_t block_id) {
 
 
 bool GhostCache::push(uint64_t block_id) {
-    auto it = lookup_.find(block_id);
-    if (it != lookup_.end()) {
-        // hit → 리스트에서 제거 + 맵에서도 제거
-        cache_.erase(it->second);
-        lookup_.erase(it);
+    if (capacity_ == 0) return false;
+    uint64_t h = hash_of(block_id);
+    std::size_t slot = find_slot(block_id, h);
+    if (slot != EMPTY) {
+        // hit → ring 에서 tombstone 처리 + index 에서도 제거
+        remove_at(slot);
         return true;
     }
 
     // miss
-    if (cache_.size() >= capacity_) {
+    if (live_ >= capacity_) {
         // FIFO eviction (front)
-        uint64_t evicted = cache_.front();
-        cache_.pop_front();
-        lookup_.erase(evicted);
-        evict_count_++;
+        pop_front();
+    }
+    while (head_ < tail_ && dead(static_cast<uint32_t>(head_ % ring_size_))) ++head_;
+    if (tail_ - head_ == ring_size_) {
+        compact_ring();
     }
 
     // 새 block 추가 (back)
-    cache_.push_back(block_id);
-    lookup_[block_id] = std::prev(cache_.end());
+    uint32_t pos = static_cast<uint32_t>(tail_ % ring_size_);
+    ++tail_;
+    if (fingerprint_only_) fps_[pos] = static_cast<uint32_t>(h);
+    else                   keys_[pos] = block_id;
+    insert_index(h, pos);
+    ++live_;
+    if (!shadows_.empty()) shadow_push();
     return false;
 }
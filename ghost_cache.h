@@ -1,13 +1,15 @@
 #pragma once
 
-#include <list>
-#include <unordered_map>
+#include <vector>
 #include <cstddef>
 #include <cstdint>
 
+// FIFO ghost cache: key ring buffer + open-addressing(linear probing) index.
+// index 는 ring 위치(uint32)만 들고 key 비교는 ring 에서 하므로 entry 당 ~12-20 B.
+// fingerprint_only 면 key 대신 32-bit hash 만 저장한다 (드물게 false hit 허용).
 class GhostCache {
 public:
-    explicit GhostCache(std::size_t capacity);
+    explicit GhostCache(std::size_t capacity, bool fingerprint_only = false);
 
     // block 접근
     // return: true if hit, false if miss
@@ -21,13 +23,62 @@ public:
     void reset();
 
     // 현재 cache 크기
-    std::size_t size() const { return cache_.size(); }
+    std::size_t size() const { return live_; }
+
+    // ring + index 가 차지하는 bytes
+    std::size_t memoryBytes() const;
+
+    // shadow ghost: 같은 ring 위에서 capacity 보다 작은 FIFO 들을 동시에 흉내낸다.
+    // shadow 마다 marker(seq) 하나만 두고, marker 이후의 live entry 를 shadow 의 내용으로 본다.
+    // (push 가 항상 miss 인 LogCache 사용 패턴 — write 시 access, evict 시 push — 에서는
+    //  FIFO + hit 제거에 inclusion 이 성립하므로 작은 shadow 는 항상 큰 ghost 의 suffix)
+    void setShadowCapacities(const std::vector<std::size_t>& caps);   // 각 cap < capacity
+    std::size_t shadowCount() const { return shadows_.size(); }
+    std::size_t shadowCapacity(std::size_t i) const { return shadows_[i].cap; }
+    std::size_t shadowEvictCount(std::size_t i) const { return shadows_[i].evicts; }
+    std::size_t shadowHitCount(std::size_t i) const { return shadows_[i].hits; }
 
 private:
-    using ListIt = std::list<uint64_t>::iterator;
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+    static constexpr uint64_t DEAD_KEY = UINT64_MAX;
+    static constexpr uint32_t DEAD_FP = 0;
+
+    uint64_t hash_of(uint64_t block_id) const;
+    uint64_t hash_at(uint32_t pos) const;
+    bool     match(uint32_t pos, uint64_t block_id, uint64_t h) const;
+    bool     dead(uint32_t pos) const;
+    void     kill(uint32_t pos);
+    std::size_t find_slot(uint64_t block_id, uint64_t h) const;   // index slot, 없으면 EMPTY
+    void     erase_slot(std::size_t slot);
+    void     insert_index(uint64_t h, uint32_t pos);
+    void     pop_front();
+    void     compact_ring();
+    void     remove_at(std::size_t slot);
+    void     shadow_push();
 
     std::size_t capacity_;
-    std::list<uint64_t> cache_;  // FIFO: front=oldest, back=newest
-    std::unordered_map<uint64_t, ListIt> lookup_;
+    bool fingerprint_only_;
+    std::vector<uint64_t> keys_;      // ring (exact 모드)
+    std::vector<uint32_t> fps_;       // ring (fingerprint 모드)
+    std::size_t ring_size_ = 0;
+    uint64_t head_ = 0;               // 가장 오래된 slot (monotonic, % ring_size_)
+    uint64_t tail_ = 0;               // 다음에 쓸 slot
+    std::vector<uint32_t> index_;     // ring 위치, EMPTY = 빈 칸
+    std::size_t index_mask_ = 0;
+    std::size_t live_ = 0;
     std::size_t evict_count_;
-};
\ No newline at end of file
+
+    struct Shadow {
+        std::size_t cap;
+        uint64_t    marker;     // 이 seq 보다 앞은 shadow 에서 evict 된 것
+        std::size_t live;
+        std::size_t evicts;
+        std::size_t hits;
+    };
+    std::vector<Shadow> shadows_;
+};
+
+// cache_sim --ghost_fingerprint
+extern bool g_ghost_fingerprint_only;
+// cache_sim --ghost_shadow r1,r2,... (cache 용량 대비 비율). 비어 있으면 단일 ghost 제어
+extern std::vector<double> g_ghost_shadow_ratios;
@@ -11,8 +11,8 @@ HotCold::HotCold() {
 
 int HotCold::Classify(uint64_t blockAddr, bool isGcAppend, uint64_t global_timestamp, uint64_t created_timestamp) {
   // We set global timerstamp as "time stamp diff"
-  static int cold = 0;
-  static int hot = 0;
+  static thread_local int cold = 0;
+  static thread_local int hot = 0;
   if (global_timestamp - created_timestamp <= 16 *1024ULL * 1024ULL / 4 && created_timestamp != UINT64_MAX) {
     //printf("hot %d, cold %d, global_timestamp %lu, created_timestamp %lu\n", hot, cold, global_timestamp, created_timestamp);
     hot++;
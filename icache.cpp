@@ -6,6 +6,7 @@
 #include "log_cache.h"
 #include "midas_cache.h"
 #include "fairywren_cache.h"
+#include "tiered_cache.h"
 #include "evict_policy_fifo.h"
 #include "evict_policy_fifo_zero.h"
 #include "evict_policy_greedy.h"
@@ -15,7 +16,9 @@
 #include "evict_policy_k_cost_benefit.h"
 #include "evict_policy_multiqueue.h"
 #include "evict_policy_midas.h"
+#include "evict_policy_oracle.h"
 #include "istream.h"
+#include "oracle_stream.h"
 #include <cassert>
 #include <string>
 #include <algorithm> 
@@ -31,7 +34,7 @@ double score_hot_and_greedy(Segment *seg) {
 double score_age_evict(Segment *seg) {
     return -seg->create_timestamp;
 }
-double g_segment_blocks = 262144.0 * 6;  // default 1GB/4KB, set by cache init
+thread_local double g_segment_blocks = 262144.0 * 6;  // default 1GB/4KB, set by cache init
 double score_age(Segment *seg) {
     /*if (seg->valid_cnt > g_segment_blocks - 2) {
         return -UINT64_MAX;
@@ -39,8 +42,8 @@ double score_age(Segment *seg) {
     return seg->create_timestamp;
 }
 
-uint64_t g_threshold = 0;
-uint64_t g_timestamp = 0;
+thread_local uint64_t g_threshold = 0;
+thread_local uint64_t g_timestamp = 0;
 
 // Score functions for CbEvictPolicy (same as icache.cpp)
 /*static double score_age_evict(Segment *seg) {
@@ -52,11 +55,11 @@ static double score_greedy_first(Segment *seg) {
 }
 
 // Global variables for score_warm_first (set by LogCache during GC)
-extern uint64_t g_threshold;
-extern uint64_t g_timestamp;
+extern thread_local uint64_t g_threshold;
+extern thread_local uint64_t g_timestamp;
 
-extern uint64_t g_cycle_length;
-extern int g_stream_cycles[IStream::MAX_STREAMS];
+extern thread_local uint64_t g_cycle_length;
+extern thread_local int g_stream_cycles[IStream::MAX_STREAMS];
 
 // Check if segment is from an old cycle for its stream → protect from compaction
 // Uses seg->create_timestamp (= oldest block's timestamp after compaction) instead of seg->cycle
@@ -181,8 +184,8 @@ static double score_sepbit_age(Segment *seg) {
 // }
 
 
-int g_numerator = 30;
-int g_denominator = 90;
+thread_local int g_numerator = 30;
+thread_local int g_denominator = 90;
 
 std::size_t ranking(std::size_t N) {
     
@@ -225,7 +228,9 @@ ICache* createCache(std::string cache_type, long capacity, uint64_t cold_capacit
     if (stat_log_file.empty()) {
         stat_log_file = cache_type + ".stat.log." + start_ts;
     }
-    set_stream_interval(static_cast<uint64_t>(capacity), 262144ULL * 6);
+    set_stream_interval(static_cast<uint64_t>(capacity),
+                        std::max<uint64_t>(1, static_cast<uint64_t>(262144ULL * 6 * g_segment_scale)));
+    set_stream_lba_space(cache_block_size > 0 ? cold_capacity / static_cast<uint64_t>(cache_block_size) : 0);
     if (cache_type == "LRU") {
         return attach_prefix(new LRUCache(cold_capacity, capacity, cache_block_size, _cache_trace, trace_file, cold_trace_file, waf_log_file, stat_log_file), cache_type, start_ts);
     }
@@ -287,6 +292,22 @@ ICache* createCache(std::string cache_type, long capacity, uint64_t cold_capacit
         IStream *input_stream_policy = createIstreamPolicy("sepbit");
         return attach_prefix(new LogCache(cold_capacity, capacity, cache_block_size, _cache_trace, trace_file, cold_trace_file, waf_log_file, std::make_unique<SelectiveFifoEvictPolicy>(), nullptr, input_stream_policy), cache_type, start_ts);
     }
+    else if (cache_type == "LOG_GREEDY_SKETCH") {
+        IStream *input_stream_policy = createIstreamPolicy("sketch");
+        return attach_prefix(new LogCache(cold_capacity, capacity, cache_block_size, _cache_trace, trace_file, cold_trace_file, waf_log_file, std::make_unique<GreedyEvictPolicy>(), nullptr, input_stream_policy), cache_type, start_ts);
+    }
+    else if (cache_type == "LOG_FIFO_LIFETIME") { // 학습 기반 lifetime 분류 (lifetime_stream.h)
+        IStream *input_stream_policy = createIstreamPolicy("lifetime");
+        return attach_prefix(new LogCache(cold_capacity, capacity, cache_block_size, _cache_trace, trace_file, cold_trace_file, waf_log_file, std::make_unique<FifoEvictPolicy>(), nullptr, input_stream_policy), cache_type, start_ts);
+    }
+    else if (cache_type == "LOG_GREEDY_LIFETIME") {
+        IStream *input_stream_policy = createIstreamPolicy("lifetime");
+        return attach_prefix(new LogCache(cold_capacity, capacity, cache_block_size, _cache_trace, trace_file, cold_trace_file, waf_log_file, std::make_unique<GreedyEvictPolicy>(), nullptr, input_stream_policy), cache_type, start_ts);
+    }
+    else if (cache_type == "LOG_COST_BENEFIT_LIFETIME") {
+        IStream *input_stream_policy = createIstreamPolicy("lifetime");
+        return attach_prefix(new LogCache(cold_capacity, capacity, cache_block_size, _cache_trace, trace_file, cold_trace_file, waf_log_file, std::make_unique<CbEvictPolicy>(), nullptr, input_stream_policy), cache_type, start_ts);
+    }
     else if (cache_type == "LOG_FIFO_HOTCOLD") {
         IStream *input_stream_policy = createIstreamPolicy("hotcold");
         return attach_prefix(new LogCache(cold_capacity, capacity, cache_block_size, _cache_trace, trace_file, cold_trace_file, waf_log_file, std::make_unique<FifoEvictPolicy>(), nullptr, input_stream_policy), cache_type, start_ts);
@@ -452,6 +473,16 @@ ICache* createCache(std::string cache_type, long capacity, uint64_t cold_capacit
             cold_trace_file, waf_log_file, std::make_unique<CbEvictPolicy>(score_age_evict),
             nullptr, input_stream_policy, valid_rate_threshold, std::make_unique<CbEvictPolicy>(score_greedy_first), 0, false, stat_log_file), cache_type, start_ts, !stat_log_file.empty());
     }
+    else if (cache_type == "LOG_ORACLE") { // WAF 하한: cache_sim --oracle 로 만든 next-write sidecar 필요
+        assert(!g_oracle_sidecar_file.empty());
+        double target = valid_rate_threshold > 0 ? valid_rate_threshold : 0.90;
+        // KEEP 은 목표 valid rate 만큼의 block 까지만: 나머지는 GC 가 내릴 수 있어야 한다
+        OracleStream *oracle = new OracleStream(g_oracle_sidecar_file, static_cast<uint64_t>(capacity),
+                                                static_cast<uint64_t>(capacity * std::min(target, 1.0)));
+        return attach_prefix(new LogCache(cold_capacity, capacity, cache_block_size, _cache_trace, trace_file,
+            cold_trace_file, waf_log_file, std::make_unique<OracleEvictPolicy>(oracle),
+            nullptr, oracle, target, std::make_unique<OracleEvictPolicy>(oracle), 0, false, stat_log_file), cache_type, start_ts, !stat_log_file.empty());
+    }
     else if (cache_type == "LOG_FIFO_2") {
         Config cfg  ={
            // .segment_bytes  = 1ull * 1024 * 1024 * 1024, ///< default 32 MB
@@ -495,6 +526,18 @@ ICache* createCache(std::string cache_type, long capacity, uint64_t cold_capacit
             cold_trace_file, waf_log_file, std::make_unique<CbEvictPolicy>(score_age_evict), 
             nullptr, input_stream_policy, 0.80, std::make_unique<CbEvictPolicy>(score_sepbit_age), 0, false), cache_type, start_ts);
     }
+    else if (cache_type == "LOG_SKETCH_FIFO") { // LOG_SEPBIT_FIFO 와 같은 설정, 고정 메모리 sketch 분류 (--sketch_mb)
+        IStream *input_stream_policy = createIstreamPolicy("sketch");
+        return attach_prefix(new LogCache(cold_capacity, capacity, cache_block_size, _cache_trace, trace_file, 
+            cold_trace_file, waf_log_file, std::make_unique<CbEvictPolicy>(score_age_evict), 
+            nullptr, input_stream_policy, 0.80, std::make_unique<CbEvictPolicy>(score_sepbit_age), 0, false), cache_type, start_ts);
+    }
+    else if (cache_type == "LOG_LIFETIME_FIFO") { // LOG_SEPBIT_FIFO 와 같은 설정, stream 만 학습 기반 lifetime 분류
+        IStream *input_stream_policy = createIstreamPolicy("lifetime");
+        return attach_prefix(new LogCache(cold_capacity, capacity, cache_block_size, _cache_trace, trace_file, 
+            cold_trace_file, waf_log_file, std::make_unique<CbEvictPolicy>(score_age_evict), 
+            nullptr, input_stream_policy, 0.80, std::make_unique<CbEvictPolicy>(score_sepbit_age), 0, false), cache_type, start_ts);
+    }
     else if (cache_type == "LOG_GREEDY_FIFO_2") {
         g_numerator = 10;
         g_denominator = 90;
@@ -578,6 +621,16 @@ ICache* createCache(std::string cache_type, long capacity, uint64_t cold_capacit
             0.88),   // max
             cache_type, start_ts, !stat_log_file.empty());
     }
+    else if (cache_type == "TIERED") { // --tiers "TYPE:SIZE[:SEG_SCALE],..." (tiered_cache.h), capacity 는 무시
+        std::vector<TierSpec> specs;
+        std::string error;
+        if (!TieredCache::parse_tiers(g_tiers, specs, error)) {
+            std::cerr << "Bad --tiers: " << error << std::endl;
+            exit(1);
+        }
+        return attach_prefix(new TieredCache(cold_capacity, cache_block_size, specs, waf_log_file, stat_log_file),
+                             cache_type, start_ts);
+    }
     else if (cache_type == "MIDAS_CACHE") {
         MidasInitArgs midas_args;
         midas_args.workload = "midas_cache_adapter";
@@ -596,7 +649,10 @@ ICache* createCache(std::string cache_type, long capacity, uint64_t cold_capacit
     return nullptr;
 }
 
-ICache::ICache(uint64_t cold_capacity, const std::string& waf_log_file, const std::string& input_stat_log_file):ftl(cold_capacity, new GreedyEvictPolicy()) {
+// TieredCache 가 tier 를 만드는 동안 켠다: eviction 은 evict_sink 로 가므로 tier 자신의 cold ftl 은 비워 둔다
+thread_local bool g_detached_cold_ftl = false;
+
+ICache::ICache(uint64_t cold_capacity, const std::string& waf_log_file, const std::string& input_stat_log_file):ftl(g_detached_cold_ftl ? 0 : cold_capacity, new GreedyEvictPolicy(), g_nand_geometry, g_cold_ftl_mapping) {
     write_size_to_cache = 0;
     evicted_blocks = 0;
     write_hit_size = 0;
@@ -652,21 +708,31 @@ void ICache::rename_stat_log(const std::string& new_name) {
     }
 }
 
-void ICache::_evict_one_block(uint64_t lba_offset, int lba_size, OP_TYPE op_type) {
+void ICache::_evict_one_block(uint64_t lba_offset, int lba_size, OP_TYPE op_type, int stream_id) {
     if (op_type == OP_TYPE::WRITE) { 
         //printf("Evicting block at offset: %lu, size: %d\n", lba_offset, lba_size);
-        ftl.Write(lba_offset, lba_size, 0); // 0은 stream ID로 가정
+        ++cold_write_ops;
+        cold_write_bytes += lba_size;
+        if (evict_sink) {
+            evict_sink->sink_write(lba_offset, lba_size);
+        } else {
+            ftl.Write(lba_offset, lba_size, stream_id); // 기본 0, eviction batcher 는 전용 stream 을 쓸 수 있다
+        }
     }
     if (write_size_to_cache > next_write_size_to_cache) {
         next_write_size_to_cache += TEN_GB;
-        fprintf(fp, "%lld %lld %ld %ld\n", write_size_to_cache, evicted_blocks * get_block_size(), ftl.GetHostWritePages() * NAND_PAGE_SIZE, ftl.GetNandWritePages() * NAND_PAGE_SIZE);
+        fprintf(fp, "%lld %lld %ld %ld\n", write_size_to_cache, evicted_blocks * get_block_size(), ftl.GetHostWriteBytes(), ftl.GetNandWriteBytes());
         fflush(fp);
     }
 }
 
 void ICache::_invalidate_cold_block(uint64_t lba_offset, int lba_size, OP_TYPE op_type) {
     if (op_type == OP_TYPE::TRIM) {
-        ftl.Trim(lba_offset, lba_size);
+        if (evict_sink) {
+            evict_sink->sink_trim(lba_offset, lba_size);
+        } else {
+            ftl.Trim(lba_offset, lba_size);
+        }
     }
 }
 
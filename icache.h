@@ -19,6 +19,14 @@ struct CacheEntry {
     size_t allocated_id;
 };
 
+// cache 가 cold tier 로 내보내는 write / trim 을 ftl 대신 받는 쪽 (TieredCache 가 아래 tier 를 연결할 때 쓴다)
+class IEvictSink {
+public:
+    virtual ~IEvictSink() = default;
+    virtual void sink_write(uint64_t lba_offset, int lba_size) = 0;
+    virtual void sink_trim(uint64_t lba_offset, int lba_size) = 0;
+};
+
 class ICache {
 public:
     // 생성자: capacity는 블록 단위 최대 개수
@@ -49,12 +57,18 @@ public:
     virtual bool is_cache_filled() = 0;
     virtual int get_block_size() = 0;
     virtual void print_cache_trace(long long lba_offset, int lba_size, OP_TYPE op_type){};
-    void _evict_one_block(uint64_t lba_offset, int lba_size, OP_TYPE op_type);
+    void _evict_one_block(uint64_t lba_offset, int lba_size, OP_TYPE op_type, int stream_id = 0);
     void _invalidate_cold_block(uint64_t lba_offset, int lba_size, OP_TYPE op_type);
     virtual void print_stats() {}
     virtual void evict_one_block() = 0;
     virtual size_t size() = 0;
     virtual bool is_no_cache() { return false; }
+    // 위 tier 에서 새로 쓰인 block 의 옛 copy 무효화. cache 에 없으면 cold tier 로 trim 을 넘긴다
+    virtual void trim(long key, int lba_size) { _invalidate_cold_block(static_cast<uint64_t>(key) * get_block_size(), lba_size, OP_TYPE::TRIM); }
+    // GC (compaction / migration) 로 cache 안에서 다시 쓴 block 수, per-tier WAF 계산용
+    virtual uint64_t gc_write_blocks() { return 0; }
+    // --valid_mpc 제어기가 실제로 붙었는지 (ghost 를 쓰는 LOG_* policy 만)
+    virtual bool valid_mpc_enabled() { return false; }
     std::tuple<long long, long long, long long> get_status();
     void set_stats_prefix(const std::string& prefix);
     const std::string& stats_prefix() const;
@@ -62,10 +76,19 @@ public:
     const std::string& start_ts() const { return start_ts_; }
     void rename_stat_log(const std::string& new_name);
     PageMappingFTL ftl;
+    IEvictSink *evict_sink = nullptr;   // 설정되면 eviction / trim 이 ftl 대신 여기로 간다
     long long write_size_to_cache;
     long long evicted_blocks;
     long long write_hit_size;
     long long next_write_size_to_cache;
+    long long cold_write_ops = 0;     // cold tier 로 보낸 write 요청 수 / bytes (평균 write 크기)
+    long long cold_write_bytes = 0;
+    // issue_op_to_cache 가 batch_insert 직전에 설정하는 host 요청 범위 (block 안 sector 위치 계산용, -1 = 모름)
+    // 와 요청을 낸 volume (trace 의 dev_id 를 처음 나온 순서로 번호 매김, 순차 stream 감지용)
+    long long req_offset = -1;
+    int       req_size = 0;
+    int       req_volume = 0;
+    void set_request(long long lba_offset, int lba_size, int volume = 0) { req_offset = lba_offset; req_size = lba_size; req_volume = volume; }
     FILE *fp;
     FILE *fp_stats = nullptr;
     FILE *fp_object = nullptr;
@@ -3,16 +3,21 @@
 #include "hot_cold.h"
 #include "multi_hot_cold.h"
 #include "hot_cold_midas.h"
+#include "lifetime_stream.h"
+#include "sketch_stream.h"
 #include <string>
 #include <cassert>
 #include <algorithm>
 
-uint64_t interval = 1;
+thread_local uint64_t interval = 1;
+thread_local uint64_t stream_lba_space = 0;
+thread_local uint64_t stream_cache_blocks = 0;
 namespace {
 constexpr int kMultiHotColdStreams = 5;
 }
 
 void set_stream_interval(uint64_t cache_block_count, uint64_t segment_size_blocks) {
+    stream_cache_blocks = cache_block_count;
     uint64_t computed = (uint64_t)(cache_block_count / (3));
     if (computed == 0) {
         computed = 1;
@@ -28,12 +33,16 @@ void set_stream_interval(uint64_t cache_block_count, uint64_t segment_size_block
     interval = computed;
 }
 
+void set_stream_lba_space(uint64_t lba_space_blocks) {
+    stream_lba_space = lba_space_blocks;
+}
+
 IStream* createIstreamPolicy(std::string policy_type) {
     if (policy_type == "none" || policy_type.empty()) {
         return nullptr;
     }
     if (policy_type == "sepbit") {
-        return new SepBIT();
+        return new SepBIT(stream_lba_space);
     }
     else if (policy_type == "hotcold") {
         return new HotCold();
@@ -52,6 +61,12 @@ IStream* createIstreamPolicy(std::string policy_type) {
     else if (policy_type == "midas_hotcold") {
         return new MiDASHotCold();
     }
+    else if (policy_type == "lifetime") {
+        return new LifetimeStream(stream_lba_space, stream_cache_blocks);
+    }
+    else if (policy_type == "sketch") {
+        return new SketchStream(static_cast<uint64_t>(g_sketch_mb) << 20, stream_cache_blocks, g_sketch_accuracy);
+    }
     else {
         assert(false);
     }
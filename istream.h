@@ -12,9 +12,17 @@ public:
         return -1;
     }
     virtual int getNumHostStreams() const { return 2; }  // default: hot/cold
+    // compaction 중 block 처리 힌트 (oracle 용). NONE 이면 기존 age threshold 로 결정
+    enum class EvictHint { NONE, KEEP, EVICT };
+    virtual EvictHint GetEvictHint(uint64_t blockAddr, uint64_t global_timestamp) { return EvictHint::NONE; }
+    // age 기반 GC stream 구성 (GcStreamTuner 용). 0 / false 면 지원 안 함
+    virtual int  getNumGcStreams() const { return 0; }
+    virtual bool SetGcLayout(int num_gc_streams, uint64_t granularity) { return false; }
 static const int MAX_STREAMS = 40;
 };
 
 IStream* createIstreamPolicy(std::string policy_type);
 void set_stream_interval(uint64_t cache_block_count, uint64_t segment_size_blocks = 0);
-extern uint64_t interval;  // = granularity (timestamp units per GC stream)
+// cold device 의 block 수 (SepBIT 의 per-LBA 표 크기). 그보다 큰 주소가 오면 표가 늘어난다
+void set_stream_lba_space(uint64_t lba_space_blocks);
+extern thread_local uint64_t interval;  // = granularity (timestamp units per GC stream)
@@ -0,0 +1,111 @@
+#include "key_table.h"
+
+#include <algorithm>
+#include <cmath>
+
+SideTableConfig g_side_tables;
+
+static constexpr uint64_t SAMPLE_MOD = 1ULL << 24;
+
+// splitmix64 finalizer – 연속된 LBA 도 고르게 sampling 되도록
+static inline uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+KeyTable::KeyTable(Mode mode, double sample_rate, unsigned shift)
+    : mode_(mode), shift_(shift)
+{
+    if (mode_ == Mode::SAMPLED) {
+        rate_ = std::min(1.0, std::max(sample_rate, 1.0 / SAMPLE_MOD));
+        threshold_ = static_cast<uint64_t>(rate_ * SAMPLE_MOD);
+        weight_ = std::max<uint64_t>(1, static_cast<uint64_t>(std::llround(1.0 / rate_)));
+    }
+}
+
+bool KeyTable::tracked(uint64_t key) const
+{
+    switch (mode_) {
+        case Mode::OFF:     return false;
+        case Mode::DENSE:   return true;
+        case Mode::SAMPLED: return (mix64(key) % SAMPLE_MOD) < threshold_;
+    }
+    return false;
+}
+
+uint32_t KeyTable::encode(uint64_t value) const
+{
+    uint64_t v = (value >> shift_) + 1;
+    return v >= UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(v);   // 범위 밖은 saturate
+}
+
+bool KeyTable::get(uint64_t key, uint64_t& value) const
+{
+    if (mode_ == Mode::DENSE) {
+        uint64_t page = key >> PAGE_BITS;
+        if (page >= pages_.size() || !pages_[page]) return false;
+        uint32_t slot = pages_[page][key & (PAGE_SIZE - 1)];
+        if (slot == 0) return false;
+        value = decode(slot);
+        return true;
+    }
+    if (mode_ == Mode::SAMPLED) {
+        auto it = sampled_.find(key);
+        if (it == sampled_.end()) return false;
+        value = decode(it->second);
+        return true;
+    }
+    return false;
+}
+
+void KeyTable::set(uint64_t key, uint64_t value)
+{
+    if (mode_ == Mode::DENSE) {
+        uint64_t page = key >> PAGE_BITS;
+        if (page >= pages_.size()) pages_.resize(page + 1);
+        if (!pages_[page]) pages_[page].reset(new uint32_t[PAGE_SIZE]());
+        uint32_t& slot = pages_[page][key & (PAGE_SIZE - 1)];
+        if (slot == 0) ++live_;
+        slot = encode(value);
+    }
+    else if (mode_ == Mode::SAMPLED) {
+        if (!tracked(key)) return;
+        auto res = sampled_.emplace(key, encode(value));
+        if (res.second) ++live_;
+        else res.first->second = encode(value);
+    }
+}
+
+void KeyTable::erase(uint64_t key)
+{
+    if (mode_ == Mode::DENSE) {
+        uint64_t page = key >> PAGE_BITS;
+        if (page >= pages_.size() || !pages_[page]) return;
+        uint32_t& slot = pages_[page][key & (PAGE_SIZE - 1)];
+        if (slot != 0) --live_;
+        slot = 0;
+    }
+    else if (mode_ == Mode::SAMPLED) {
+        live_ -= sampled_.erase(key);
+    }
+}
+
+bool KeyTable::parse_mode(const std::string& s, Mode& mode)
+{
+    if (s == "off")     { mode = Mode::OFF;     return true; }
+    if (s == "dense")   { mode = Mode::DENSE;   return true; }
+    if (s == "sampled") { mode = Mode::SAMPLED; return true; }
+    return false;
+}
+
+const char* KeyTable::mode_name(Mode mode)
+{
+    switch (mode) {
+        case Mode::OFF:     return "off";
+        case Mode::DENSE:   return "dense";
+        case Mode::SAMPLED: return "sampled";
+    }
+    return "?";
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// block key → 32-bit 값(epoch timestamp 등) side table.
+// unordered_map<long, uint64_t> 대신 쓰는 메모리 bounded 버전.
+//  - OFF     : 아무것도 저장하지 않음 (get 은 항상 miss)
+//  - DENSE   : key 공간을 64K 단위 page 로 나눠 필요할 때만 할당하는 uint32 배열 (key 당 4 B)
+//  - SAMPLED : hash(key) < rate 인 key 만 map 에 저장. 통계에는 count_weight() (= 1/rate) 를 곱한다
+// 값은 (value >> shift) + 1 로 저장하므로 shift 만큼 해상도를 잃는 대신 2^(32+shift) 까지 표현된다.
+class KeyTable {
+public:
+    enum class Mode { OFF, DENSE, SAMPLED };
+
+    KeyTable() = default;
+    KeyTable(Mode mode, double sample_rate, unsigned shift);
+
+    bool tracked(uint64_t key) const;
+    bool get(uint64_t key, uint64_t& value) const;
+    void set(uint64_t key, uint64_t value);
+    void erase(uint64_t key);
+
+    bool        enabled() const { return mode_ != Mode::OFF; }
+    Mode        mode() const { return mode_; }
+    std::size_t size() const { return live_; }
+    // sampled 모드에서 key 하나가 대표하는 key 수
+    uint64_t    count_weight() const { return weight_; }
+    double      sample_rate() const { return mode_ == Mode::SAMPLED ? rate_ : 1.0; }
+
+    static bool parse_mode(const std::string& s, Mode& mode);
+    static const char* mode_name(Mode mode);
+
+private:
+    static constexpr unsigned PAGE_BITS = 16;
+    static constexpr uint64_t PAGE_SIZE = 1ULL << PAGE_BITS;
+
+    uint32_t encode(uint64_t value) const;
+    uint64_t decode(uint32_t slot) const { return static_cast<uint64_t>(slot - 1) << shift_; }
+
+    Mode     mode_ = Mode::OFF;
+    double   rate_ = 1.0;
+    uint64_t threshold_ = 0;
+    uint64_t weight_ = 1;
+    unsigned shift_ = 0;
+    std::size_t live_ = 0;
+    std::vector<std::unique_ptr<uint32_t[]>> pages_;
+    std::unordered_map<uint64_t, uint32_t> sampled_;
+};
+
+// LogCache per-LBA 통계 table 별 추적 방식 (cache_sim --track_* 로 설정, 모든 thread 공통)
+struct SideTableConfig {
+    KeyTable::Mode reinsert      = KeyTable::Mode::DENSE;  // evicted → 재기록 (stat log reinsert_blocks)
+    KeyTable::Mode compacted     = KeyTable::Mode::OFF;    // compaction 후 lifetime histogram
+    KeyTable::Mode rewrite       = KeyTable::Mode::OFF;    // rewrite_histogram.csv
+    KeyTable::Mode inv_snapshot  = KeyTable::Mode::OFF;    // inv_time_scatter (10 TB snapshot)
+    double         sample_rate   = 0.01;
+};
+extern SideTableConfig g_side_tables;
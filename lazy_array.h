@@ -0,0 +1,53 @@
+#pragma once
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// anonymous mmap(MAP_NORESERVE) 위의 고정 크기 배열.
+// 처음 만질 때 page 가 commit 되고 0 으로 시작한다. 범위 밖 index 는 grow() 로 늘린다 (mremap, 내용 유지)
+template <typename T>
+class LazyArray
+{
+  public:
+    explicit LazyArray(uint64_t n = 0) { grow(n); }
+    ~LazyArray() { if (mData) munmap(mData, mBytes); }
+    LazyArray(const LazyArray&) = delete;
+    LazyArray& operator=(const LazyArray&) = delete;
+
+    T& operator[](uint64_t i) { return mData[i]; }
+    const T& operator[](uint64_t i) const { return mData[i]; }
+    uint64_t size() const { return mSize; }
+
+    // i 가 들어가도록 두 배씩 키운다
+    void reserve_index(uint64_t i)
+    {
+      if (i < mSize) return;
+      uint64_t n = mSize ? mSize : 4096;
+      while (n <= i) n *= 2;
+      grow(n);
+    }
+
+    void grow(uint64_t n)
+    {
+      if (n <= mSize) return;
+      uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+      uint64_t bytes = (n * sizeof(T) + page - 1) / page * page;
+      void* p = mData ? mremap(mData, mBytes, bytes, MREMAP_MAYMOVE)
+                      : mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+      if (p == MAP_FAILED) {
+        perror("LazyArray mmap");
+        abort();
+      }
+      mData = static_cast<T*>(p);
+      mBytes = bytes;
+      mSize = bytes / sizeof(T);
+    }
+
+  private:
+    T* mData = nullptr;
+    uint64_t mBytes = 0;
+    uint64_t mSize = 0;
+};
@@ -0,0 +1,152 @@
+#include "lifetime_stream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+LifetimeStream::LifetimeStream(uint64_t lba_space_blocks, uint64_t cache_block_count)
+    : cache_block_count_(std::max<uint64_t>(cache_block_count, 64)),
+      unit_(std::max<uint64_t>(1, cache_block_count_ / 64)),
+      retrain_blocks_(std::max<uint64_t>(1, cache_block_count_)),
+      recs_(lba_space_blocks),
+      train_(NUM_CELLS), model_(NUM_CELLS), marg_(IV_BUCKETS), host_pred_(NUM_CELLS, INF_LIFETIME)
+{
+    printf("lifetime_stream: lba_space=%lu cache_blocks=%lu unit=%lu retrain every %lu blocks\n",
+           lba_space_blocks, cache_block_count_, unit_, retrain_blocks_);
+}
+
+LifetimeStream::~LifetimeStream()
+{
+    printf("lifetime_stream: retrains=%lu host classes", retrains_);
+    for (int c = 0; c < NUM_CLASSES; c++) printf(" %lu", class_count_[0][c]);
+    printf(" gc classes");
+    for (int c = 0; c < NUM_CLASSES; c++) printf(" %lu", class_count_[1][c]);
+    printf("\n");
+}
+
+int LifetimeStream::iv_bucket(double iv) const
+{
+    if (iv <= 0) return 0;
+    int b = static_cast<int>(std::floor(std::log2(iv / unit_))) + 2;
+    return std::min(IV_BUCKETS - 1, std::max(1, b));
+}
+
+int LifetimeStream::make_cell(const Rec& r, uint64_t now, uint64_t run) const
+{
+    int last = r.last_write ? iv_bucket(static_cast<double>(now - (r.last_write - 1))) : 0;
+    int ewma = iv_bucket(r.ewma);
+    int seq = run <= 1 ? 0 : (run < 16 ? 1 : 2);
+    return (last * IV_BUCKETS + ewma) * SEQ_BUCKETS + seq;
+}
+
+// 표본이 적으면 interval marginal, 그것도 적으면 전체 분포
+const LifetimeStream::Dist& LifetimeStream::dist_for(int cell) const
+{
+    if (model_[cell].writes >= MIN_CELL_WRITES) return model_[cell];
+    const Dist& m = marg_[cell / (IV_BUCKETS * SEQ_BUCKETS)];
+    if (m.writes >= MIN_CELL_WRITES) return m;
+    return global_;
+}
+
+// lifetime > age 조건부 중앙값까지 남은 시간. 관측 안 된(censored) 질량은 ∞ 에 둔다
+uint64_t LifetimeStream::quantile_after(const Dist& d, uint64_t age) const
+{
+    if (d.writes <= 0) return INF_LIFETIME;
+    int start = age ? std::min(LT_BUCKETS - 1, 63 - __builtin_clzll(age)) : 0;
+    double observed = 0, mass = 0;
+    for (int b = 0; b < LT_BUCKETS; b++) {
+        observed += d.hist[b];
+        if (b >= start) mass += d.hist[b];
+    }
+    mass += std::max(0.0, d.writes - observed);
+    double half = mass / 2, acc = 0;
+    for (int b = start; b < LT_BUCKETS; b++) {
+        acc += d.hist[b];
+        if (acc >= half) {
+            uint64_t lt = (b == 0) ? 1 : (3ull << b) / 2;   // bucket 중간값 [2^b, 2^(b+1))
+            return lt > age ? lt - age : 0;
+        }
+    }
+    return INF_LIFETIME;
+}
+
+int LifetimeStream::lifetime_class(uint64_t remain) const
+{
+    uint64_t bound = cache_block_count_ / 8;
+    for (int c = 0; c < NUM_CLASSES - 1; c++) {
+        if (remain < bound) return c;
+        bound *= 2;
+    }
+    return NUM_CLASSES - 1;
+}
+
+void LifetimeStream::retrain()
+{
+    double observed = 0, writes = 0;
+    for (auto& m : marg_) m = Dist();
+    global_ = Dist();
+    for (int c = 0; c < NUM_CELLS; c++) {
+        Dist& m = model_[c];
+        Dist& t = train_[c];
+        m.writes = m.writes * DECAY + t.writes;
+        for (int b = 0; b < LT_BUCKETS; b++) m.hist[b] = m.hist[b] * DECAY + t.hist[b];
+        t = Dist();
+
+        Dist& g = marg_[c / (IV_BUCKETS * SEQ_BUCKETS)];
+        g.writes += m.writes;
+        global_.writes += m.writes;
+        for (int b = 0; b < LT_BUCKETS; b++) {
+            g.hist[b] += m.hist[b];
+            global_.hist[b] += m.hist[b];
+            observed += m.hist[b];
+        }
+        writes += m.writes;
+    }
+    for (int c = 0; c < NUM_CELLS; c++) host_pred_[c] = quantile_after(dist_for(c), 0);
+    ++retrains_;
+    printf("lifetime_stream: retrain #%lu writes=%.0f rewritten=%.1f%%\n",
+           retrains_, writes, writes > 0 ? observed / writes * 100.0 : 0.0);
+}
+
+int LifetimeStream::Classify(uint64_t blockAddr, bool isGcAppend, uint64_t global_timestamp, uint64_t created_timestamp)
+{
+    const Rec* r = blockAddr < recs_.size() ? &recs_[blockAddr] : nullptr;
+    if (isGcAppend) {
+        int cls = NUM_CLASSES - 1;
+        if (r && r->last_write) {
+            uint64_t age = global_timestamp - (r->last_write - 1);
+            cls = lifetime_class(quantile_after(dist_for(r->cell), age));
+        }
+        ++class_count_[1][cls];
+        return cls + Segment::GC_STREAM_START;
+    }
+    Rec empty = {};
+    uint64_t run = (blockAddr == prev_key_ + 1) ? run_ + 1 : 1;
+    int cell = make_cell(r ? *r : empty, global_timestamp, run);
+    int cls = lifetime_class(host_pred_[cell]);
+    ++class_count_[0][cls];
+    return cls;
+}
+
+void LifetimeStream::Append(uint64_t blockAddr, uint64_t global_timestamp, void *arg)
+{
+    uint64_t now = global_timestamp - 1;    // Append 는 timestamp 증가 뒤에 불린다
+    run_ = (blockAddr == prev_key_ + 1) ? run_ + 1 : 1;
+    prev_key_ = blockAddr;
+
+    recs_.reserve_index(blockAddr);
+    Rec& r = recs_[blockAddr];
+    int cell = make_cell(r, now, run_);
+    if (r.last_write) {
+        // 이전 copy 의 lifetime 이 끝났다: 그때의 cell 로 학습
+        uint64_t lt = now - (r.last_write - 1);
+        int b = lt ? std::min(LT_BUCKETS - 1, 63 - __builtin_clzll(lt)) : 0;
+        train_[r.cell].hist[b] += 1;
+        r.ewma = r.ewma > 0 ? 0.5f * r.ewma + 0.5f * static_cast<float>(lt) : static_cast<float>(lt);
+    }
+    train_[cell].writes += 1;
+    r.cell = static_cast<uint16_t>(cell);
+    r.last_write = now + 1;
+
+    if (++host_writes_ % retrain_blocks_ == 0) retrain();
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "istream.h"
+#include "lazy_array.h"
+
+// ===== 학습 기반 lifetime 분류 (online) =====
+// LBA 마다 작은 feature 만 들고 (마지막 rewrite interval, rewrite interval 의 EWMA, 연속 write 길이)
+// feature bucket 조합(cell) 별 lifetime 분포(log2 histogram)를 host rewrite 때 관측된 실제 lifetime 으로 학습한다.
+//  - 다시 쓰이지 않은 block 은 cell 의 write 수 - 관측 lifetime 수 로 censored 처리 (∞ 로 본다)
+//  - retrain_blocks 마다 학습 중인 표를 decay 해서 합치고 cell 별 예측(중앙값)을 다시 계산
+//  - host write: cell 의 예측 lifetime, GC relocation: age 를 넘긴 조건부 중앙값 - age (남은 lifetime)
+//  - lifetime 구간은 OracleStream 과 같다 (cache/8 부터 두 배씩), host/GC 각각 NUM_CLASSES 개 stream
+class LifetimeStream : public IStream {
+public:
+    static constexpr int NUM_CLASSES = 4;
+
+    LifetimeStream(uint64_t lba_space_blocks, uint64_t cache_block_count);
+    ~LifetimeStream();
+
+    int  Classify(uint64_t blockAddr, bool isGcAppend, uint64_t global_timestamp, uint64_t created_timestamp) override;
+    void Append(uint64_t blockAddr, uint64_t global_timestamp, void *arg) override;
+    void GcAppend(uint64_t blockAddr) override {}
+    void CollectSegment(Segment *segment, uint64_t global_timestamp) override {}
+    int  getNumHostStreams() const override { return NUM_CLASSES; }
+
+private:
+    // LBA 별 16 B
+    struct Rec {
+        uint64_t last_write;   // 마지막 host write timestamp + 1 (0 = 아직 없음)
+        float    ewma;         // rewrite interval EWMA (block 수, 0 = 없음)
+        uint16_t cell;         // 마지막 write 때의 feature cell (학습 label 의 입력)
+        uint16_t pad;
+    };
+
+    static constexpr int IV_BUCKETS = 10;   // 0 = 없음, 1..9 = log2(interval / unit)
+    static constexpr int SEQ_BUCKETS = 3;   // 연속 run 길이: 1, 2..15, 16+
+    static constexpr int NUM_CELLS = IV_BUCKETS * IV_BUCKETS * SEQ_BUCKETS;
+    static constexpr int LT_BUCKETS = 48;   // lifetime log2 histogram
+    static constexpr double MIN_CELL_WRITES = 64;
+    static constexpr double DECAY = 0.5;
+    static constexpr uint64_t INF_LIFETIME = UINT64_MAX;
+
+    struct Dist {
+        double writes = 0;                  // 이 cell 로 쓰인 block 수
+        double hist[LT_BUCKETS] = {};       // 관측 lifetime (rewrite 된 것만)
+    };
+
+    int  iv_bucket(double iv) const;
+    int  make_cell(const Rec& r, uint64_t now, uint64_t run) const;
+    const Dist& dist_for(int cell) const;
+    uint64_t quantile_after(const Dist& d, uint64_t age) const;
+    int  lifetime_class(uint64_t remain) const;
+    void retrain();
+
+    uint64_t cache_block_count_;
+    uint64_t unit_;                  // interval bucket 단위 (cache / 64)
+    uint64_t retrain_blocks_;
+    LazyArray<Rec> recs_;
+
+    uint64_t prev_key_ = UINT64_MAX;
+    uint64_t run_ = 0;
+    uint64_t host_writes_ = 0;
+    uint64_t retrains_ = 0;
+
+    std::vector<Dist> train_;        // 이번 구간에 모은 것
+    std::vector<Dist> model_;        // decay 누적 (예측에 쓰는 것)
+    std::vector<Dist> marg_;         // interval bucket 만 본 marginal (back-off)
+    Dist global_;
+    std::vector<uint64_t> host_pred_; // cell 별 예측 lifetime
+    uint64_t class_count_[2][NUM_CLASSES] = {};
+};
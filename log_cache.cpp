@@ -1,5 +1,6 @@
 #include "log_cache.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdio>
@@ -7,10 +8,15 @@
 #include <list>
 #include <set>
 
-extern uint64_t interval;
-extern double g_segment_blocks;
-extern uint64_t g_threshold;
-extern uint64_t g_timestamp;
+extern thread_local uint64_t interval;
+extern thread_local double g_segment_blocks;
+extern thread_local uint64_t g_threshold;
+extern thread_local uint64_t g_timestamp;
+thread_local double g_segment_scale = 1.0;
+uint64_t g_bypass_blocks = 0;
+bool g_evict_batch = false;
+bool g_evict_stream = false;
+bool g_sector_valid = false;
 
 /* ------------------------------------------------------------------ */
 /* ctor / dtor                                                        */
@@ -52,21 +58,38 @@ LogCache::LogCache(uint64_t              cold_capacity,
       evicted_cache_blocks_per_evict(std::make_unique<Histogram>("evicted_cache_blocks_per_evict", 1, 100, fp_stats)),
       compacted_lifetime_histogram_(std::make_unique<Histogram>("compacted_lifetime", interval/4, HISTOGRAM_BUCKETS * 2, fp_stats)),
       is_ghost_cache(input_ghost_cache),
-      compaction_ratio(EwmaRatio::FromHalfLifeBlocks(DEFAULT_HALF_LIFE_IN_BLOCKS)),
-      eviction_ratio(EwmaRatio::FromHalfLifeBlocks(DEFAULT_HALF_LIFE_IN_BLOCKS)),
-      eviction_ratio_in_ghost_cache(EwmaRatio::FromHalfLifeBlocks(DEFAULT_HALF_LIFE_IN_BLOCKS)),
-      compaction_ratio_in_ghost_cache(EwmaRatio::FromHalfLifeBlocks(DEFAULT_HALF_LIFE_IN_BLOCKS)),
-      ghost_util_ratio(EwmaRatio::FromHalfLifeBlocks(DEFAULT_HALF_LIFE_IN_BLOCKS)),
-      ghost_cache(cache_block_count * 0.1),
-      net_free_seg_ratio_(EwmaRatio::FromHalfLifeBlocks(DEFAULT_HALF_LIFE_IN_BLOCKS)),
-      gc_valid_pages_ratio_(EwmaRatio::FromHalfLifeBlocks(DEFAULT_HALF_LIFE_IN_BLOCKS))
+      compaction_ratio(EwmaRatio::FromHalfLifeBlocks(DEFAULT_HALF_LIFE_IN_BLOCKS * g_segment_scale)),
+      eviction_ratio(EwmaRatio::FromHalfLifeBlocks(DEFAULT_HALF_LIFE_IN_BLOCKS * g_segment_scale)),
+      eviction_ratio_in_ghost_cache(EwmaRatio::FromHalfLifeBlocks(DEFAULT_HALF_LIFE_IN_BLOCKS * g_segment_scale)),
+      compaction_ratio_in_ghost_cache(EwmaRatio::FromHalfLifeBlocks(DEFAULT_HALF_LIFE_IN_BLOCKS * g_segment_scale)),
+      ghost_util_ratio(EwmaRatio::FromHalfLifeBlocks(DEFAULT_HALF_LIFE_IN_BLOCKS * g_segment_scale)),
+      ghost_cache(!input_ghost_cache ? 0 :
+                  g_ghost_shadow_ratios.empty() ? cache_block_count * 0.1 :
+                  cache_block_count * *std::max_element(g_ghost_shadow_ratios.begin(), g_ghost_shadow_ratios.end()),
+                  g_ghost_fingerprint_only),   // ghost 제어가 off 면 할당 안 함
+      admission_ghost_(admission_enabled() ? cache_block_count * 0.1 : 0, g_ghost_fingerprint_only),
+      net_free_seg_ratio_(EwmaRatio::FromHalfLifeBlocks(DEFAULT_HALF_LIFE_IN_BLOCKS * g_segment_scale)),
+      gc_valid_pages_ratio_(EwmaRatio::FromHalfLifeBlocks(DEFAULT_HALF_LIFE_IN_BLOCKS * g_segment_scale))
 {
     periodic_ratio_ = periodic_ratio;
+    evicted_timestamp       = KeyTable(g_side_tables.reinsert, g_side_tables.sample_rate, SIDE_TABLE_TS_SHIFT);
+    compacted_at_           = KeyTable(g_side_tables.compacted, g_side_tables.sample_rate, SIDE_TABLE_TS_SHIFT);
+    rewrite_last_ts_        = KeyTable(g_side_tables.rewrite, g_side_tables.sample_rate, SIDE_TABLE_TS_SHIFT);
+    inv_snap_block_seg_idx_ = KeyTable(g_side_tables.inv_snapshot, g_side_tables.sample_rate, 0);
+    if (g_segment_scale != 1.0) {
+        cfg_.segment_bytes = std::max<std::size_t>(blk_sz,
+            static_cast<std::size_t>(cfg_.segment_bytes * g_segment_scale) / blk_sz * blk_sz);
+        cfg_.print_stats_interval = std::max<uint64_t>(blk_sz,
+            static_cast<uint64_t>(cfg_.print_stats_interval * g_segment_scale));
+    }
+    next_stats_written_bytes_ = cfg_.segment_bytes;
     segment_size_blocks = cfg_.segment_bytes / blk_sz;
     g_segment_blocks = static_cast<double>(segment_size_blocks);
     total_segments = cache_block_count * blk_sz / cfg_.segment_bytes;
     total_cache_block_count = total_segments * segment_size_blocks;
     total_capacity_bytes = cache_block_count * blk_sz;
+    gc_age_threshold_ = segment_size_blocks * static_cast<std::size_t>(std::ceil(total_segments *
+                            (1 - cfg_.free_ratio_low) * (1 + additional_free_blks_ratio_by_gc)));
     assert(segment_size_blocks > 0 && "segment_bytes too small");
     assert(total_segments      > 0 && "device_bytes too small");
     log_cache_timestamp = 0;
@@ -90,6 +113,53 @@ LogCache::LogCache(uint64_t              cold_capacity,
         next_valid_rate_change_ts_ = valid_rate_period_blocks_;
     }
 
+    admission_.reset(createAdmissionPolicy(g_admission_policy));
+    if (g_cache_ftl) {
+        cache_device_.reset(new CacheDevice(total_segments * cfg_.segment_bytes, cfg_.segment_bytes, blk_sz, g_cache_ftl_op));
+    }
+    if (g_evict_batch) {
+        evict_batcher_.reset(new EvictBatcher());
+    }
+    if (g_sector_valid) {
+        sector_size_ = static_cast<int>(g_nand_geometry.sector_size);
+        const int sectors = blk_sz / sector_size_;
+        assert(sectors >= 1 && sectors <= 64 && blk_sz % sector_size_ == 0);
+        full_sector_mask_ = sectors == 64 ? ~0ull : ((1ull << sectors) - 1);
+    }
+
+    /* ── Model 기반 GC stream 구성 (--gc_model) ──────────── */
+    if (g_gc_stream_model && stream_policy && stream_policy->getNumGcStreams() > 0) {
+        // stream 마다 open segment 하나를 잡으므로 전체 segment 의 1/4 이내로 제한
+        int max_gc_streams = std::max<int>(1, std::min<int>({8, IStream::MAX_STREAMS - Segment::GC_STREAM_START,
+                                                             static_cast<int>(total_segments / 4)}));
+        gc_tuner_.reset(new GcStreamTuner(cold_capacity / blk_sz, total_cache_block_count, max_gc_streams,
+                                          segment_size_blocks));
+    }
+
+    /* ── Multi-capacity ghost (--ghost_shadow) ───────────── */
+    if (is_ghost_cache && !g_ghost_shadow_ratios.empty()) {
+        ghost_shadow_ratios_ = g_ghost_shadow_ratios;
+        std::sort(ghost_shadow_ratios_.begin(), ghost_shadow_ratios_.end());
+        ghost_shadow_ratios_.erase(std::unique(ghost_shadow_ratios_.begin(), ghost_shadow_ratios_.end()),
+                                   ghost_shadow_ratios_.end());
+        std::vector<std::size_t> shadow_caps;
+        for (std::size_t i = 0; i + 1 < ghost_shadow_ratios_.size(); ++i) {
+            shadow_caps.push_back(static_cast<std::size_t>(cache_block_count * ghost_shadow_ratios_[i]));
+        }
+        ghost_cache.setShadowCapacities(shadow_caps);
+        for (std::size_t i = 0; i < ghost_shadow_ratios_.size(); ++i) {
+            ghost_shadow_eviction_ratio_.push_back(
+                EwmaRatio::FromHalfLifeBlocks(DEFAULT_HALF_LIFE_IN_BLOCKS * g_segment_scale));
+        }
+        if (g_valid_mpc_horizon > 0) {
+            mpc_step_blocks_ = std::max<uint64_t>(1, static_cast<uint64_t>(
+                g_valid_mpc_step_gb * 1024 * 1024 * 1024 * g_segment_scale / blk_sz));
+            valid_mpc_.reset(new ValidRateMpc(g_valid_mpc_horizon, periodic_ratio_, ghost_shadow_ratios_,
+                                              total_cache_block_count, valid_blk_rate_hard_limit,
+                                              &compaction_curve_, mpc_step_blocks_));
+        }
+    }
+
     // score_warm_first / score_cold_first 가 heap add 시점에
     // g_threshold=0 fallback(-create_timestamp) 으로 음수 cached score 를 갖지 않도록 초기화
     g_threshold = cache_block_count * 2;
@@ -99,6 +169,7 @@ LogCache::LogCache(uint64_t              cold_capacity,
     {
         all_segments.push_back(
             std::make_unique<LogCacheSegment>(segment_size_blocks, log_cache_timestamp));
+        all_segments.back()->id = i;
         free_pool.push_back(all_segments.back().get());
     }
 
@@ -118,6 +189,38 @@ LogCache::~LogCache()
     print_utilization_distribution();
     print_segment_age_scatter();
     print_inv_time_scatter();
+    if (bypass_blocks_threshold > 0) {
+        printf("bypass: threshold=%lu blocks, streams=%lu, blocks=%lu (%.2f GB) to cold tier, cached copies invalidated=%lu\n",
+               bypass_blocks_threshold, bypass_streams_, bypass_blocks_,
+               (double)bypass_blocks_ * cache_block_size / (1024.0 * 1024 * 1024), bypass_invalidated_);
+    }
+    if (admission_) admission_->print_stats(stdout);
+    if (cache_device_) {
+        cache_device_->print_stats(stdout);
+        cache_device_->print_stats(fp_stats);
+    }
+    if (g_sector_valid) {
+        print_sector_stats(stdout);
+        print_sector_stats(fp_stats);
+    }
+    printf("cold writes: %lld ops, %lld bytes, mean %.1f KiB, cold waf %.4f",
+           cold_write_ops, cold_write_bytes,
+           cold_write_ops ? cold_write_bytes / 1024.0 / cold_write_ops : 0.0,
+           ftl.GetHostWriteBytes() ? static_cast<double>(ftl.GetNandWriteBytes()) / ftl.GetHostWriteBytes() : 0.0);
+    if (evict_batcher_) {
+        printf(", evict batch: %lu ranges -> %lu runs over %lu victims%s",
+               evict_batcher_->ranges_added(), evict_batcher_->runs(), evict_batcher_->flushes(),
+               g_evict_stream ? " (dedicated stream)" : "");
+    }
+    printf("\n");
+    if (gc_tuner_) {
+        printf("gc_model: fitted %lu windows, dropped %lu (worker busy)\n",
+               gc_tuner_->fitted_windows(), gc_tuner_->dropped_windows());
+    }
+    if (valid_mpc_) {
+        valid_mpc_->print_summary(stdout, mpc_step_blocks_, cache_block_size);
+        valid_mpc_->print_summary(fp_stats, mpc_step_blocks_, cache_block_size);
+    }
     if (trace_fp_)      std::fclose(trace_fp_);
     if (cold_trace_fp_) std::fclose(cold_trace_fp_);
 }
@@ -131,7 +234,7 @@ bool LogCache::exists(long key)
 }
 
 
-void LogCache::invalidate(long key, int lba_sz) {
+void LogCache::invalidate(long key, int lba_sz, bool trim_cold) {
     if (exists(key))
     {
         auto loc = mapping[key];
@@ -139,12 +242,10 @@ void LogCache::invalidate(long key, int lba_sz) {
         {
             print_objects("invalidate", log_cache_timestamp - loc.seg->blocks[loc.idx].create_timestamp);
             record_lifetime(log_cache_timestamp - loc.seg->blocks[loc.idx].create_timestamp, true);
-            {
-                auto cit = compacted_at_.find(key);
-                if (cit != compacted_at_.end()) {
-                    compacted_lifetime_histogram_->inc(log_cache_timestamp - cit->second);
-                    compacted_at_.erase(cit);
-                }
+            uint64_t compacted_ts;
+            if (compacted_at_.get(key, compacted_ts)) {
+                compacted_lifetime_histogram_->inc(log_cache_timestamp - compacted_ts);
+                compacted_at_.erase(key);
             }
             invalidate_blocks += 1;
             loc.seg->blocks[loc.idx].valid = false;
@@ -159,20 +260,36 @@ void LogCache::invalidate(long key, int lba_sz) {
                 assert(false);
         }
         mapping.erase(key);
+        if (!partial_sectors_.empty()) partial_sectors_.erase(key);
     }
     else
     {
-        if (evicted_timestamp.find(key) != evicted_timestamp.end()) {
-            reinsert_blocks++;
-            print_objects("reinsert", log_cache_timestamp - evicted_timestamp[key]);
+        uint64_t evicted_ts;
+        if (evicted_timestamp.get(key, evicted_ts)) {
+            reinsert_blocks += evicted_timestamp.count_weight();
+            print_objects("reinsert", log_cache_timestamp - evicted_ts);
             evicted_timestamp.erase(key);
         }
-        _invalidate_cold_block(key * cache_block_size,
-                                lba_sz,
-                                OP_TYPE::TRIM);
+        if (trim_cold) {
+            _invalidate_cold_block(key * cache_block_size,
+                                    lba_sz,
+                                    OP_TYPE::TRIM);
+        } else {
+            ++cold_trims_deferred_;
+        }
     }
 }
 
+// invalidate() 와 달리 cache 에 없는 block 은 reinsert 로 세지 않는다 (위 tier 가 받은 write 라 이 cache 로의 재삽입이 아님)
+void LogCache::trim(long key, int lba_sz) {
+    if (exists(key)) {
+        invalidate(key, lba_sz);
+        return;
+    }
+    evicted_timestamp.erase(key);
+    _invalidate_cold_block(key * cache_block_size, lba_sz, OP_TYPE::TRIM);
+}
+
 void LogCache::evict_policy_add(LogCacheSegment *s) {
     evictor->add(s, log_cache_timestamp);
     if (compactor) {
@@ -194,10 +311,97 @@ void LogCache::evict_policy_update(LogCacheSegment *s) {
     }
 }
 
+uint64_t LogCache::ghost_shadow_evict_count(std::size_t i) const {
+    return i < ghost_cache.shadowCount() ? ghost_cache.shadowEvictCount(i) : ghost_cache.evictCount();
+}
+
+/* ── Multi-capacity ghost 제어 ──────────────────────────────
+ * ghost(+r) 의 eviction ratio 는 valid rate 를 r 만큼 올렸을 때의 eviction 비용이다.
+ * valid rate 를 내리는 쪽(-r)은 ghost 로 관측할 수 없으므로 현재 값을 기준으로 대칭 외삽한다.
+ * compaction 쪽은 GC victim 실측으로 만든 utilization 별 곡선(CompactionCurve)으로 cur±r 에서의
+ * 변화량을 더한다: 올릴수록 victim 이 꽉 차 복사가 가파르게 늘어난다.
+ * cost = compaction + periodic_ratio * eviction 이 가장 작은 후보로 target 을 옮긴다. */
+void LogCache::periodic_ghost_shadow() {
+    if (log_cache_timestamp % std::max<uint64_t>(1, segment_size_blocks / 4) == 0) {
+        compaction_ratio.updateFromCumulative(log_cache_timestamp, compacted_blocks);
+        eviction_ratio.updateFromCumulative(log_cache_timestamp, evicted_blocks);
+        for (std::size_t i = 0; i < ghost_shadow_eviction_ratio_.size(); ++i) {
+            ghost_shadow_eviction_ratio_[i].updateFromCumulative(log_cache_timestamp, ghost_shadow_evict_count(i));
+        }
+    }
+    if (log_cache_timestamp % (segment_size_blocks * 8) != 0) return;
+    if (!compaction_ratio.has_value() || !eviction_ratio.has_value()) return;
+    for (const auto& r : ghost_shadow_eviction_ratio_) {
+        if (!r.has_value()) return;
+    }
+
+    double cur = (double)global_valid_blocks / total_cache_block_count;
+    double c0 = compaction_ratio.value();
+    double e0 = eviction_ratio.value();
+    double best_delta = 0.0;
+    double best_cost = c0 + periodic_ratio_ * e0;
+    for (std::size_t i = 0; i < ghost_shadow_ratios_.size(); ++i) {
+        double r = ghost_shadow_ratios_[i];
+        double e_up = std::min(e0, ghost_shadow_eviction_ratio_[i].value());
+        double up_cost   = std::max(0.0, c0 + compaction_curve_.delta(cur, cur + r)) + periodic_ratio_ * e_up;
+        double down_cost = std::max(0.0, c0 + compaction_curve_.delta(cur, cur - r)) + periodic_ratio_ * (2 * e0 - e_up);
+        if (cur + r <= valid_blk_rate_hard_limit && up_cost < best_cost) {
+            best_cost = up_cost;
+            best_delta = r;
+        }
+        if (cur - r >= 0.0 && down_cost < best_cost) {
+            best_cost = down_cost;
+            best_delta = -r;
+        }
+    }
+    target_valid_blk_rate = std::min(valid_blk_rate_hard_limit, std::max(0.0, cur + best_delta));
+    printf("periodic_shadow: ts=%lu cur=%.4f compact=%.6f evict=%.6f delta=%+.3f target=%.4f\n",
+           log_cache_timestamp, cur, c0, e0, best_delta, target_valid_blk_rate);
+}
+
+/* ── --valid_mpc: step(기본 10 GB) 마다 delta 를 넣고 horizon DP 로 target 결정 ── */
+void LogCache::periodic_mpc() {
+    if (log_cache_timestamp % mpc_step_blocks_ != 0) return;
+    double cur = (double)global_valid_blocks / total_cache_block_count;
+    std::vector<uint64_t> shadow_evicted(ghost_shadow_ratios_.size());
+    for (std::size_t i = 0; i < shadow_evicted.size(); ++i) shadow_evicted[i] = ghost_shadow_evict_count(i);
+    valid_mpc_->step(cur, compacted_blocks, evicted_blocks, shadow_evicted);
+    target_valid_blk_rate = valid_mpc_->decide(cur, target_valid_blk_rate);
+}
+
+void LogCache::apply_gc_layout() {
+    GcStreamTuner::Layout layout;
+    if (!gc_tuner_->poll(layout)) return;
+    int old_streams = stream_policy->getNumGcStreams();
+    if (stream_policy->SetGcLayout(layout.gc_streams, layout.granularity)) {
+        printf("gc_model: ts=%lu gc_streams %d -> %d, interval=%lu blocks, predicted WAF=%.4f\n",
+               log_cache_timestamp, old_streams, layout.gc_streams, layout.granularity, layout.waf);
+        // 줄어든 stream 의 열린 GC segment 는 더 채워지지 않으니 닫아서 victim 후보로 돌린다
+        const int first_removed = Segment::GC_STREAM_START + stream_policy->getNumGcStreams();
+        for (auto it = gc_active_seg.begin(); it != gc_active_seg.end(); ) {
+            if (it->first >= first_removed) {
+                dummy_fill_segment(it->second);
+                it = gc_active_seg.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
 void LogCache::periodic() {
+    if (gc_tuner_ && log_cache_timestamp % std::max<uint64_t>(1, segment_size_blocks / 4) == 0) {
+        apply_gc_layout();
+    }
 #if 1
-    if (is_ghost_cache){
-        if (log_cache_timestamp % (segment_size_blocks/4) == 0) {
+    if (valid_mpc_) {
+        periodic_mpc();
+    }
+    else if (is_ghost_cache && !ghost_shadow_ratios_.empty()) {
+        periodic_ghost_shadow();
+    }
+    else if (is_ghost_cache){
+        if (log_cache_timestamp % std::max<uint64_t>(1, segment_size_blocks / 4) == 0) {
             compaction_ratio.updateFromCumulative(log_cache_timestamp, compacted_blocks);
             eviction_ratio.updateFromCumulative(log_cache_timestamp, evicted_blocks);
             uint64_t evicted_in_ghost = ghost_cache.evictCount();
@@ -218,7 +422,7 @@ void LogCache::periodic() {
     }
 #elif 0
     /* ── A/B feedback: net free segs vs compaction cost ── */
-    if (log_cache_timestamp % (segment_size_blocks / 4) == 0) {
+    if (log_cache_timestamp % std::max<uint64_t>(1, segment_size_blocks / 4) == 0) {
         uint64_t A = gc_victim_count - gc_active_alloc_count_;
         net_free_seg_ratio_.updateFromCumulative(log_cache_timestamp, A * segment_size_blocks);
         if (net_free_seg_ratio_.has_value()) {
@@ -252,7 +456,7 @@ void LogCache::periodic() {
 /*
 void LogCache::periodic() {
     if (is_ghost_cache){
-        if (log_cache_timestamp % (segment_size_blocks / 4) == 0) {
+        if (log_cache_timestamp % std::max<uint64_t>(1, segment_size_blocks / 4) == 0) {
 #ifdef GHOST_CACHE
             compaction_ratio.updateFromCumulative(log_cache_timestamp, compacted_blocks);
             eviction_ratio.updateFromCumulative(log_cache_timestamp, evicted_blocks);
@@ -332,6 +536,13 @@ void LogCache::batch_insert(int stream_id,
 {
     if (op_type == OP_TYPE::READ || newBlocks.empty())
         return;                          // 요구사항 ③ – read 무시
+
+    /* 0) 순차 stream 은 cold tier 로 바로, 양 끝의 부분 block 만 cache 로 */
+    std::map<long,int> rest;
+    const std::map<long,int>& blocks =
+        (bypass_blocks_threshold > 0 && bypass_sequential(newBlocks, rest)) ? rest : newBlocks;
+    if (blocks.empty())
+        return;
     
     /* 1) 스트림별 active segment 확보 */
     LogCacheSegment* seg = nullptr;
@@ -340,13 +551,20 @@ void LogCache::batch_insert(int stream_id,
     }
     
     /* 2) 블록 단위 append */
-    for (auto [key, lba_sz] : newBlocks)
+    for (auto [key, lba_sz] : blocks)
     {
+        const bool ghost_hit = is_ghost_cache && ghost_cache.access(key);
+        if (admission_ && !admission_->admit(key, {log_cache_timestamp, gc_victim_seen_ ? gc_age_threshold_ : 0,
+                                                   admission_ghost_.access(key)})) {
+            bypass_block(key, lba_sz);
+            continue;
+        }
         // every 32 MB, call some code.
         periodic();
-        bool ghost_hit = ghost_cache.access(key);
-        ++ghost_access_total;
-        if (!ghost_hit) ++ghost_miss_total;
+        if (is_ghost_cache) {
+            ++ghost_access_total;
+            if (!ghost_hit) ++ghost_miss_total;
+        }
         if (stream_policy) {
             seg = get_segment_with_stream_policy(false, key);
         }
@@ -362,15 +580,36 @@ void LogCache::batch_insert(int stream_id,
         }
         
         record_rewrite(key);
-        invalidate(key, lba_sz);
+        uint64_t sectors = full_sector_mask_;
+        if (g_sector_valid) {
+            const uint64_t written = sector_mask(key, lba_sz);
+            const bool cached = exists(key);
+            const uint64_t old = cached ? cached_sectors(key) : 0;
+            if (written != full_sector_mask_) ++partial_write_blocks_;
+            if (old & ~written) {
+                ++rmw_merges_;
+                rmw_cache_read_bytes_ += __builtin_popcountll(old & ~written) * static_cast<uint64_t>(sector_size_);
+            }
+            sectors = old | written;
+            invalidate(key, lba_sz, /*trim_cold=*/cached || written == full_sector_mask_);
+            if (cached && old != full_sector_mask_ && sectors == full_sector_mask_) {
+                // 합쳐서 다 채워졌으니 미뤄 둔 cold copy 는 이제 필요 없다
+                _invalidate_cold_block(static_cast<uint64_t>(key) * cache_block_size, cache_block_size, OP_TYPE::TRIM);
+            }
+        } else {
+            invalidate(key, lba_sz);
+        }
 
         seg->blocks[seg->write_ptr] = { key, true, log_cache_timestamp };
         mapping[key]                = { seg, seg->write_ptr };
+        if (sectors != full_sector_mask_) partial_sectors_[key] = sectors;
+        if (cache_device_) cache_device_->write(seg->id, seg->write_ptr);
 
         ++seg->write_ptr;
         ++seg->valid_cnt;
         ++global_valid_blocks;
         ++log_cache_timestamp; // increment timestamp for each block
+        if (gc_tuner_) gc_tuner_->on_host_write(key);
         if (stream_policy) {
             stream_policy->Append(key, log_cache_timestamp, reinterpret_cast<void*>(seg->valid_cnt));
         }
@@ -380,7 +619,7 @@ void LogCache::batch_insert(int stream_id,
         }
 
         /* proactive GC: 1 segment per batch, like async impl */
-        if (log_cache_timestamp % (segment_size_blocks / 2) == 0 && free_pool.size() <= 10) {
+        if (log_cache_timestamp % std::max<uint64_t>(1, segment_size_blocks / 2) == 0 && free_pool.size() <= 10) {
             check_and_evict_if_needed(1);
         }
     }
@@ -392,6 +631,85 @@ void LogCache::batch_insert(int stream_id,
     
 }
 
+/* 요청이 bypass_blocks_threshold 이상 이어진 순차 stream 에 속하면 꽉 찬 block 들을 cold tier 에
+ * bypass_blocks_threshold 단위로 정렬된 chunk 로 바로 쓰고 cache 에 있던 copy 는 무효화한다.
+ * 부분 block (요청 양 끝) 은 rest 로 돌려줘서 평소처럼 cache 에 넣는다. */
+bool LogCache::bypass_sequential(const std::map<long,int>& newBlocks, std::map<long,int>& rest)
+{
+    long first = newBlocks.begin()->first;
+    long last  = newBlocks.rbegin()->first;
+    if (static_cast<std::size_t>(last - first + 1) != newBlocks.size())
+        return false;                    // spatial sampling 등으로 연속이 아니면 판단하지 않음
+    uint64_t n = newBlocks.size();
+    uint64_t run = seq_detector_.observe(req_volume, first, n);
+    if (run < bypass_blocks_threshold)
+        return false;
+    if (run - n < bypass_blocks_threshold)
+        ++bypass_streams_;
+
+    long lo = first, hi = last + 1;      // 꽉 찬 block 구간 [lo, hi)
+    if (newBlocks.begin()->second < cache_block_size) {
+        rest.insert(*newBlocks.begin());
+        ++lo;
+    }
+    if (hi > lo && newBlocks.rbegin()->second < cache_block_size) {
+        rest.insert(*newBlocks.rbegin());
+        --hi;
+    }
+
+    for (long key = lo; key < hi; ++key) {
+        if (exists(key)) {
+            invalidate(key, cache_block_size);
+            ++bypass_invalidated_;
+        }
+        evicted_timestamp.erase(key);
+    }
+    const long chunk = static_cast<long>(bypass_blocks_threshold);
+    for (long b = lo; b < hi;) {
+        long end = std::min(hi, (b / chunk + 1) * chunk);
+        _evict_one_block(static_cast<uint64_t>(b) * cache_block_size, (end - b) * cache_block_size, OP_TYPE::WRITE);
+        b = end;
+    }
+    for (long key = lo; key < hi; ++key) note_bypassed_write(key);
+    bypass_blocks_ += hi - lo;
+    return true;
+}
+
+/* cache 를 거치지 않고 cold tier 로 간 host write 도 stream policy 의 write 이력 (SepBIT lifespan, LifetimeStream 학습 등) 에 남긴다.
+ * segment 에 들어가지 않으니 Classify 는 하지 않고, Append 의 valid 수 인자는 hot host stream (0) 의 active segment 것을 쓴다.
+ * cache timestamp 는 cache 에 쓴 block 만 세므로 올리지 않는다. */
+void LogCache::note_bypassed_write(long key)
+{
+    if (!stream_policy)
+        return;
+    auto it = active_seg.find(0);
+    uint64_t valid = it != active_seg.end() ? static_cast<uint64_t>(it->second->valid_cnt) : 0;
+    stream_policy->Append(key, log_cache_timestamp, reinterpret_cast<void*>(valid));
+}
+
+/* admission 이 거절한 block: cache copy 를 무효화하고 cold tier 로 바로 쓴다.
+ * evict 된 block 처럼 admission ghost 에 넣어 두어 곧 다시 쓰이면 admission 이 받아들이게 한다. */
+void LogCache::bypass_block(long key, int lba_sz)
+{
+    if (g_sector_valid) {
+        // cold tier 에는 block 을 통째로 쓴다: cache copy 의 남은 sector 와 cold tier 의 나머지로 채운다
+        const uint64_t written = sector_mask(key, lba_sz);
+        const uint64_t old = exists(key) ? cached_sectors(key) : 0;
+        if (old & ~written) {
+            ++rmw_merges_;
+            rmw_cache_read_bytes_ += __builtin_popcountll(old & ~written) * static_cast<uint64_t>(sector_size_);
+        }
+        fill_from_cold(key, old | written);
+        lba_sz = cache_block_size;
+    }
+    if (exists(key))
+        invalidate(key, lba_sz);
+    evicted_timestamp.erase(key);
+    admission_ghost_.push(key);
+    _evict_one_block(static_cast<uint64_t>(key) * cache_block_size, lba_sz, OP_TYPE::WRITE);
+    note_bypassed_write(key);
+}
+
 /* ------------------------------------------------------------------ */
 /* helpers                                                            */
 /* ------------------------------------------------------------------ */
@@ -506,8 +824,8 @@ LogCacheSegment* LogCache::get_segment_to_active_stream(bool gc, int stream_id,
     return seg;
 }
 
-extern uint64_t g_threshold;
-extern uint64_t g_timestamp;
+extern thread_local uint64_t g_threshold;
+extern thread_local uint64_t g_timestamp;
 void LogCache::check_and_evict_if_needed(int max_victims)
 {
     const std::size_t low_water =
@@ -524,8 +842,7 @@ void LogCache::check_and_evict_if_needed(int max_victims)
     //bool first_compact = true;
     std::list<Segment *> segment_list;
     g_timestamp = log_cache_timestamp;
-    static uint64_t threshold = (cfg_.segment_bytes / cache_block_size) *static_cast<std::size_t>(std::ceil(total_segments *
-                                           (1 - cfg_.free_ratio_low) * (1 + additional_free_blks_ratio_by_gc)));
+    uint64_t& threshold = gc_age_threshold_;
     g_threshold = threshold + cfg_.segment_bytes / cache_block_size;
    // printf("%d\n", low_water);
     int processed = 0;
@@ -648,6 +965,7 @@ void LogCache::check_and_evict_if_needed(int max_victims)
             }
         }
         ++processed;
+        gc_victim_seen_ = true;
     }
 }
 
@@ -667,6 +985,7 @@ bool LogCache::is_cache_filled() {
 void LogCache::reset_segment(LogCacheSegment* s)
 {
        // erase old segment
+    if (cache_device_) cache_device_->trim_segment(s->id);
     s->valid_cnt = 0;
     s->write_ptr = 0;
     free_pool.push_back(s);
@@ -694,6 +1013,7 @@ Segment* LogCache::evict_and_compaction(LogCacheSegment* s, uint64_t threshold,
 {
     LogCacheSegment* target_seg = nullptr;
     int evicted_blocks_for_victim = 0, compacted_blocks_for_victim = 0;
+    const double util_at_victim = (double)global_valid_blocks / total_cache_block_count;
     if (!stream_policy) {
         target_seg = get_segment_to_active_stream(true, gc_stream_id);
     }
@@ -701,21 +1021,23 @@ Segment* LogCache::evict_and_compaction(LogCacheSegment* s, uint64_t threshold,
     {
         auto &blk = s->blocks[i];
         if (!blk.valid) continue;
-        if (threshold > 0 && log_cache_timestamp - blk.create_timestamp >= threshold) { 
+        IStream::EvictHint hint = stream_policy ? stream_policy->GetEvictHint(blk.key, log_cache_timestamp)
+                                                : IStream::EvictHint::NONE;
+        if (hint == IStream::EvictHint::EVICT ||
+            (hint == IStream::EvictHint::NONE && threshold > 0 && log_cache_timestamp - blk.create_timestamp >= threshold)) {
             if (is_ghost_cache) {
                 ghost_cache.push(blk.key);
             }
+            if (admission_) admission_ghost_.push(blk.key);
             print_objects("evict", log_cache_timestamp - blk.create_timestamp);
             evicted_blocks += cfg_.evicted_blk_size;
             evicted_ages_histogram->inc(log_cache_timestamp - blk.create_timestamp);
-            {
-                auto cit = compacted_at_.find(blk.key);
-                if (cit != compacted_at_.end()) {
-                    compacted_lifetime_histogram_->inc(log_cache_timestamp - cit->second);
-                    compacted_at_.erase(cit);
-                }
+            uint64_t compacted_ts;
+            if (compacted_at_.get(blk.key, compacted_ts)) {
+                compacted_lifetime_histogram_->inc(log_cache_timestamp - compacted_ts);
+                compacted_at_.erase(blk.key);
             }
-            evicted_timestamp[blk.key] = log_cache_timestamp;
+            evicted_timestamp.set(blk.key, log_cache_timestamp);
             evicted_blocks_for_victim += 1;
             // map erase and blk valid false is done in this function
             evict(blk);
@@ -743,20 +1065,20 @@ Segment* LogCache::evict_and_compaction(LogCacheSegment* s, uint64_t threshold,
         print_objects("compact", log_cache_timestamp - blk.create_timestamp);
         target_seg->blocks[target_seg->write_ptr] = blk; // copy valid block
         mapping[blk.key] = { target_seg, target_seg->write_ptr };
+        if (cache_device_) cache_device_->write(target_seg->id, target_seg->write_ptr);
         ++target_seg->write_ptr;
         ++target_seg->valid_cnt;
         ++compacted_blocks;
         compacted_blocks_for_victim += 1;
-        {
-            auto cit = compacted_at_.find(blk.key);
-            if (cit != compacted_at_.end()) {
-                compacted_lifetime_histogram_->inc(log_cache_timestamp - cit->second);
-            }
-            compacted_at_[blk.key] = log_cache_timestamp;
+        uint64_t compacted_ts;
+        if (compacted_at_.get(blk.key, compacted_ts)) {
+            compacted_lifetime_histogram_->inc(log_cache_timestamp - compacted_ts);
         }
+        compacted_at_.set(blk.key, log_cache_timestamp);
 
         blk.valid = false;
     }
+    flush_evict_batch();
     assert((target_seg == nullptr && compacted_blocks_for_victim == 0) || target_seg);
     /*if (target_seg) {
         printf("Compaction and Evict: %lu blocks moved from segment %p to segment %p, free_pool_size %ld, valid ratio %.4f age %lu target_seg_write_ptr %lu target_create_timestamp %lu threshold %lu stream_id %d\n", 
@@ -766,6 +1088,9 @@ Segment* LogCache::evict_and_compaction(LogCacheSegment* s, uint64_t threshold,
         printf("Evict: %lu blocks free_pool_size %ld, valid ratio %.4f age %lu, create_time %lu \n", 
         s->valid_cnt, free_pool.size(), global_valid_blocks / (float)total_cache_block_count, log_cache_timestamp - s->create_timestamp, s->create_timestamp);
     }*/
+    if (!ghost_shadow_ratios_.empty()) {
+        compaction_curve_.record(util_at_victim, (double)compacted_blocks_for_victim / s->blocks.size());
+    }
     reset_segment(s);
     evicted_blocks_histogram->inc(evicted_blocks_for_victim);
     compacted_blocks_histogram->inc(compacted_blocks_for_victim);
@@ -787,23 +1112,23 @@ void LogCache::evict_segment(LogCacheSegment* s)
         if (is_ghost_cache) {
             ghost_cache.push(blk.key);
         }
+        if (admission_) admission_ghost_.push(blk.key);
         print_objects("evict", log_cache_timestamp - blk.create_timestamp);
         evicted_ages_histogram->inc(log_cache_timestamp - blk.create_timestamp);
-        {
-            auto cit = compacted_at_.find(blk.key);
-            if (cit != compacted_at_.end()) {
-                compacted_lifetime_histogram_->inc(log_cache_timestamp - cit->second);
-                compacted_at_.erase(cit);
-            }
+        uint64_t compacted_ts;
+        if (compacted_at_.get(blk.key, compacted_ts)) {
+            compacted_lifetime_histogram_->inc(log_cache_timestamp - compacted_ts);
+            compacted_at_.erase(blk.key);
         }
         evicted_blocks += cfg_.evicted_blk_size;
         evicted_blocks_for_victim += 1;
-        evicted_timestamp[blk.key] = log_cache_timestamp;
+        evicted_timestamp.set(blk.key, log_cache_timestamp);
 
         // map erase and blk valid false is done in this function
         evict(blk);
         
     }
+    flush_evict_batch();
   //  printf("Evict: %lu blocks free_pool_size %ld, valid ratio %.4f age %lu, create_time %lu \n",
   //      s->valid_cnt, free_pool.size(), global_valid_blocks / (float)total_cache_block_count, log_cache_timestamp - s->create_timestamp, s->create_timestamp);
     reset_segment(s);
@@ -818,6 +1143,7 @@ void LogCache::evict(LogCacheSegment::Block &blk) {
     
     //const uint64_t DUMMY_VALUE = 0;
     uint64_t old_key = blk.key;
+    if (admission_) admission_->on_evict(old_key, log_cache_timestamp);
     int EVICTED_BLOCK_SIZE = cfg_.evicted_blk_size; // 16 blocks, 64k
     int evicted_blocks_per_evict = 0;
 
@@ -833,6 +1159,10 @@ void LogCache::evict(LogCacheSegment::Block &blk) {
             record_inv_time(index_64k);
             auto &other_blk = it->second.seg->blocks[it->second.idx];
             other_blk.valid = false;
+            if (g_sector_valid) {
+                fill_from_cold(index_64k, cached_sectors(index_64k));
+                partial_sectors_.erase(index_64k);
+            }
             mapping.erase(index_64k);
             global_valid_blocks -= 1;
             evicted_blocks_per_evict += 1;
@@ -842,7 +1172,15 @@ void LogCache::evict(LogCacheSegment::Block &blk) {
         }
     }
     evicted_cache_blocks_per_evict->inc(evicted_blocks_per_evict);
-    _evict_one_block(start_index_64k  * cache_block_size /* 64k aligend */, cache_block_size * EVICTED_BLOCK_SIZE /* 64k */, OP_TYPE::WRITE);
+    if (evict_batcher_) {
+        evict_batcher_->add(start_index_64k, EVICTED_BLOCK_SIZE);   // victim 을 다 비운 뒤 flush_evict_batch
+    } else {
+        _evict_one_block(start_index_64k  * cache_block_size /* 64k aligend */, cache_block_size * EVICTED_BLOCK_SIZE /* 64k */, OP_TYPE::WRITE);
+    }
+    if (g_sector_valid) {
+        fill_from_cold(blk.key, cached_sectors(blk.key));
+        partial_sectors_.erase(blk.key);
+    }
     record_inv_time(blk.key);
     record_lifetime(log_cache_timestamp - blk.create_timestamp, false);
     mapping.erase(blk.key);
@@ -850,6 +1188,57 @@ void LogCache::evict(LogCacheSegment::Block &blk) {
     global_valid_blocks -= 1;
 }
 
+void LogCache::flush_evict_batch() {
+    if (!evict_batcher_) return;
+    const int stream_id = g_evict_stream ? EVICT_STREAM_ID : 0;
+    evict_batcher_->flush([&](uint64_t start_key, uint64_t blocks) {
+        _evict_one_block(start_key * cache_block_size, static_cast<int>(blocks * cache_block_size), OP_TYPE::WRITE, stream_id);
+    });
+}
+
+/* block key 안에서 이번 host 요청이 덮는 sector. 요청 범위를 모르면 (write buffer destage, 아래 tier) 앞에서부터 lba_sz */
+uint64_t LogCache::sector_mask(long key, int lba_sz) const
+{
+    const long long blk_start = static_cast<long long>(key) * cache_block_size;
+    const long long blk_end = blk_start + cache_block_size;
+    long long s = 0, e = std::min(lba_sz, cache_block_size);
+    if (req_offset >= 0 && req_offset < blk_end && req_offset + req_size > blk_start) {
+        s = std::max(req_offset, blk_start) - blk_start;
+        e = std::min(req_offset + req_size, blk_end) - blk_start;
+    }
+    const long long first = s / sector_size_;
+    const long long last = (e + sector_size_ - 1) / sector_size_;   // [first, last)
+    const long long n = last - first;
+    if (n <= 0) return 0;
+    return (n >= 64 ? ~0ull : ((1ull << n) - 1) << first) & full_sector_mask_;
+}
+
+uint64_t LogCache::cached_sectors(long key) const
+{
+    auto it = partial_sectors_.find(key);
+    return it == partial_sectors_.end() ? full_sector_mask_ : it->second;
+}
+
+/* 부분 block 을 cold tier 에 쓰기 전에 빠진 sector 를 cold tier 에서 읽는다 */
+void LogCache::fill_from_cold(long key, uint64_t mask)
+{
+    const uint64_t missing = full_sector_mask_ & ~mask;
+    if (!missing) return;
+    const uint64_t lba = static_cast<uint64_t>(key) * cache_block_size;
+    if (!evict_sink && !ftl.IsMapped(lba)) return;   // 한 번도 안 쓰인 영역 (아래 tier 가 있으면 있다고 본다)
+    ++rmw_fill_blocks_;
+    rmw_cold_read_bytes_ += __builtin_popcountll(missing) * static_cast<uint64_t>(sector_size_);
+}
+
+void LogCache::print_sector_stats(FILE* fp) const
+{
+    if (!fp) return;
+    fprintf(fp, "sector_valid sector_size: %d partial_write_blocks: %lu rmw_merges: %lu rmw_cache_read_bytes: %lu "
+                "rmw_fill_blocks: %lu rmw_cold_read_bytes: %lu cold_trims_deferred: %lu partial_blocks_cached: %zu\n",
+            sector_size_, partial_write_blocks_, rmw_merges_, rmw_cache_read_bytes_,
+            rmw_fill_blocks_, rmw_cold_read_bytes_, cold_trims_deferred_, partial_sectors_.size());
+}
+
 void LogCache::print_objects(std::string prefix, uint64_t value) {
     //fprintf(fp_object, "%s: %lu\n", prefix.c_str(), value);
 }
@@ -898,16 +1287,14 @@ void LogCache::print_lifetime_results()
 
 void LogCache::record_rewrite(long key)
 {
-    if (!lifetime_tracking_active_) return;
-    auto it = rewrite_last_ts_.find(key);
-    if (it != rewrite_last_ts_.end()) {
-        uint64_t interval = log_cache_timestamp - it->second;
+    if (!lifetime_tracking_active_ || !rewrite_last_ts_.tracked(key)) return;
+    uint64_t last_ts;
+    if (rewrite_last_ts_.get(key, last_ts)) {
+        uint64_t interval = log_cache_timestamp - last_ts;
         uint64_t bucket   = interval / LIFETIME_BUCKET_WIDTH;
-        rewrite_hist_[bucket]++;
-        it->second = log_cache_timestamp;
-    } else {
-        rewrite_last_ts_[key] = log_cache_timestamp;
+        rewrite_hist_[bucket] += rewrite_last_ts_.count_weight();
     }
+    rewrite_last_ts_.set(key, log_cache_timestamp);
 }
 
 void LogCache::print_rewrite_results()
@@ -1046,22 +1433,23 @@ void LogCache::print_segment_age_scatter()
 }
 
 void LogCache::print_stats() {
-    static uint64_t written_window_bytes = cfg_.print_stats_interval;
-    static uint64_t next_written_bytes = cfg_.segment_bytes;
-    if ((uint64_t)write_size_to_cache >= next_written_bytes) {
+    if ((uint64_t)write_size_to_cache >= next_stats_written_bytes_) {
         const std::string& prefix = stats_prefix();
         const char* prefix_cstr = prefix.empty() ? "LOG_CACHE" : prefix.c_str();
         double avg_victim_valid_ratio = (gc_victim_count > 0) ? gc_victim_valid_ratio_sum / gc_victim_count : 0.0;
-        fprintf (fp_stats, "%s invalidate_blocks: %lu compacted_blocks: %lu global_valid_blocks: %lu write_size_to_cache: %llu evicted_blocks: %llu write_hit_size: %llu total_cache_size: %lu reinsert_blocks: %lu read_blocks_in_partial_write %lu evicted_in_ghost: %zu ghost_compacted_blocks: %lu gc_victim_avg_valid_ratio: %.6f gc_victim_count: %lu dummy_fill_segments: %lu\n",
-                prefix_cstr, invalidate_blocks, compacted_blocks, global_valid_blocks, write_size_to_cache, evicted_blocks, write_hit_size, total_capacity_bytes, reinsert_blocks, read_blocks_in_partial_write, ghost_cache.evictCount(), ghost_compacted_blocks, avg_victim_valid_ratio, gc_victim_count, dummy_fill_segment_count);
+        fprintf (fp_stats, "%s invalidate_blocks: %lu compacted_blocks: %lu global_valid_blocks: %lu write_size_to_cache: %llu evicted_blocks: %llu write_hit_size: %llu total_cache_size: %lu reinsert_blocks: %lu read_blocks_in_partial_write %lu evicted_in_ghost: %zu ghost_compacted_blocks: %lu gc_victim_avg_valid_ratio: %.6f gc_victim_count: %lu dummy_fill_segments: %lu bypass_blocks: %lu bypass_streams: %lu bypass_invalidated: %lu\n",
+                prefix_cstr, invalidate_blocks, compacted_blocks, global_valid_blocks, write_size_to_cache, evicted_blocks, write_hit_size, total_capacity_bytes, reinsert_blocks, read_blocks_in_partial_write, ghost_cache.evictCount(), ghost_compacted_blocks, avg_victim_valid_ratio, gc_victim_count, dummy_fill_segment_count, bypass_blocks_, bypass_streams_, bypass_invalidated_);
+        if (admission_) admission_->print_stats(fp_stats);
+        if (cache_device_) cache_device_->print_stats(fp_stats);
         fflush(fp_stats);
-        next_written_bytes += written_window_bytes;
+        next_stats_written_bytes_ += cfg_.print_stats_interval;
     }
 }
 
 void LogCache::take_inv_snapshot()
 {
     inv_snapshot_taken_ = true;
+    if (!inv_snap_block_seg_idx_.enabled()) return;   // --track_inv_snapshot off: snapshot 생략
     inv_snapshot_ts_ = log_cache_timestamp;
 
     size_t seg_idx = 0;
@@ -1096,7 +1484,7 @@ void LogCache::take_inv_snapshot()
 
         for (size_t i = 0; i < seg->write_ptr; i++) {
             if (!seg->blocks[i].valid) continue;
-            inv_snap_block_seg_idx_[seg->blocks[i].key] = seg_idx;
+            inv_snap_block_seg_idx_.set(seg->blocks[i].key, seg_idx);
         }
         seg_idx++;
     }
@@ -1109,11 +1497,14 @@ void LogCache::take_inv_snapshot()
 void LogCache::record_inv_time(long key)
 {
     if (!inv_snapshot_taken_) return;
-    auto it = inv_snap_block_seg_idx_.find(key);
-    if (it != inv_snap_block_seg_idx_.end()) {
-        uint64_t inv_time = log_cache_timestamp - inv_snapshot_ts_;
-        inv_snap_inv_times_[it->second].push_back(inv_time);
-        inv_snap_block_seg_idx_.erase(it);
+    uint64_t seg_idx;
+    if (inv_snap_block_seg_idx_.get(key, seg_idx)) {
+        double inv_time = static_cast<double>(log_cache_timestamp - inv_snapshot_ts_);
+        auto& st = inv_snap_inv_times_[seg_idx];
+        st.count  += 1;
+        st.sum    += inv_time;
+        st.sum_sq += inv_time * inv_time;
+        inv_snap_block_seg_idx_.erase(key);
     }
 }
 
@@ -1147,20 +1538,17 @@ void LogCache::print_inv_time_scatter()
         auto& info = inv_snap_segs_[i];
         auto& times = inv_snap_inv_times_[i];
 
-        uint64_t survived = info.valid_count - times.size();
+        // sampled 모드면 추적한 block 하나가 count_weight() 개를 대표
+        uint64_t n = std::min<uint64_t>(info.valid_count,
+                                        times.count * inv_snap_block_seg_idx_.count_weight());
+        uint64_t survived = info.valid_count - n;
         total_survived += survived;
 
         double inv_mean = 0.0, inv_stddev = 0.0;
-        uint64_t n = times.size();
-        if (n > 0) {
-            double sum = 0.0, sum_sq = 0.0;
-            for (auto t : times) {
-                sum += (double)t;
-                sum_sq += (double)t * t;
-            }
-            inv_mean = sum / n;
-            if (n > 1) {
-                double var = (sum_sq - sum * sum / n) / (n - 1);
+        if (times.count > 0) {
+            inv_mean = times.sum / times.count;
+            if (times.count > 1) {
+                double var = (times.sum_sq - times.sum * times.sum / times.count) / (times.count - 1);
                 inv_stddev = (var > 0.0) ? std::sqrt(var) : 0.0;
             }
         }
@@ -7,6 +7,13 @@
 #include "histogram.h"
 #include "emwa_ratio.h"
 #include "ghost_cache.h"
+#include "valid_mpc.h"
+#include "gc_stream_tuner.h"
+#include "key_table.h"
+#include "seq_detector.h"
+#include "admission.h"
+#include "cache_device.h"
+#include "evict_batcher.h"
 
 #include <unordered_map>
 #include <deque>
@@ -31,6 +38,17 @@ struct Config
 
 #define GHOST_CACHE 1
 
+// miniature simulation(mini_sim.cpp)에서 spatial sampling rate 만큼 segment 크기를 줄이는 배율 (thread 별)
+extern thread_local double g_segment_scale;
+// cache_sim --bypass_blocks: 이 길이(block) 이상 이어진 순차 write stream 은 cache 를 거치지 않는다 (0 = off)
+extern uint64_t g_bypass_blocks;
+// cache_sim --evict_batch: victim segment 의 eviction 을 LBA 순 run 으로 합쳐 cold tier 에 쓴다
+// --evict_stream: 그 run 들을 cold ftl 의 전용 stream (EVICT_STREAM_ID) 으로
+extern bool g_evict_batch;
+extern bool g_evict_stream;
+// cache_sim --sector_valid: block 안 sector (g_nand_geometry.sector_size) 단위 valid mask 와 부분 write 의 read-modify-write 모델
+extern bool g_sector_valid;
+
 class LogCache final : public ICache
 {
 public:
@@ -62,6 +80,9 @@ public:
     bool        exists(long key) override;
     void        touch(long, OP_TYPE) override {}              // no‑op
     std::size_t size() override { return mapping.size(); }
+    void        trim(long key, int lba_sz) override;   // 위 tier 의 새 write: 있으면 여기서 무효화, 없을 때만 아래로
+    uint64_t    gc_write_blocks() override { return compacted_blocks; }
+    bool        valid_mpc_enabled() override { return valid_mpc_ != nullptr; }
 
     /* 새로운 API – stream id 포함 */
     void batch_insert(int stream_id, const std::map<long,int>& newBlocks,
@@ -72,9 +93,13 @@ public:
     bool is_cache_filled() override;
     virtual void print_stats() override;
     void print_objects(std::string prefix, uint64_t value);
-    void invalidate(long key, int lba_sz);
+    void invalidate(long key, int lba_sz, bool trim_cold = true);
     void reset_segment(LogCacheSegment *seg);
     void dummy_fill_segment(LogCacheSegment* s);
+    bool bypass_sequential(const std::map<long,int>& newBlocks, std::map<long,int>& rest);
+    void note_bypassed_write(long key);
+    void bypass_block(long key, int lba_sz);
+    uint64_t get_compacted_blocks() const { return compacted_blocks; }
     //void do_evict_and_compaction_with_same_policy();
     
     
@@ -94,7 +119,7 @@ private:
     /* page lookup ********************************************************/
     struct Loc { LogCacheSegment* seg; std::size_t idx;};
     std::unordered_map<long, Loc>                mapping;
-    std::unordered_map<long, uint64_t>                evicted_timestamp; // for GC
+    KeyTable                                     evicted_timestamp; // evict 시각 (reinsert 통계)
 
     /* helpers ************************************************************/
     std::unique_ptr<EvictPolicy> evictor;
@@ -110,6 +135,8 @@ private:
     LogCacheSegment* get_segment_to_active_stream(bool gc, int stream, bool check_only = false);
     LogCacheSegment* get_segment_with_stream_policy(bool gc, uint64_t key, bool check_only = false);
     void periodic();
+    void periodic_ghost_shadow();
+    void periodic_mpc();
 
     /* trace(optional) *****************************************************/
     bool  cache_trace_;
@@ -133,6 +160,8 @@ private:
     uint64_t gc_victim_count = 0;
     double gc_victim_valid_ratio_sum = 0.0;
     uint64_t dummy_fill_segment_count = 0;
+    uint64_t next_stats_written_bytes_ = 0;
+    uint64_t gc_age_threshold_ = 0;        // check_and_evict_if_needed 의 eviction age threshold
 
     double target_valid_blk_rate = 0.0; // ratio of write to QLC
     double valid_blk_rate_hard_limit = 0.0;
@@ -145,14 +174,44 @@ private:
     std::unique_ptr<Histogram> evicted_ages_with_segment_histogram;
     std::unique_ptr<Histogram> compacted_ages_with_segment_histogram;
     std::unique_ptr<Histogram> evicted_cache_blocks_per_evict;
-    std::unordered_map<long, uint64_t> compacted_at_;
+    KeyTable compacted_at_;
     std::unique_ptr<Histogram> compacted_lifetime_histogram_;
     static const int HISTOGRAM_BUCKETS = 20;
+    // per-LBA side table 의 timestamp 해상도: 2^4 blocks (64 KiB), 32 bit 로 256 TB 까지
+    static constexpr unsigned SIDE_TABLE_TS_SHIFT = 4;
     static const uint64_t DEFAULT_HALF_LIFE_IN_BLOCKS = (262144 * 6) * 4;
     static constexpr double TCO_EVICTION_WEIGHT = 2.8;
     static const std::size_t TCO_HISTORY_SIZE = 4;
     bool is_ghost_cache = false;
-    uint64_t bypass_blocks_threshold = 128; // 128* 4k bytes = 512K bytes
+    bool gc_victim_seen_ = false;           // 첫 GC victim 처리 전에는 gc_age_threshold_ 가 초기 추정값이라 admission 에 안 넘긴다
+    uint64_t bypass_blocks_threshold = g_bypass_blocks; // 128* 4k bytes = 512K bytes 권장, 0 = off
+    SeqDetector seq_detector_;
+    uint64_t bypass_blocks_ = 0;           // cold tier 로 바로 간 block
+    uint64_t bypass_streams_ = 0;          // threshold 를 넘은 stream 수
+    uint64_t bypass_invalidated_ = 0;      // bypass 때 무효화한 cache copy
+    std::unique_ptr<IAdmission> admission_; // --admission, nullptr = 전부 admit
+    std::unique_ptr<CacheDevice> cache_device_; // --cache_ftl, nullptr = segment 가 erase block 에 딱 맞는다고 가정
+    std::unique_ptr<EvictBatcher> evict_batcher_; // --evict_batch, nullptr = block 마다 바로 cold tier 로
+    static constexpr int EVICT_STREAM_ID = 1;
+    void flush_evict_batch();
+
+    /* --sector_valid: 부분 block 은 valid sector mask 를 들고 있다 (없으면 전부 valid) *
+     *  - cache 에 있는 block 의 부분 overwrite: 안 덮인 valid sector 를 cache 에서 읽어 합친 block 을 append
+     *  - cache 에 없는 block 의 부분 write: cold tier 의 나머지 sector 를 살려 두려고 cold trim 을 미룬다
+     *  - 부분 block 을 cold tier 로 내보낼 때: 빠진 sector 를 cold tier 에서 읽어 채운다 (page 가 있을 때만) */
+    uint64_t sector_mask(long key, int lba_sz) const;
+    uint64_t cached_sectors(long key) const;
+    void     fill_from_cold(long key, uint64_t mask);
+    void     print_sector_stats(FILE* fp) const;
+    int      sector_size_ = 0;
+    uint64_t full_sector_mask_ = 0;
+    std::unordered_map<long, uint64_t> partial_sectors_;
+    uint64_t partial_write_blocks_ = 0;    // 일부 sector 만 쓴 host write block
+    uint64_t rmw_merges_ = 0;              // cache 의 옛 copy 와 합친 write
+    uint64_t rmw_cache_read_bytes_ = 0;
+    uint64_t rmw_fill_blocks_ = 0;         // 내보낼 때 cold tier 에서 채운 block
+    uint64_t rmw_cold_read_bytes_ = 0;
+    uint64_t cold_trims_deferred_ = 0;     // 부분 write 라서 cold copy 를 trim 하지 않은 block
     EwmaRatio compaction_ratio;
     EwmaRatio eviction_ratio;
     EwmaRatio eviction_ratio_in_ghost_cache;
@@ -160,9 +219,23 @@ private:
     double periodic_ratio_ = 2.88;
     EwmaRatio ghost_util_ratio;  // ghost miss rate = U(util_step)
     GhostCache ghost_cache;
+    // admission 전용 ghost: evict 와 bypass 된 block. ghost_cache 의 evictCount 는 valid rate 제어가
+    // 쓰므로 admission 이 거절한 write 를 섞지 않는다
+    GhostCache admission_ghost_;
     uint64_t ghost_compacted_blocks = 0;
     uint64_t ghost_access_total = 0;
     uint64_t ghost_miss_total = 0;
+    // --ghost_shadow: ghost 용량(비율) 별 eviction ratio. 마지막이 ghost_cache 자체, 나머지는 shadow
+    std::vector<double>    ghost_shadow_ratios_;
+    std::vector<EwmaRatio> ghost_shadow_eviction_ratio_;
+    CompactionCurve        compaction_curve_;   // GC victim 복사 비율 (utilization bin 별)
+    uint64_t ghost_shadow_evict_count(std::size_t i) const;
+    // --valid_mpc: ghost shadow 위에서 도는 online DP 제어
+    std::unique_ptr<ValidRateMpc> valid_mpc_;
+    uint64_t mpc_step_blocks_ = 0;
+    // --gc_model: MultiHotCold GC stream 수 / interval 을 midas_model 로 조정 (fitting 은 별도 thread)
+    std::unique_ptr<GcStreamTuner> gc_tuner_;
+    void apply_gc_layout();
     static constexpr double UTIL_STEP = 0.02;
     std::deque<double> tco_history;
     bool tco_policy_higher = true;
@@ -177,7 +250,7 @@ private:
     void print_lifetime_results();
 
     /* ── Rewrite interval tracking (no-cache baseline) ──── */
-    std::unordered_map<long, uint64_t> rewrite_last_ts_;  // LBA → last write ts
+    KeyTable rewrite_last_ts_;                             // LBA → last write ts
     std::map<uint64_t, uint64_t> rewrite_hist_;            // bucket → count
 
     void record_rewrite(long key);
@@ -202,8 +275,13 @@ private:
         int class_num;
     };
     std::vector<InvSnapSegInfo> inv_snap_segs_;
-    std::unordered_map<long, size_t> inv_snap_block_seg_idx_;
-    std::vector<std::vector<uint64_t>> inv_snap_inv_times_;
+    KeyTable inv_snap_block_seg_idx_;                      // snapshot 당시 valid block → segment idx
+    struct InvTimeStats {
+        uint64_t count = 0;                                // 추적된(sampled) invalidation 수
+        double sum = 0.0;
+        double sum_sq = 0.0;
+    };
+    std::vector<InvTimeStats> inv_snap_inv_times_;         // segment 별 invalidation time 누적
     void take_inv_snapshot();
     void record_inv_time(long key);
     void print_inv_time_scatter();
@@ -24,6 +24,7 @@ public:
 
     /* data */
     std::vector<Block> blocks;
+    std::size_t id = 0;   ///< cache 안의 segment 번호 (cache device 주소 계산용)
 
     /* helpers */
     inline bool full()  override  { return write_ptr >= blocks.size(); }
@@ -181,14 +181,13 @@ void LRUCache::maybe_log_cache_ftl_stats() {
     if (!fp_stats) {
         return;
     }
-    const uint64_t host_bytes = cache_ftl.GetHostWritePages() * static_cast<uint64_t>(NAND_PAGE_SIZE);
+    const uint64_t host_bytes = cache_ftl.GetHostWriteBytes();
     if (host_bytes < next_cache_ftl_log_bytes) {
         return;
     }
-    const uint64_t nand_bytes = cache_ftl.GetNandWritePages() * static_cast<uint64_t>(NAND_PAGE_SIZE);
+    const uint64_t nand_bytes = cache_ftl.GetNandWriteBytes();
 
-    const auto compacted_blocks_value = (cache_ftl.GetNandWritePages() - cache_ftl.GetHostWritePages())
-        * static_cast<unsigned long long>(NAND_PAGE_SIZE)
+    const auto compacted_blocks_value = (nand_bytes - host_bytes)
         / static_cast<unsigned long long>(cache_block_size);
     const std::string& prefix = stats_prefix();
     const char* prefix_cstr = prefix.empty() ? "LRU" : prefix.c_str();
@@ -1,35 +1,27 @@
 #pragma once
 #include <cstdint>
-#include <sys/types.h>
-#include <sys/stat.h>
-#include <sys/mman.h>
-#include <fcntl.h>
-#include <unistd.h>
-#include <cassert>
-#include <cstring>
+#include "lazy_array.h"
 
+// offset(4 KB 단위) 별 timestamp. max_offset 기준으로 lazy 하게 잡고 (안 쓴 page 는 commit 안 됨)
+// 그보다 큰 offset 이 오면 늘린다. 한 번도 안 쓴 offset 은 0
 class Metadata
 {
   public:
-    Metadata()
-    {
-        mArray = new uint64_t[kSize];
-        memset(mArray, 0, kSize * sizeof(uint64_t));
-    }
+    explicit Metadata(uint64_t max_offset = 0) : mArray(max_offset / 4096 + 1) {}
 
     void Update(uint64_t offset, uint64_t meta)
     {
       offset /= 4096;
+      mArray.reserve_index(offset);
       mArray[offset] = meta;
     }
 
-    uint64_t Query(uint64_t offset)
+    uint64_t Query(uint64_t offset) const
     {
-      uint64_t meta;
       offset /= 4096;
-      meta = mArray[offset];
-      return meta;
+      return offset < mArray.size() ? mArray[offset] : 0;
     }
-    uint64_t* mArray;
-    const uint64_t kSize = 512ull * 1024 * 1024 * 1024 / 4096;
+
+  private:
+    LazyArray<uint64_t> mArray;
 };
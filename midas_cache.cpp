@@ -23,7 +23,7 @@
 #undef WRITE
 #undef REMOVE
 
-extern uint64_t interval;
+extern thread_local uint64_t interval;
 
 namespace midas {
 extern SSD_SPEC *ssd_spec;
@@ -42,81 +42,6 @@ namespace {
 constexpr int kDefaultTw = 4;
 }
 
-void MidasCache::RemapTable::init(std::size_t total_blocks_in) {
-    total_blocks = total_blocks_in;
-    mapping.clear();
-    rev_mapping.clear();
-    used.assign(total_blocks, 0);
-    free_list.clear();
-    free_list.reserve(total_blocks);
-    for (std::size_t i = 0; i < total_blocks; ++i) {
-        free_list.push_back(static_cast<int>(i));
-    }
-    ready = (total_blocks > 0);
-}
-
-int MidasCache::RemapTable::next_free() {
-    while (!free_list.empty()) {
-        int blk = free_list.back();
-        free_list.pop_back();
-        if (!used[static_cast<std::size_t>(blk)]) {
-            return blk;
-        }
-    }
-    return -1;
-}
-
-int MidasCache::RemapTable::get_or_assign(long key) {
-    if (!ready || total_blocks == 0) return -1;
-    auto it = mapping.find(key);
-    if (it != mapping.end()) return it->second;
-
-    std::size_t candidate = static_cast<std::size_t>(key % static_cast<long>(total_blocks));
-    int mapped = -1;
-    if (!used[candidate]) {
-        mapped = static_cast<int>(candidate);
-    } else {
-        mapped = next_free();
-        if (mapped == -1) {
-            assert(false);
-            //mapped = static_cast<int>(candidate); // fallback: reuse candidate
-        }
-    }
-    if (mapped >= 0) {
-        used[static_cast<std::size_t>(mapped)] = 1;
-        mapping[key] = mapped;
-        rev_mapping[mapped] = key;
-    }
-    return mapped;
-}
-
-int MidasCache::RemapTable::remove(long key) {
-    if (!ready || total_blocks == 0) return -1;
-    auto it = mapping.find(key);
-    if (it == mapping.end()) {
-        assert(false);
-    } 
-    int mapped = it->second;
-    mapping.erase(it);
-    rev_mapping.erase(mapped);
-    if (mapped >= 0 && static_cast<std::size_t>(mapped) < used.size() && used[static_cast<std::size_t>(mapped)]) {
-        used[static_cast<std::size_t>(mapped)] = 0;
-        free_list.push_back(mapped);
-    }
-    else {
-        assert(false);
-    }
-    return mapped;
-}
-
-int MidasCache::RemapTable::remove_by_mapped(int mapped) {
-    if (!ready || total_blocks == 0) return -1;
-    auto rit = rev_mapping.find(mapped);
-    if (rit == rev_mapping.end()) return -1;
-    long key = rit->second;
-    return remove(key);
-}
-
 MidasCache::MidasCache(uint64_t              cold_capacity,
                        uint64_t              cache_block_count,
                        int                   blk_sz,
@@ -132,6 +57,7 @@ MidasCache::MidasCache(uint64_t              cold_capacity,
                        const MidasInitArgs& midas_init_args)
     : ICache(cold_capacity, waf_log_file, stat_log_file),
       cache_block_size(blk_sz),
+      cold_capacity_(cold_capacity),
       cfg_(cfg ? *cfg : MidasConfig{}),
       group_num(group_count),
       midas_args_(midas_init_args),
@@ -155,11 +81,13 @@ MidasCache::MidasCache(uint64_t              cold_capacity,
     }
 
     global_valid_blocks = 0;
+    admission_.reset(createAdmissionPolicy(g_admission_policy));
 
     initialize_midas();
 }
 
 MidasCache::~MidasCache() {
+    if (admission_) admission_->print_stats(stdout);
     print_utilization_distribution();
     print_segment_age_scatter();
     print_inv_time_scatter();
@@ -191,8 +119,28 @@ void MidasCache::batch_insert(int stream_id, const std::map<long,int>& newBlocks
     for (auto [key, lba_sz] : newBlocks) {
         maybe_run_gc_policy();
 
+        // key 를 그대로 MiDAS lba 로 쓴다 (cold capacity 밖이면 mapping table 을 키운다)
+        if (key < 0) {
+            printf("failed\n");
+            continue;
+        }
+        midas::lba_t lba = static_cast<midas::lba_t>(key);
+        midas::ssd_grow_lba_space(midas_ssd, lba);
+
+        // admission 이 거절하면 cache copy 를 trim 하고 cold tier 로 바로
+        // MiDAS 는 eviction age threshold 도 ghost 도 없으니 시각만 넘긴다
+        if (admission_ && !admission_->admit(key, {static_cast<uint64_t>(midas_stats->cur_wp), 0, false})) {
+            if (midas_ssd->mtable[lba] != -1) {
+                record_inv_time(key);
+                midas::trim(lba, midas_ssd, midas_stats);
+                global_valid_blocks = midas::valid_pages_global.load(std::memory_order_relaxed);
+            }
+            _evict_one_block(static_cast<uint64_t>(key) * cache_block_size, lba_sz, OP_TYPE::WRITE);
+            continue;
+        }
+
         // record inv_time and compacted_lifetime for overwritten block
-        if (remap_.mapping.count(key)) {
+        if (midas_ssd->mtable[lba] != -1) {
             record_inv_time(key);
             auto cit = compacted_at_.find(key);
             if (cit != compacted_at_.end()) {
@@ -201,15 +149,10 @@ void MidasCache::batch_insert(int stream_id, const std::map<long,int>& newBlocks
             }
         }
 
-        int mapped = remap_.get_or_assign(key);
-        if (mapped < 0) {
-            printf("failed\n");
-            continue;
-        }
         write_size_to_cache += lba_sz;
 
         // delegate the real write to MiDAS engine (4K per call)
-        midas::write(static_cast<int>(mapped), midas_ssd, midas_stats, midas_group.data(), false);
+        midas::write(lba, midas_ssd, midas_stats, midas_group.data(), false);
         midas::stat_update(midas_stats, 1, 0); // increment cur_wp for page_stamp tracking
         // sync valid blocks from MiDAS atomic
         global_valid_blocks = midas::valid_pages_global.load(std::memory_order_relaxed);
@@ -224,6 +167,25 @@ int MidasCache::invalidate(long key, int /*lba_sz*/) {
     return 0;
 }
 
+// 위 tier 에서 새로 쓰인 block: MiDAS 에 있으면 trim, 없으면 cold tier 로 넘긴다
+void MidasCache::trim(long key, int lba_sz) {
+    if (midas_initialized && key >= 0) {
+        midas::lba_t lba = static_cast<midas::lba_t>(key);
+        midas::ssd_grow_lba_space(midas_ssd, lba);
+        if (midas_ssd->mtable[lba] != -1) {
+            record_inv_time(key);
+            midas::trim(lba, midas_ssd, midas_stats);
+            global_valid_blocks = midas::valid_pages_global.load(std::memory_order_relaxed);
+            return;
+        }
+    }
+    _invalidate_cold_block(static_cast<uint64_t>(key) * cache_block_size, lba_sz, OP_TYPE::TRIM);
+}
+
+uint64_t MidasCache::gc_write_blocks() {
+    return midas::compacted_blocks_global.load(std::memory_order_relaxed);
+}
+
 void MidasCache::evict_one_segment() {
     if (!midas_initialized || midas::ssd_spec->PPS <= 0) return;
     int victim_gid = -1;
@@ -240,7 +202,7 @@ void MidasCache::evict_one_segment() {
     if (victim_seg == -1) return;
 
     int removed = purge_segment_valids(victim_seg);
-    int victim_idx = victim_seg * midas::ssd_spec->PPS;
+    midas::ppa_t victim_idx = static_cast<midas::ppa_t>(victim_seg) * midas::ssd_spec->PPS;
     midas::initialize_segment(midas_ssd, victim_idx, victim_seg, victim_gid);
     midas::fbqueue.push_front(victim_seg);
     evicted_blocks += static_cast<long long>(removed);
@@ -265,6 +227,7 @@ void MidasCache::print_stats() {
                  static_cast<unsigned long>(total_capacity_bytes),
                  static_cast<unsigned long>(reinsert_blocks),
                  static_cast<unsigned long>(read_blocks_in_partial_write));
+        if (admission_) admission_->print_stats(fp_stats);
         fflush(fp_stats);
         next_written_bytes += written_window_bytes;
     }
@@ -297,8 +260,9 @@ void MidasCache::initialize_midas() {
     midas::vs_policy = const_cast<char*>(vs_policy_str_.c_str());
 
     int policy = midas::policy_to_int(midas::vs_policy);
-    midas::ssd_init(midas_ssd, midas_group.data(), gnum, policy, naive_start, dev_gb, seg_mb);
-    remap_.init(static_cast<std::size_t>(midas::ssd_spec->LBANUM));
+    // mapping table 은 cache 크기가 아니라 cold device 의 block 수로 잡는다 (key == lba)
+    midas::ssd_init(midas_ssd, midas_group.data(), gnum, policy, naive_start, dev_gb, seg_mb,
+                    static_cast<midas::lba_t>(cold_capacity_ / cache_block_size));
     midas::group_init(midas_ssd, midas_group.data(), queue_gnum, 1, group_size.data());
     midas::stats_init(midas_stats);
     midas::stats = midas_stats;
@@ -366,26 +330,21 @@ int MidasCache::purge_segment_valids(int victim_seg) {
     for (int i = 0; i < midas::ssd_spec->PPS; ++i) {
         long idx = base + i;
         if (idx < 0) continue;
-        if (midas_ssd->itable[idx] == false && midas_ssd->oob[idx].lba != -1) { // valid page
-            int lba = midas_ssd->oob[idx].lba;
+        if (midas::itable_get(midas_ssd, idx) == false && midas_ssd->oob[idx].lba != -1) { // valid page
+            midas::lba_t lba = midas_ssd->oob[idx].lba;
+            if (admission_) admission_->on_evict(static_cast<uint64_t>(lba), static_cast<uint64_t>(midas_stats->cur_wp));
             // record inv_time and compacted_lifetime for GC-evicted block
-            {
-                auto rit = remap_.rev_mapping.find(lba);
-                if (rit != remap_.rev_mapping.end()) {
-                    record_inv_time(rit->second);
-                    auto cit = compacted_at_.find(rit->second);
-                    if (cit != compacted_at_.end()) {
-                        compacted_lifetime_histogram_->inc(midas_stats->cur_wp - cit->second);
-                        compacted_at_.erase(cit);
-                    }
-                }
+            record_inv_time(static_cast<long>(lba));
+            auto cit = compacted_at_.find(static_cast<long>(lba));
+            if (cit != compacted_at_.end()) {
+                compacted_lifetime_histogram_->inc(midas_stats->cur_wp - cit->second);
+                compacted_at_.erase(cit);
             }
             uint64_t start_index = static_cast<uint64_t>(lba) / static_cast<uint64_t>(cfg_.evicted_blk_size);
             start_index *= static_cast<uint64_t>(cfg_.evicted_blk_size);
             _evict_one_block(start_index * cache_block_size,
                              cache_block_size * static_cast<uint64_t>(cfg_.evicted_blk_size),
                              OP_TYPE::WRITE);
-            remap_.remove_by_mapped(lba);
             if (lba >= 0 && midas_ssd->mtable[lba] == idx) {
                 midas_ssd->mtable[lba] = -1;
             }
@@ -495,12 +454,12 @@ void MidasCache::print_segment_age_scatter() {
     for (int seg = 0; seg < midas::ssd_spec->SEGNUM; seg++) {
         if (!midas_ssd->fill_info[seg]) continue;
 
-        int base = seg * PPS;
+        midas::ppa_t base = static_cast<midas::ppa_t>(seg) * PPS;
         int valid = 0;
         double sum = 0.0, sum_sq = 0.0;
 
         for (int i = 0; i < PPS; i++) {
-            if (midas_ssd->itable[base + i] == false && midas_ssd->oob[base + i].lba != -1) {
+            if (midas::itable_get(midas_ssd, base + i) == false && midas_ssd->oob[base + i].lba != -1) {
                 valid++;
                 double age = static_cast<double>(cur_wp - midas_ssd->page_stamp[base + i]);
                 sum += age;
@@ -546,17 +505,14 @@ void MidasCache::consume_gc_compacted_lbas()
 {
     if (midas::gc_compacted_lbas.empty()) return;
     uint64_t wp = midas_stats->cur_wp;
-    for (int lba : midas::gc_compacted_lbas) {
-        auto rit = remap_.rev_mapping.find(lba);
-        if (rit != remap_.rev_mapping.end()) {
-            long key = rit->second;
-            // if previously compacted, record lifetime of that copy
-            auto cit = compacted_at_.find(key);
-            if (cit != compacted_at_.end()) {
-                compacted_lifetime_histogram_->inc(wp - cit->second);
-            }
-            compacted_at_[key] = wp;
+    for (midas::lba_t lba : midas::gc_compacted_lbas) {
+        long key = static_cast<long>(lba);
+        // if previously compacted, record lifetime of that copy
+        auto cit = compacted_at_.find(key);
+        if (cit != compacted_at_.end()) {
+            compacted_lifetime_histogram_->inc(wp - cit->second);
         }
+        compacted_at_[key] = wp;
     }
     midas::gc_compacted_lbas.clear();
 }
@@ -575,12 +531,12 @@ void MidasCache::take_inv_snapshot()
     for (int seg = 0; seg < midas::ssd_spec->SEGNUM; seg++) {
         if (!midas_ssd->fill_info[seg]) continue;
 
-        int base = seg * PPS;
+        midas::ppa_t base = static_cast<midas::ppa_t>(seg) * PPS;
         int valid = 0;
         double sum = 0.0, sum_sq = 0.0;
 
         for (int i = 0; i < PPS; i++) {
-            if (midas_ssd->itable[base + i] == false && midas_ssd->oob[base + i].lba != -1) {
+            if (midas::itable_get(midas_ssd, base + i) == false && midas_ssd->oob[base + i].lba != -1) {
                 valid++;
                 double age = static_cast<double>(cur_wp - midas_ssd->page_stamp[base + i]);
                 sum += age;
@@ -606,12 +562,8 @@ void MidasCache::take_inv_snapshot()
 
         // map each valid block's key -> seg_idx
         for (int i = 0; i < PPS; i++) {
-            if (midas_ssd->itable[base + i] == false && midas_ssd->oob[base + i].lba != -1) {
-                int lba = midas_ssd->oob[base + i].lba;
-                auto rit = remap_.rev_mapping.find(lba);
-                if (rit != remap_.rev_mapping.end()) {
-                    inv_snap_block_seg_idx_[rit->second] = seg_idx;
-                }
+            if (midas::itable_get(midas_ssd, base + i) == false && midas_ssd->oob[base + i].lba != -1) {
+                inv_snap_block_seg_idx_[static_cast<long>(midas_ssd->oob[base + i].lba)] = seg_idx;
             }
         }
         seg_idx++;
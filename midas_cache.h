@@ -3,6 +3,7 @@
 #include "log_cache_segment.h"
 #include "istream.h"
 #include "histogram.h"
+#include "admission.h"
 
 #include <array>
 #include <map>
@@ -61,6 +62,8 @@ public:
     bool        exists(long key) override;
     void        touch(long, OP_TYPE) override {}              // no‑op
     std::size_t size() override { return global_valid_blocks; }
+    void        trim(long key, int lba_sz) override;
+    uint64_t    gc_write_blocks() override;
 
     /* 새로운 API – stream id 포함 */
     void batch_insert(int stream_id, const std::map<long,int>& newBlocks,
@@ -79,6 +82,7 @@ public:
 private:
     /* configuration ******************************************************/
     const int         cache_block_size;
+    const uint64_t    cold_capacity_;    // bytes, MiDAS lba space = cold_capacity_ / cache_block_size
     MidasConfig       cfg_;
     int               group_num;
     MidasInitArgs     midas_args_;
@@ -142,28 +146,11 @@ private:
     static const uint64_t DEFAULT_HALF_LIFE_IN_BLOCKS = 262144 * 4;
     bool is_ghost_cache = false;
     uint64_t bypass_blocks_threshold = 128; // 128* 4k bytes = 512K bytes
+    std::unique_ptr<IAdmission> admission_; // --admission, nullptr = 전부 admit
 
     uint64_t epoch_written_pages = 0;
     uint64_t epoch_threshold_pages = 0;
 
-    struct RemapTable {
-        void init(std::size_t total_blocks);
-        int  get_or_assign(long key);
-        int  remove(long key);
-        int  remove_by_mapped(int mapped); // remove by mapped index (for reverse lookup)
-
-        bool ready = false;
-        std::size_t total_blocks = 0;
-        std::unordered_map<long, int> mapping;
-        std::unordered_map<int, long> rev_mapping;
-        std::vector<char> used;
-        std::vector<int> free_list;
-
-    private:
-        int next_free();
-    };
-    RemapTable remap_;
-
     std::unique_ptr<Histogram> evicted_ages_histogram_;
     std::unique_ptr<Histogram> evicted_blocks_histogram_;
     std::unique_ptr<Histogram> evicted_ages_with_segment_histogram_;
@@ -3,10 +3,135 @@
 #include <cstdlib>
 #include <algorithm>
 #include <limits>
+#include <thread>
 #include <boost/math/special_functions/lambert_w.hpp>
 
+int g_model_threads = 1;
+
 namespace midas_sim {
 
+namespace {
+// 한 번의 kernel 호출에서 같이 계산하는 후보 수 (SoA lane 수)
+constexpr size_t kWafBatch = 16;
+
+template <typename F>
+void parallel_for(int num_threads, F&& fn) {
+    if (num_threads <= 1) { fn(0); return; }
+    std::vector<std::thread> ts;
+    for (int t = 0; t < num_threads; ++t) ts.emplace_back(fn, t);
+    for (auto& th : ts) th.join();
+}
+
+int search_threads(size_t tasks) {
+    return (int)std::max<size_t>(1, std::min<size_t>(tasks, (size_t)std::max(1, g_model_threads)));
+}
+
+/* gnum(>=2) 이 같은 후보 C 개의 markov chain 을 같이 돌린다.
+ * val2 는 SoA: val2[i*C + c] = 후보 c 의 slot i valid ratio (i = 0..N, N = gnum+1)
+ * 전이 행렬은 행마다 0 이 아닌 칸이 많아야 3 개라서 (0 열 = invalid, i+1 열 = 다음 group)
+ * dense 곱 대신 그 칸만 같은 k 순서로 더한다 -> dense 구현과 비트 단위로 같은 값.
+ * 안쪽 loop 가 후보(c) 방향이라 compiler 가 vectorize 한다 */
+void waf_markov_batch(const double* val2, size_t gnum, size_t C, double g0_traffic, double* out) {
+    const size_t N = gnum + 1;
+    std::vector<double> base((N + 1) * C, 0.0), res((N + 1) * C, 0.0);
+    std::vector<double> tmp_tot_wr(C, 0.0), past(C, 0.0);
+    for (size_t c = 0; c < C; ++c) {
+        res[0 * C + c] = 1000.0;
+        res[1 * C + c] = 9000.0;
+    }
+    const double g1_traffic = 1.0 - g0_traffic;
+    for (int iter = 0; iter < 2000; ++iter) {
+        base.swap(res);
+        const double* b = base.data();
+        double* r = res.data();
+        for (size_t c = 0; c < C; ++c) {
+            // 0 열: 모든 행의 invalid 비율 (0 행은 1 - 1.0 = 0)
+            double acc = 0.0;
+            for (size_t k = 1; k <= N; ++k) acc += b[k * C + c] * (1.0 - val2[k * C + c]);
+            r[0 * C + c] = acc;
+            r[1 * C + c] = b[0 * C + c] * g0_traffic;
+            r[2 * C + c] = b[0 * C + c] * g1_traffic + b[1 * C + c] * val2[1 * C + c];
+        }
+        for (size_t j = 3; j < N; ++j) {
+            for (size_t c = 0; c < C; ++c) r[j * C + c] = b[(j - 1) * C + c] * val2[(j - 1) * C + c];
+        }
+        for (size_t c = 0; c < C; ++c) {
+            r[N * C + c] = b[(N - 1) * C + c] * val2[(N - 1) * C + c] + b[N * C + c] * val2[N * C + c];
+        }
+        for (size_t c = 0; c < C; ++c) {
+            double t = 0.0;
+            for (size_t j = 0; j < gnum - 1; ++j) t += r[(j + 3) * C + c];
+            t += r[1 * C + c] * val2[1 * C + c];
+            tmp_tot_wr[c] = t;
+            past[c] = r[0 * C + c];
+        }
+    }
+    for (size_t c = 0; c < C; ++c) {
+        out[c] = (past[c] == 0) ? 1.0 : (tmp_tot_wr[c] + past[c]) / past[c];
+    }
+}
+
+double waf_fifo_single(double vr0) {
+    double op = 1.0 - vr0;
+    if (op <= 0.0) return 1.0;
+    double w = boost::math::lambert_w0(-op * std::exp(-op));
+    return op / (op + w);
+}
+
+// model_count 누적 분포 (분모: total)
+std::vector<double> interval_cdf(const MiniModel* m, double total) {
+    std::vector<double> cdf(m->model_count.size(), 0.0);
+    double running = 0.0;
+    for (size_t i = 0; i < m->model_count.size(); ++i) {
+        running += (double)m->model_count[i];
+        cdf[i] = std::min(1.0, running / total);
+    }
+    return cdf;
+}
+
+std::vector<double> valid_ratio_from_cdf(const MiniModel* m, const std::vector<double>& cdf, int gnum) {
+    std::vector<double> vr(gnum, 0.8);
+    for (int g = 0; g < gnum; ++g) {
+        double target = (double)(g + 1) / (double)(gnum + 1);
+        // cdf 는 단조 증가: 처음으로 cdf >= target 인 bucket
+        size_t idx = std::lower_bound(cdf.begin(), cdf.end(), target) - cdf.begin();
+        double interval_norm = (double)idx / (double)std::max<uint32_t>(1, m->entry_num);
+        double est_vr = std::exp(- (interval_norm + 0.001));
+        vr[g] = std::min(0.99, std::max(0.01, est_vr));
+    }
+    // ensure monotonic non-decreasing valid ratios towards cold
+    for (int g = 1; g < gnum; ++g) {
+        if (vr[g] < vr[g-1]) vr[g] = vr[g-1] + 0.01;
+        if (vr[g] > 0.99) vr[g] = 0.99;
+    }
+    return vr;
+}
+
+std::vector<double> age_group_valid_ratio_from_cdf(const MiniModel* m, const std::vector<double>& cdf,
+                                                   int gc_groups, uint64_t granularity_pages) {
+    std::vector<double> vr(gc_groups + 1, 0.8);
+    auto survive = [&](double pages) {
+        double pos = pages / m->interval_unit_size;
+        if (pos <= 0.0) return 1.0;
+        if (pos >= cdf.size()) return 1.0 - cdf.back();
+        size_t i = (size_t)pos;
+        double lo = (i == 0) ? 0.0 : cdf[i - 1];
+        double frac = pos - i;
+        return 1.0 - (lo + (cdf[i] - lo) * frac);
+    };
+    double g = (double)granularity_pages;
+    double window = (double)m->real_tw;
+    vr[0] = survive(g);
+    for (int k = 1; k <= gc_groups; ++k) {
+        double s_lo = survive(k * g);
+        double s_hi = (k == gc_groups) ? survive(window) : survive((k + 1) * g);
+        vr[k] = (s_lo > 0.0) ? s_hi / s_lo : 0.01;
+    }
+    for (auto &v : vr) v = std::min(0.99, std::max(0.01, v));
+    return vr;
+}
+} // namespace
+
 MiniModel* model_create(uint64_t logsize_pages, uint32_t interval_unit_size_pages, uint32_t total_segments) {
     auto *m = new MiniModel;
     m->interval_unit_size = interval_unit_size_pages;
@@ -56,65 +181,46 @@ void model_add_g0_sample(MiniModel* m, double traffic_ratio, double valid_ratio,
 }
 
 double waf_predict(const std::vector<double>& vr, double g0_traffic) {
-    size_t gnum = vr.size();
-    if (gnum == 0) return 1.0;
-    // lambert_w based FIFO estimation for single group shortcut
-    if (gnum == 1) {
-        double op = 1.0 - vr[0];
-        if (op <= 0.0) return 1.0;
-        double w = boost::math::lambert_w0(-op * std::exp(-op));
-        return op / (op + w);
-    }
-    size_t N = gnum + 1; // include hot slot
-    std::vector<double> val2(N + 1, 0.0);
-    val2[0] = 1.0;
-    val2[1] = vr[0];
-    for (size_t i = 1; i < gnum; ++i) val2[i + 1] = vr[i];
-
-    std::vector<std::vector<double>> mtx(N + 1, std::vector<double>(N + 1, 0.0));
-    for (size_t i = 0; i <= N; ++i) {
-        mtx[i][0] = 1.0 - val2[i];
-        if (i == 0) {
-            mtx[i][1] = g0_traffic;
-            mtx[i][2] = 1.0 - mtx[i][1];
-        } else if (i == N) {
-            mtx[i][i] = val2[i];
-        } else {
-            mtx[i][i + 1] = val2[i];
-        }
+    return waf_predict_batch({vr}, g0_traffic)[0];
+}
+
+std::vector<double> waf_predict_batch(const std::vector<std::vector<double>>& vrs, double g0_traffic) {
+    std::vector<double> out(vrs.size(), 1.0);
+    // gnum 별로 묶어 kWafBatch 개씩 kernel 에 넘긴다
+    std::vector<std::vector<size_t>> jobs;
+    std::vector<size_t> order(vrs.size());
+    for (size_t i = 0; i < vrs.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return vrs[a].size() < vrs[b].size(); });
+    for (size_t i : order) {
+        size_t gnum = vrs[i].size();
+        if (gnum == 0) continue;
+        // lambert_w based FIFO estimation for single group shortcut
+        if (gnum == 1) { out[i] = waf_fifo_single(vrs[i][0]); continue; }
+        if (jobs.empty() || vrs[jobs.back().front()].size() != gnum || jobs.back().size() == kWafBatch)
+            jobs.emplace_back();
+        jobs.back().push_back(i);
     }
-    std::vector<double> base(N + 1, 0.0), res(N + 1, 0.0);
-    base[0] = 1000.0;
-    base[1] = 9000.0;
-    res = base;
-    double total_wr = 0.0;
-    double tmp_tot_wr = 0.0;
-    double past = 0.0;
-    for (int iter = 0; iter < 2000; ++iter) {
-        tmp_tot_wr = 0.0;
-        base.swap(res);
-        std::fill(res.begin(), res.end(), 0.0);
-        for (size_t j = 0; j <= N; ++j) {
-            for (size_t k = 0; k <= N; ++k) {
-                res[j] += base[k] * mtx[k][j];
+    int threads = search_threads(jobs.size());
+    parallel_for(threads, [&](int t) {
+        std::vector<double> val2, waf;
+        for (size_t j = t; j < jobs.size(); j += threads) {
+            const auto& job = jobs[j];
+            const size_t C = job.size();
+            const size_t gnum = vrs[job[0]].size();
+            const size_t N = gnum + 1;
+            // slot 0 = 새 write (1.0), slot 1..gnum = group valid ratio, slot N 은 0
+            val2.assign((N + 1) * C, 0.0);
+            for (size_t c = 0; c < C; ++c) {
+                const auto& vr = vrs[job[c]];
+                val2[c] = 1.0;
+                for (size_t i = 0; i < gnum; ++i) val2[(i + 1) * C + c] = vr[i];
             }
+            waf.assign(C, 1.0);
+            waf_markov_batch(val2.data(), gnum, C, g0_traffic, waf.data());
+            for (size_t c = 0; c < C; ++c) out[job[c]] = waf[c];
         }
-        if (gnum == 1) {
-            total_wr += res[2] - res[0] * val2[1];
-            tmp_tot_wr += res[2] - res[0] * val2[1];
-        } else {
-            for (size_t j = 0; j < gnum - 1; ++j) {
-                total_wr += res[j + 3];
-                tmp_tot_wr += res[j + 3];
-            }
-            total_wr += res[1] * val2[1];
-            tmp_tot_wr += res[1] * val2[1];
-        }
-        past = res[0];
-    }
-    if (past == 0) return 1.0;
-    double WAF = (tmp_tot_wr + past) / past;
-    return WAF;
+    });
+    return out;
 }
 
 bool model_tick(MiniModel* m, uint32_t pages) {
@@ -139,6 +245,7 @@ void model_update_lba(MiniModel* m, uint64_t lba) {
     if (lba % m->lba_sampling_ratio) return;
     lba = lba / m->lba_sampling_ratio;
     if (lba >= m->time_stamp.size()) return;
+    m->total_count++;
     uint64_t tmp_time = m->current_time * m->interval_unit_size + m->request_time;
     if (m->time_stamp[lba] == UINT64_MAX || m->time_stamp[lba] == UINT64_MAX-1) {
         m->time_stamp[lba] = tmp_time << 1;
@@ -157,27 +264,53 @@ std::vector<double> predict_valid_ratio(const MiniModel* m, int gnum) {
     double total = 0.0;
     for (auto c : m->model_count) total += (double)c;
     if (total == 0.0) return vr;
-    // cumulative distribution over interval buckets
-    std::vector<double> cdf(m->model_count.size(), 0.0);
-    double running = 0.0;
-    for (size_t i = 0; i < m->model_count.size(); ++i) {
-        running += (double)m->model_count[i];
-        cdf[i] = running / total;
-    }
-    for (int g = 0; g < gnum; ++g) {
-        double target = (double)(g + 1) / (double)(gnum + 1);
-        size_t idx = 0;
-        while (idx < cdf.size() && cdf[idx] < target) idx++;
-        double interval_norm = (double)idx / (double)std::max<uint32_t>(1, m->entry_num);
-        double est_vr = std::exp(- (interval_norm + 0.001));
-        vr[g] = std::min(0.99, std::max(0.01, est_vr));
+    return valid_ratio_from_cdf(m, interval_cdf(m, total), gnum);
+}
+
+std::vector<double> predict_age_group_valid_ratio(const MiniModel* m, int gc_groups, uint64_t granularity_pages) {
+    std::vector<double> vr(gc_groups + 1, 0.8);
+    if (!m || gc_groups <= 0 || m->total_count == 0 || m->model_count.empty() || m->interval_unit_size == 0) return vr;
+    // cdf[i]: 다음 update 까지 간격이 bucket i 이하인 write 비율 (window 안에 update 없으면 포함 안 됨)
+    return age_group_valid_ratio_from_cdf(m, interval_cdf(m, (double)m->total_count), gc_groups, granularity_pages);
+}
+
+GcLayoutChoice choose_gc_layout(const MiniModel* m, int max_gc_groups, const std::vector<uint64_t>& granularities) {
+    GcLayoutChoice best;
+    best.WAF = std::numeric_limits<double>::max();
+    struct Cand { int n; uint64_t g; };
+    std::vector<Cand> cands;
+    for (int n = 1; n <= max_gc_groups; ++n) {
+        for (uint64_t g : granularities) {
+            if (g != 0) cands.push_back({n, g});
+        }
     }
-    // ensure monotonic non-decreasing valid ratios towards cold
-    for (int g = 1; g < gnum; ++g) {
-        if (vr[g] < vr[g-1]) vr[g] = vr[g-1] + 0.01;
-        if (vr[g] > 0.99) vr[g] = 0.99;
+    // 후보 valid ratio 는 cdf 한 번으로 병렬 계산, WAF 는 batch 로
+    std::vector<std::vector<double>> vrs(cands.size());
+    bool fitted = m && m->total_count != 0 && !m->model_count.empty() && m->interval_unit_size != 0;
+    std::vector<double> cdf;
+    if (fitted) cdf = interval_cdf(m, (double)m->total_count);
+    int threads = search_threads(cands.size());
+    parallel_for(threads, [&](int t) {
+        for (size_t i = t; i < cands.size(); i += threads) {
+            vrs[i] = fitted ? age_group_valid_ratio_from_cdf(m, cdf, cands[i].n, cands[i].g)
+                            : predict_age_group_valid_ratio(m, cands[i].n, cands[i].g);
+        }
+    });
+    // host write 는 전부 host stream(hot slot) 을 거친다
+    std::vector<double> wafs = waf_predict_batch(vrs, 1.0);
+
+    for (size_t i = 0; i < cands.size(); ++i) {
+        int n = cands[i].n;
+        double waf = wafs[i];
+        bool better = waf < best.WAF * 0.99 ||
+                      (waf < best.WAF && n == best.gc_groups);
+        if (best.gc_groups == 0 || better) {
+            best.gc_groups = n;
+            best.granularity = cands[i].g;
+            best.WAF = waf;
+        }
     }
-    return vr;
+    return best;
 }
 
 void model_finalize(MiniModel* m, int target_groups) {
@@ -211,9 +344,13 @@ void model_finalize(MiniModel* m, int target_groups) {
         g0_traffic = t / (double)mq.g0_traffic_queue.size();
     }
 
+    std::vector<std::vector<double>> vrs;
+    for (int cand = 2; cand <= upper; ++cand) vrs.push_back(predict_valid_ratio(m, cand));
+    std::vector<double> wafs = waf_predict_batch(vrs, g0_traffic);
+
     for (int cand = 2; cand <= upper; ++cand) {
         size_t n = (size_t)cand;
-        std::vector<double> vr = predict_valid_ratio(m, (int)n);
+        const std::vector<double>& vr = vrs[cand - 2];
         std::vector<uint32_t> gsize(n, 1);
 
         // size proportional to (1 - vr)
@@ -233,7 +370,7 @@ void model_finalize(MiniModel* m, int target_groups) {
         while (assigned < tot_seg) { gsize.back()++; assigned++; }
         while (assigned > tot_seg && gsize.back() > 1) { gsize.back()--; assigned--; }
 
-        double waf = waf_predict(vr, g0_traffic);
+        double waf = wafs[cand - 2];
         if (waf < best_waf) {
             best_waf = waf;
             best_gnum = cand;
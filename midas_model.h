@@ -60,9 +60,30 @@ void model_add_g0_sample(MiniModel* m, double traffic_ratio, double valid_ratio,
 void model_add_segment_sample(MiniModel* m, int group_id, double valid_ratio, double seg_blocks = 1.0);
 void model_finish_epoch(MiniModel* m);
 double waf_predict(const std::vector<double>& vr, double g0_traffic = 0.1);
+// 여러 후보 valid ratio vector 를 한 번에 평가 (gnum 별 SoA batch, g_model_threads 개 thread)
+std::vector<double> waf_predict_batch(const std::vector<std::vector<double>>& vrs, double g0_traffic = 0.1);
 bool model_tick(MiniModel* m, uint32_t pages = 1);
 void model_update_lba(MiniModel* m, uint64_t lba);
 void model_finalize(MiniModel* m, int target_groups);
 std::vector<double> predict_valid_ratio(const MiniModel* m, int gnum);
 
+// LogCache age 기반 GC stream (MultiHotCold) 용: host stream + gc_groups 개 GC stream 의 valid ratio.
+// GC stream k 는 age [k*g, (k+1)*g) 에서 relocation 된 block 이라고 보고
+// update interval 분포의 생존함수 S 로 S((k+1)g)/S(kg) 를 쓴다 (마지막 stream 은 window 끝까지)
+std::vector<double> predict_age_group_valid_ratio(const MiniModel* m, int gc_groups, uint64_t granularity_pages);
+
+struct GcLayoutChoice {
+    int gc_groups = 0;
+    uint64_t granularity = 0;   // pages (host write 수)
+    double WAF = 0.0;
+};
+// (gc_groups, granularity) 후보 중 waf_predict 최소. WAF 차이가 1% 이내면 stream 수가 적은 쪽
+GcLayoutChoice choose_gc_layout(const MiniModel* m, int max_gc_groups, const std::vector<uint64_t>& granularities);
+
 } // namespace midas_sim
+
+// cache_sim --model_threads: midas_model 후보 탐색 thread 수.
+// 실제로 호출되는 곳은 --gc_model 의 choose_gc_layout (gc_stream_tuner) 뿐이다.
+// MIDAS_CACHE 의 group 탐색 (MiDAS/model.cpp group_configuration_search) 은 model_q 전역을 고쳐 가며
+// 도는 별도 구현이라 여기와 무관하게 background pthread 하나에서 순차로 돈다
+extern int g_model_threads;
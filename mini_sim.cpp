@@ -0,0 +1,261 @@
+#include "mini_sim.h"
+#include "trace_parser.h"
+#include "icache.h"
+#include "log_cache.h"
+#include "write_buffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+// decode 된 sampled request 하나 = blocks[first, first+count) 구간
+struct MiniReq {
+    uint64_t first;     // blocks 는 긴 trace 에서 2^32 를 넘는다
+    uint32_t count;
+    int32_t  size;      // host 요청 범위 (write buffer 의 block 안 위치 계산용)
+    int64_t  offset;
+    OP_TYPE  op;
+};
+
+struct MiniTrace {
+    std::vector<std::pair<long, int>> blocks;   // (block, partial bytes)
+    std::vector<MiniReq> reqs;
+    uint64_t total_write_bytes = 0;             // full trace (sampling 전)
+    uint64_t sampled_write_bytes = 0;
+};
+
+struct MiniResult {
+    uint64_t cache_size = 0;
+    uint64_t mini_blocks = 0;
+    uint64_t host_bytes = 0;
+    uint64_t compacted_bytes = 0;
+    uint64_t evicted_bytes = 0;
+    uint64_t cold_nand_bytes = 0;
+    bool ok = false;
+};
+
+static constexpr uint64_t SAMPLE_MOD = 1ULL << 24;
+// 64K eviction(evicted_blk_size = 16) 묶음이 깨지지 않도록 64 KiB 영역 단위로 sampling
+static constexpr uint64_t SAMPLE_REGION_BYTES = 64 * 1024;
+
+// splitmix64 finalizer – block 번호를 균일하게 섞어서 spatial sampling
+static inline uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static bool decode_trace(const MiniSimOptions& opt, MiniTrace& out) {
+    std::ifstream infile(opt.trace_file);
+    if (!infile) {
+        std::cerr << "[mini_sim] cannot open trace: " << opt.trace_file << std::endl;
+        return false;
+    }
+    std::unique_ptr<ITraceParser> parser(createTraceParser(opt.trace_format));
+    const uint64_t threshold = static_cast<uint64_t>(opt.sample_rate * SAMPLE_MOD);
+    const long long block_size = opt.block_size;
+
+    std::string line;
+    uint64_t line_count = 0;
+    while (std::getline(infile, line)) {
+        if (++line_count % 10000000 == 0) {
+            printf("[mini_sim] decoded %lu lines, sampled %zu blocks\n", line_count, out.blocks.size());
+        }
+        ParsedRow parsed = parser->parseTrace(line);
+        if (parsed.dev_id.empty()) continue;
+        parsed.lba_offset *= opt.lba_scale;
+        parsed.lba_size   *= opt.lba_scale;
+
+        OP_TYPE op;
+        if (parsed.op_type == "R" || parsed.op_type == "RS") {
+            if (opt.rw_policy != "all" && opt.rw_policy != "read-only") continue;
+            op = OP_TYPE::READ;
+        } else if (parsed.op_type == "W" || parsed.op_type == "WS") {
+            if (opt.rw_policy != "all" && opt.rw_policy != "write-only") continue;
+            op = OP_TYPE::WRITE;
+            out.total_write_bytes += parsed.lba_size;
+        } else {
+            continue;
+        }
+
+        // issue_op_to_cache 와 동일한 block 분할
+        const long long req_start = parsed.lba_offset;
+        const long long req_end   = parsed.lba_offset + parsed.lba_size;
+        const long start_block = static_cast<long>(req_start / block_size);
+        const long end_block   = static_cast<long>(req_end / block_size);
+        MiniReq req{out.blocks.size(), 0, static_cast<int32_t>(parsed.lba_size), parsed.lba_offset, op};
+        for (long block = start_block; block <= end_block; block++) {
+            uint64_t region = static_cast<uint64_t>(block) * block_size / SAMPLE_REGION_BYTES;
+            if ((mix64(region) % SAMPLE_MOD) >= threshold) continue;
+            long long left  = std::max<long long>(static_cast<long long>(block) * block_size, req_start);
+            long long right = std::min<long long>(static_cast<long long>(block + 1) * block_size, req_end);
+            if (right <= left) continue;
+            out.blocks.emplace_back(block, static_cast<int>(right - left));
+            req.count++;
+            if (op == OP_TYPE::WRITE) out.sampled_write_bytes += right - left;
+        }
+        if (req.count > 0) out.reqs.push_back(req);
+    }
+    return true;
+}
+
+static void run_one(const MiniSimOptions& opt, const MiniTrace& trace, MiniResult& res) {
+    // 이 thread 에서 생성되는 LogCache 의 segment / stream interval 을 R 배로 축소
+    g_segment_scale = opt.sample_rate;
+
+    const uint64_t mini_bytes = static_cast<uint64_t>(res.cache_size * opt.sample_rate);
+    const long mini_blocks = std::max<long>(1, static_cast<long>(mini_bytes / opt.block_size));
+    const uint64_t mini_cold = std::max<uint64_t>(
+        static_cast<uint64_t>(opt.cold_capacity * opt.sample_rate),
+        (GC_TRIGGER_THRESHOLD * 4ULL) * g_nand_geometry.block_size);
+    res.mini_blocks = mini_blocks;
+
+    std::string tag = opt.cache_policy + ".mini." + std::to_string(res.cache_size);
+    std::string waf_log_file = tag + ".waf.log";
+    std::unique_ptr<ICache> cache(createCache(opt.cache_policy, mini_blocks, mini_cold, opt.block_size,
+                                              false, "", "", waf_log_file, opt.valid_ratio,
+                                              tag + ".stat.log", opt.periodic_ratio));
+    LogCache* log_cache = dynamic_cast<LogCache*>(cache.get());
+    if (log_cache == nullptr) {
+        fprintf(stderr, "[mini_sim] %s is not a LogCache, compaction bytes are not reported\n",
+                opt.cache_policy.c_str());
+    }
+
+    std::unique_ptr<WriteBuffer> write_buffer;
+    if (opt.write_buffer_mb > 0) {
+        WriteBuffer::Policy policy = WriteBuffer::Policy::FIFO;
+        WriteBuffer::parse_policy(opt.write_buffer_policy, policy);
+        const uint64_t wb_blocks = static_cast<uint64_t>((opt.write_buffer_mb << 20) * opt.sample_rate) / opt.block_size;
+        write_buffer.reset(new WriteBuffer(*cache, std::max<uint64_t>(1, wb_blocks), policy));
+    }
+
+    std::map<long, int> newBlocks;
+    for (const MiniReq& req : trace.reqs) {
+        newBlocks.clear();
+        for (uint64_t i = req.first; i < req.first + req.count; i++) {
+            newBlocks[trace.blocks[i].first] = trace.blocks[i].second;
+        }
+        if (write_buffer) {
+            write_buffer->submit(req.offset, req.size, newBlocks, req.op);
+        } else {
+            cache->batch_insert(0, newBlocks, req.op);
+        }
+    }
+    if (write_buffer) {
+        write_buffer->flush();
+        write_buffer->print_stats(stdout);
+    }
+
+    long long host, evicted, write_hit;
+    std::tie(host, evicted, write_hit) = cache->get_status();
+    // buffer 가 흡수한 overwrite 도 host write 이므로 per-TB 는 buffer 로 들어온 bytes 기준
+    res.host_bytes      = write_buffer ? write_buffer->host_bytes() : static_cast<uint64_t>(host);
+    res.evicted_bytes   = static_cast<uint64_t>(evicted) * opt.block_size;
+    res.compacted_bytes = log_cache ? log_cache->get_compacted_blocks() * opt.block_size : 0;
+    res.cold_nand_bytes = cache->ftl.GetNandWriteBytes();
+    res.ok = true;
+}
+
+// LogCache 계열은 per-thread 상태 (g_segment_scale, stream 의 thread_local) 만 써서 동시에 돌려도 된다.
+// 나머지 (MIDAS_CACHE 의 midas::ssd_spec / model_pending / midas_cache.cpp 의 function static, FairyWren, TIERED ...) 는
+// process 전역을 공유하므로 한 thread 에서 차례로 돌린다
+static bool thread_safe_policy(const std::string& policy) {
+    return policy.rfind("LOG_", 0) == 0;
+}
+
+static uint64_t parse_size(const std::string& s) {
+    std::size_t pos = 0;
+    double v = std::stod(s, &pos);
+    uint64_t mul = 1;
+    if (pos < s.size()) {
+        switch (s[pos]) {
+            case 'K': case 'k': mul = 1ULL << 10; break;
+            case 'M': case 'm': mul = 1ULL << 20; break;
+            case 'G': case 'g': mul = 1ULL << 30; break;
+            case 'T': case 't': mul = 1ULL << 40; break;
+            default: throw std::invalid_argument("bad size suffix: " + s);
+        }
+    }
+    return static_cast<uint64_t>(v * mul);
+}
+
+} // namespace
+
+std::vector<uint64_t> parse_mini_sim_sizes(const std::string& list) {
+    std::vector<uint64_t> sizes;
+    std::stringstream ss(list);
+    std::string tok;
+    while (std::getline(ss, tok, ',')) {
+        if (tok.empty()) continue;
+        sizes.push_back(parse_size(tok));
+    }
+    std::sort(sizes.begin(), sizes.end());
+    return sizes;
+}
+
+int run_mini_sim(const MiniSimOptions& opt) {
+    if (opt.cache_sizes.empty() || opt.sample_rate <= 0.0 || opt.sample_rate > 1.0) {
+        std::cerr << "[mini_sim] need at least one cache size and 0 < sample_rate <= 1" << std::endl;
+        return 1;
+    }
+    MiniTrace trace;
+    if (!decode_trace(opt, trace)) return 1;
+    printf("[mini_sim] sample_rate %.4f, sampled %zu blocks in %zu requests, write bytes %lu (sampled %lu)\n",
+           opt.sample_rate, trace.blocks.size(), trace.reqs.size(),
+           trace.total_write_bytes, trace.sampled_write_bytes);
+
+    std::vector<MiniResult> results(opt.cache_sizes.size());
+    for (std::size_t i = 0; i < results.size(); i++) results[i].cache_size = opt.cache_sizes[i];
+
+    int n_threads = opt.threads > 0 ? opt.threads : static_cast<int>(std::thread::hardware_concurrency());
+    n_threads = std::max(1, std::min<int>(n_threads, results.size()));
+    if (n_threads > 1 && !thread_safe_policy(opt.cache_policy)) {
+        printf("[mini_sim] %s shares process-wide state, running cache sizes on 1 thread\n", opt.cache_policy.c_str());
+        n_threads = 1;
+    }
+    std::atomic<std::size_t> next{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < n_threads; t++) {
+        workers.emplace_back([&]() {
+            for (std::size_t i = next++; i < results.size(); i = next++) {
+                run_one(opt, trace, results[i]);
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    FILE* out = nullptr;
+    if (!opt.out_file.empty()) {
+        out = fopen(opt.out_file.c_str(), "w");
+        if (out == nullptr) {
+            std::cerr << "[mini_sim] cannot open output: " << opt.out_file << std::endl;
+            return 1;
+        }
+    }
+    // host bytes 는 full-scale 추정치(1/R), 나머지는 host write 1 TB 당 bytes
+    const char* header = "CacheSize(bytes),MiniBlocks,HostBytes,CompactionBytesPerTB,EvictionBytesPerTB,ColdNandBytesPerTB\n";
+    printf("%s", header);
+    if (out) fprintf(out, "%s", header);
+    const double TB = static_cast<double>(1ULL << 40);
+    for (const MiniResult& r : results) {
+        if (!r.ok) continue;
+        double per_tb = r.host_bytes > 0 ? TB / r.host_bytes : 0.0;
+        char row[256];
+        snprintf(row, sizeof(row), "%lu,%lu,%.0f,%.0f,%.0f,%.0f\n",
+                 r.cache_size, r.mini_blocks, r.host_bytes / opt.sample_rate,
+                 r.compacted_bytes * per_tb, r.evicted_bytes * per_tb, r.cold_nand_bytes * per_tb);
+        printf("%s", row);
+        if (out) fprintf(out, "%s", row);
+    }
+    if (out) fclose(out);
+    return 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Miniature simulation: trace 를 한 번만 decode 해서 spatial sampling 한 뒤,
+// cache size 별 miniature LogCache 를 thread 로 병렬 실행하여 (LOG_* 가 아닌 policy 는 한 thread)
+// host / compaction / eviction bytes (per TB of host write) 곡선을 뽑는다.
+// write buffer 를 켜면 host write 는 buffer 로 들어간 bytes, cache 는 buffer 가 destage 한 것만 받는다.
+struct MiniSimOptions {
+    std::string trace_file;
+    std::string trace_format = "csv";
+    std::string cache_policy = "LOG_FIFO";
+    std::string rw_policy = "all";
+    std::string out_file;                 // 비어 있으면 stdout 만
+    std::vector<uint64_t> cache_sizes;    // bytes (full-scale)
+    uint64_t cold_capacity = 0;           // bytes (full-scale)
+    int block_size = 4096;
+    int lba_scale = 1;
+    double sample_rate = 0.01;            // spatial sampling rate R
+    int threads = 0;                      // 0 이면 hardware_concurrency
+    double valid_ratio = 0.0;
+    double periodic_ratio = 2.88;
+    uint64_t write_buffer_mb = 0;         // cache 앞단 write buffer (full-scale, cache 처럼 R 배로 축소), 0 = 없음
+    std::string write_buffer_policy = "fifo";
+};
+
+// "64G,128G,256000000" 형태의 comma 구분 크기 목록 (K/M/G/T 접미사 허용)
+std::vector<uint64_t> parse_mini_sim_sizes(const std::string& list);
+
+int run_mini_sim(const MiniSimOptions& opt);
@@ -6,6 +6,8 @@
 #include <cmath>
 #include <cstddef>
 #include <sys/mman.h>
+#include <algorithm>
+#include <thread>
 
 // ===== 코어덤프 크기 절약 유틸 =====
 template <typename T>
@@ -104,6 +106,164 @@ static void compute_distances(const std::vector<long long>& trace,
     }
 }
 
+// ===== 병렬 exact distances (LRU/OPT) =====
+// reuse 구간 (prev(i), i) 안의 distinct key 수 = 구간 길이 - 그 안에 완전히 들어가는 reuse 구간 수.
+//   dist(i) = (i - prev(i)) - #{ k < i : prev(k) > prev(i) }
+// 즉 "앞쪽에 있으면서 prev 값이 더 큰 원소 수" 를 원소별로 세는 inversion counting 이고,
+// merge sort 로 병렬화할 수 있다. OPT 는 trace 를 뒤집어 next 를 prev 처럼 쓰면 같은 식.
+template <typename F>
+static void parallel_for(int num_threads, F&& fn) {
+    std::vector<std::thread> ts;
+    for (int t = 0; t < num_threads; ++t) ts.emplace_back(fn, t);
+    for (auto& th : ts) th.join();
+}
+
+// 시간 블록별로 local prev 를 구하고, 블록 경계를 넘는 (unresolved) 첫 접근만 순서대로 merge
+static void compute_prev_parallel(const std::vector<long long>& trace,
+                                  std::vector<long long>& prev, int num_threads)
+{
+    const size_t n = trace.size();
+    prev.assign(n, -1);
+    dontdump_vec(prev);
+    const size_t chunk = (n + num_threads - 1) / num_threads;
+
+    struct ChunkKeys {
+        std::vector<std::pair<long long, size_t>> first;   // 블록 안 첫 접근 (key, pos)
+        std::unordered_map<long long, size_t> last;         // 블록 안 마지막 접근
+    };
+    std::vector<ChunkKeys> chunks(num_threads);
+
+    parallel_for(num_threads, [&](int c) {
+        const size_t lo = std::min(n, c * chunk), hi = std::min(n, lo + chunk);
+        auto& last = chunks[c].last;
+        last.reserve((hi - lo) / 8 + 1);
+        for (size_t i = lo; i < hi; ++i) {
+            auto it = last.find(trace[i]);
+            if (it == last.end()) {
+                chunks[c].first.emplace_back(trace[i], i);
+                last.emplace(trace[i], i);
+            } else {
+                prev[i] = static_cast<long long>(it->second);
+                it->second = i;
+            }
+        }
+    });
+
+    std::unordered_map<long long, size_t> global_last;
+    for (int c = 0; c < num_threads; ++c) {
+        for (const auto& kv : chunks[c].first) {
+            auto it = global_last.find(kv.first);
+            if (it != global_last.end()) prev[kv.second] = static_cast<long long>(it->second);
+        }
+        for (const auto& kv : chunks[c].last) global_last[kv.first] = kv.second;
+        ChunkKeys().first.swap(chunks[c].first);
+        std::unordered_map<long long, size_t>().swap(chunks[c].last);
+    }
+}
+
+struct ReuseEntry { long long val; size_t idx; };
+
+// val 기준 merge sort 하면서 오른쪽 원소마다 "왼쪽(더 앞)에서 val 이 더 큰 원소 수" 를 distances 에서 뺀다
+static void subtract_nested(ReuseEntry* a, ReuseEntry* tmp, size_t len,
+                            std::vector<long long>& distances, int depth)
+{
+    if (len <= 1) return;
+    const size_t mid = len / 2;
+    if (depth > 0 && len > (1u << 16)) {
+        std::thread left(subtract_nested, a, tmp, mid, std::ref(distances), depth - 1);
+        subtract_nested(a + mid, tmp + mid, len - mid, distances, depth - 1);
+        left.join();
+    } else {
+        subtract_nested(a, tmp, mid, distances, 0);
+        subtract_nested(a + mid, tmp + mid, len - mid, distances, 0);
+    }
+    size_t li = 0, ri = mid, o = 0;
+    while (li < mid && ri < len) {
+        if (a[li].val <= a[ri].val) {
+            tmp[o++] = a[li++];
+        } else {
+            distances[a[ri].idx] -= static_cast<long long>(mid - li);
+            tmp[o++] = a[ri++];
+        }
+    }
+    while (li < mid) tmp[o++] = a[li++];
+    while (ri < len) tmp[o++] = a[ri++];
+    std::copy(tmp, tmp + len, a);
+}
+
+static void compute_distances_parallel(const std::vector<long long>& trace,
+                                       AlgorithmType type,
+                                       std::vector<long long>& distances,
+                                       int num_threads)
+{
+    const size_t n = trace.size();
+    distances.assign(n, 0);
+    dontdump_vec(distances);
+
+    std::vector<long long> link;
+    compute_prev_parallel(trace, link, num_threads);
+    if (type == AlgorithmType::OPT) {
+        std::vector<long long> next(n, -1);
+        dontdump_vec(next);
+        parallel_for(num_threads, [&](int c) {
+            for (size_t i = c; i < n; i += num_threads) {
+                if (link[i] >= 0) next[(size_t)link[i]] = static_cast<long long>(i);
+            }
+        });
+        link.swap(next);
+    }
+
+    // 처리 순서 t (LRU: i, OPT: n-1-i) 에서의 reuse 구간 시작점 val
+    std::vector<ReuseEntry> entries;
+    entries.reserve(n);
+    for (size_t t = 0; t < n; ++t) {
+        const size_t i = (type == AlgorithmType::LRU) ? t : n - 1 - t;
+        const long long l = link[i];
+        if (l < 0) {
+            distances[i] = std::numeric_limits<long long>::max();
+            continue;
+        }
+        const long long val = (type == AlgorithmType::LRU) ? l : static_cast<long long>(n - 1) - l;
+        distances[i] = static_cast<long long>(t) - val;
+        entries.push_back({val, i});
+    }
+    std::vector<long long>().swap(link);
+    dontdump_vec(entries);
+
+    std::vector<ReuseEntry> tmp(entries.size());
+    dontdump_vec(tmp);
+    int depth = 0;
+    while ((1 << depth) < num_threads) ++depth;
+    subtract_nested(entries.data(), tmp.data(), entries.size(), distances, depth);
+}
+
+static void compute_distances_any(const std::vector<long long>& trace,
+                                  AlgorithmType type,
+                                  std::vector<long long>& distances,
+                                  int num_threads)
+{
+    if (num_threads > 1) compute_distances_parallel(trace, type, distances, num_threads);
+    else                 compute_distances(trace, type, distances);
+}
+
+static std::map<long long,double> mrc_from_bins(const std::vector<long long>& bins,
+                                                size_t total_accesses,
+                                                long long total_dataset_size,
+                                                long long bin_size)
+{
+    std::map<long long,double> mrc;
+    long long hit_cum = 0;
+    for (size_t b = 0; b < bins.size(); ++b) {
+        hit_cum += bins[b];
+        long long cache_blocks = (long long)(b + 1) * bin_size;
+        if (cache_blocks > total_dataset_size) cache_blocks = total_dataset_size;
+        long long miss_cnt = (long long)total_accesses - hit_cum;
+        mrc[cache_blocks] = (double)miss_cnt / (double)total_accesses;
+        if (cache_blocks == total_dataset_size) break;
+    }
+    return mrc;
+}
+
 // ===== 기존 단일 MRC =====
 std::map<long long, double>
 MrcCalculator::build_mrc_from_distances(const std::vector<long long>& distances,
@@ -146,7 +306,7 @@ MrcCalculator::calculate_mrc(const std::vector<long long>& trace,
                              int num_buckets)
 {
     std::vector<long long> distances;
-    compute_distances(trace, type, distances);
+    compute_distances_any(trace, type, distances, num_threads_);
     return build_mrc_from_distances(distances, trace.size(), total_dataset_size, num_buckets);
 }
 
@@ -164,13 +324,50 @@ MrcCalculator::calculate_mrc_intervals(const std::vector<long long>& trace,
 
     // 1) 거리 계산 1회
     std::vector<long long> distances;
-    compute_distances(trace, type, distances);
+    compute_distances_any(trace, type, distances, num_threads_);
 
     // 2) 히스토그램 누적하며 체크포인트마다 MRC 산출
     if (total_dataset_size <= 0) return out;
     long long bin_size = std::llround(std::ceil((double)total_dataset_size / num_buckets));
     if (bin_size <= 0) bin_size = 1;
 
+    if (num_threads_ > 1) {
+        // checkpoint 및 균등 분할 경계로 자른 구간마다 histogram 을 병렬로 만들고 순서대로 누적
+        std::vector<size_t> bounds;
+        for (size_t cp : checkpoints) bounds.push_back(std::min(cp, n));
+        for (int t = 1; t < num_threads_; ++t) bounds.push_back(n * t / num_threads_);
+        bounds.push_back(n);
+        std::sort(bounds.begin(), bounds.end());
+        bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+        std::vector<std::vector<long long>> seg_bins(bounds.size(), std::vector<long long>(num_buckets, 0));
+        parallel_for(num_threads_, [&](int t) {
+            for (size_t s = t; s < bounds.size(); s += num_threads_) {
+                const size_t lo = (s == 0) ? 0 : bounds[s - 1];
+                for (size_t i = lo; i < bounds[s]; ++i) {
+                    long long d = distances[i];
+                    if (d == std::numeric_limits<long long>::max()) continue;
+                    long long idx = (d - 1) / bin_size;
+                    if (idx < 0) idx = 0;
+                    if (idx >= num_buckets) idx = num_buckets - 1;
+                    ++seg_bins[s][(size_t)idx];
+                }
+            }
+        });
+
+        std::vector<long long> bins(num_buckets, 0);
+        size_t cp_idx = 0;
+        for (size_t s = 0; s < bounds.size() && cp_idx < checkpoints.size(); ++s) {
+            for (int b = 0; b < num_buckets; ++b) bins[b] += seg_bins[s][b];
+            while (cp_idx < checkpoints.size() && std::min(checkpoints[cp_idx], n) == bounds[s]) {
+                const size_t total_accesses = std::min(checkpoints[cp_idx], n);
+                out.emplace_back(total_accesses, mrc_from_bins(bins, total_accesses, total_dataset_size, bin_size));
+                ++cp_idx;
+            }
+        }
+        return out;
+    }
+
     std::vector<long long> bins(num_buckets, 0);
     size_t cp_idx = 0;
 
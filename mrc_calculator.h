@@ -12,6 +12,9 @@ enum class AlgorithmType {
 
 class MrcCalculator {
 public:
+    // num_threads > 1 이면 distance 계산과 checkpoint histogram 을 병렬로 수행 (결과는 동일)
+    explicit MrcCalculator(int num_threads = 1) : num_threads_(num_threads) {}
+
     std::map<long long,double> calculate_mrc(const std::vector<long long>& trace,
                                              long long total_dataset_size,
                                              AlgorithmType type, int num_buckets);
@@ -27,4 +30,7 @@ public:
                             long long total_dataset_size,
                             AlgorithmType type, int num_buckets,
                             const std::vector<size_t>& checkpoints);
+
+private:
+    int num_threads_;
 };
@@ -14,6 +14,7 @@
 
 #include "trace_parser.h"   // 제공된 파서 헤더
 #include "mrc_calculator.h"
+#include "mrc_streaming.h"
 
 template <typename T>
 static inline void dontdump_vec(std::vector<T>& v) {
@@ -45,7 +46,8 @@ static void print_usage() {
     std::cerr << "Usage: ./mrc_analyzer --file <trace_file.csv> --type <LRU|OPT> "
                  "--capacity <capacity_bytes> [--H <num_buckets>] "
                  "[--interval <write_bytes>] "
-                 "[--miss-out <outfile>] [--miss-append]\n";
+                 "[--miss-out <outfile>] [--miss-append] "
+                 "[--threads <n>] [--shards <rate> [--shards-max <keys>]]\n";
     std::cerr << "  --file       : Path to the trace file.\n";
     std::cerr << "  --type       : Algorithm type (LRU or OPT).\n";
     std::cerr << "  --capacity   : Cache capacity in bytes.\n";
@@ -54,6 +56,9 @@ static void print_usage() {
     std::cerr << "  --miss-out   : Output CSV file path (default: stdout).\n";
     std::cerr << "  --miss-append: Append to output file.\n";
     std::cerr << "  --trace-type : Trace format type for parser (csv, blktrace).\n";
+    std::cerr << "  --shards     : Streaming approximate LRU MRC with spatial sampling rate (e.g. 0.01).\n";
+    std::cerr << "  --shards-max : Fixed-size SHARDS: cap on tracked keys (0 = fixed rate).\n";
+    std::cerr << "  --threads    : Worker threads (exact: time-block partitions, --shards: key-space partitions).\n";
 }
 
 int main(int argc, char* argv[]) {
@@ -69,6 +74,11 @@ int main(int argc, char* argv[]) {
     std::string miss_out_path;
     bool miss_append = false;
 
+    // streaming (SHARDS) 모드
+    double shards_rate = 0.0;
+    uint64_t shards_max = 0;
+    int num_threads = 1;
+
     signal(SIGSEGV, signal_handler);
     signal(SIGABRT, signal_handler);
     signal(SIGFPE,  signal_handler);
@@ -93,6 +103,12 @@ int main(int argc, char* argv[]) {
             miss_append = true;
         } else if (arg == "--trace-type" && i + 1 < argc) {
             trace_type = argv[++i];
+        } else if (arg == "--shards" && i + 1 < argc) {
+            shards_rate = std::stod(argv[++i]);
+        } else if (arg == "--shards-max" && i + 1 < argc) {
+            shards_max = std::stoull(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            num_threads = std::stoi(argv[++i]);
         }
         else {
             std::cerr << "Unknown argument: " << arg << "\n";
@@ -121,6 +137,10 @@ int main(int argc, char* argv[]) {
         std::cerr << "Error: Number of buckets (--H) must be positive.\n";
         return 1;
     }
+    if (shards_rate > 0.0 && algo_type != AlgorithmType::LRU) {
+        std::cerr << "Error: --shards supports LRU only (OPT needs future knowledge).\n";
+        return 1;
+    }
 
     std::ifstream trace_file(file_path);
     if (!trace_file.is_open()) {
@@ -132,6 +152,23 @@ int main(int argc, char* argv[]) {
     constexpr uint64_t BLOCK_SIZE = 4096; // 4KB
     std::vector<long long> trace;
     std::string line;
+    long long axis_dataset_size_blocks = static_cast<long long>(capacity_bytes / BLOCK_SIZE);
+
+    // streaming 모드: trace 를 vector 에 담지 않고 sampling 된 key 만 추적
+    std::unique_ptr<StreamingMrc> streaming;
+    uint64_t blocks_per_interval = 0;
+    uint64_t next_checkpoint = 0;
+    if (shards_rate > 0.0) {
+        streaming = std::make_unique<StreamingMrc>(shards_rate, shards_max, axis_dataset_size_blocks,
+                                                   num_buckets, num_threads);
+        if (interval_bytes > 0) {
+            blocks_per_interval = (interval_bytes + BLOCK_SIZE - 1) / BLOCK_SIZE;
+            next_checkpoint = blocks_per_interval;
+        }
+        printf("streaming MRC: shards rate %.6f, max keys %lu, threads %d\n",
+               shards_rate, shards_max, num_threads);
+    }
+    uint64_t total_blocks = 0;
 
     std::cout << "Parsing and blockifying trace file...\n";
     printf("trace_type = %s\n", trace_type.c_str());
@@ -152,7 +189,15 @@ int main(int argc, char* argv[]) {
             uint64_t end_block   = (parsed.lba_offset + parsed.lba_size - 1) / BLOCK_SIZE;
 
             for (uint64_t block = start_block; block <= end_block; ++block) {
-                trace.push_back(static_cast<long long>(block));
+                if (streaming) {
+                    streaming->access(static_cast<long long>(block));
+                    if (++total_blocks == next_checkpoint) {
+                        streaming->checkpoint();
+                        next_checkpoint += blocks_per_interval;
+                    }
+                } else {
+                    trace.push_back(static_cast<long long>(block));
+                }
                 written_bytes += BLOCK_SIZE;
                 if (written_bytes >= byte_limit) { break_flag = true; break; }
             }
@@ -168,40 +213,48 @@ int main(int argc, char* argv[]) {
             break;
         }
     }
-    dontdump_vec(trace);
-    std::cout << "Total block accesses to analyze: " << trace.size() << "\n";
-    if (trace.empty()) {
-        std::cout << "No valid 'W' or 'WS' operations found in the trace.\n";
-        return 0;
-    }
-
-    // 3) 체크포인트(구간) 계산: interval_bytes→interval_blocks
-    std::vector<size_t> checkpoints; // 각 원소 = prefix 길이(액세스 수)
-    if (interval_bytes > 0) {
-        uint64_t blocks_per_interval =
-            (interval_bytes + BLOCK_SIZE - 1) / BLOCK_SIZE; // 올림
-        if (blocks_per_interval == 0) blocks_per_interval = 1;
-        for (uint64_t acc = blocks_per_interval; acc <= trace.size(); acc += blocks_per_interval) {
-            checkpoints.push_back(static_cast<size_t>(acc));
+    std::vector<std::pair<size_t, std::map<long long,double>>> series;
+    if (streaming) {
+        std::cout << "Total block accesses analyzed (streaming): " << total_blocks << "\n";
+        if (total_blocks == 0) {
+            std::cout << "No valid 'W' or 'WS' operations found in the trace.\n";
+            return 0;
         }
-        // 마지막이 딱 안 맞으면 끝도 포함
-        if (checkpoints.empty() || checkpoints.back() != trace.size())
-            checkpoints.push_back(trace.size());
+        series = streaming->finish();
     } else {
-        checkpoints.push_back(trace.size()); // 전체만
-    }
+        dontdump_vec(trace);
+        std::cout << "Total block accesses to analyze: " << trace.size() << "\n";
+        if (trace.empty()) {
+            std::cout << "No valid 'W' or 'WS' operations found in the trace.\n";
+            return 0;
+        }
 
-    // 4) MRC 계산 (구간 단위)
-    std::cout << "Calculating MRC (" << algo_str << "), H=" << num_buckets
-              << ", intervals=" << checkpoints.size() << "...\n";
+        // 3) 체크포인트(구간) 계산: interval_bytes→interval_blocks
+        std::vector<size_t> checkpoints; // 각 원소 = prefix 길이(액세스 수)
+        if (interval_bytes > 0) {
+            uint64_t blocks_per_interval =
+                (interval_bytes + BLOCK_SIZE - 1) / BLOCK_SIZE; // 올림
+            if (blocks_per_interval == 0) blocks_per_interval = 1;
+            for (uint64_t acc = blocks_per_interval; acc <= trace.size(); acc += blocks_per_interval) {
+                checkpoints.push_back(static_cast<size_t>(acc));
+            }
+            // 마지막이 딱 안 맞으면 끝도 포함
+            if (checkpoints.empty() || checkpoints.back() != trace.size())
+                checkpoints.push_back(trace.size());
+        } else {
+            checkpoints.push_back(trace.size()); // 전체만
+        }
 
-    MrcCalculator calculator;
+        // 4) MRC 계산 (구간 단위)
+        std::cout << "Calculating MRC (" << algo_str << "), H=" << num_buckets
+                  << ", intervals=" << checkpoints.size() << "...\n";
 
-    // 축의 최대 캐시 크기(블록)는 기존 코드와 동일하게 capacity 기준 유지
-    long long axis_dataset_size_blocks = static_cast<long long>(capacity_bytes / BLOCK_SIZE);
+        MrcCalculator calculator(num_threads);
 
-    auto series = calculator.calculate_mrc_intervals(
-        trace, axis_dataset_size_blocks, algo_type, num_buckets, checkpoints);
+        // 축의 최대 캐시 크기(블록)는 기존 코드와 동일하게 capacity 기준 유지
+        series = calculator.calculate_mrc_intervals(
+            trace, axis_dataset_size_blocks, algo_type, num_buckets, checkpoints);
+    }
 
     // 5) 출력
     std::ostream* out = &std::cout;
@@ -0,0 +1,223 @@
+#include "mrc_streaming.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <unordered_map>
+#include <ext/pb_ds/assoc_container.hpp>
+#include <ext/pb_ds/tree_policy.hpp>
+
+namespace {
+
+// order-statistic tree: 마지막 접근 시각 집합 → "t 이후에 접근된 key 수" 를 O(log n) 에 계산
+using TimeTree = __gnu_pbds::tree<uint64_t, __gnu_pbds::null_type, std::less<uint64_t>,
+                                  __gnu_pbds::rb_tree_tag,
+                                  __gnu_pbds::tree_order_statistics_node_update>;
+
+constexpr uint32_t HASH_BITS = 24;
+constexpr double   HASH_MOD  = static_cast<double>(1u << HASH_BITS);
+
+// splitmix64 finalizer
+inline uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+inline uint32_t sample_hash(uint64_t h) { return static_cast<uint32_t>(h >> (64 - HASH_BITS)); }
+
+} // namespace
+
+struct StreamingMrc::Partition {
+    // reader → worker queue
+    std::mutex mu;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::deque<std::vector<uint64_t>> queue;
+    bool done = false;
+    std::vector<uint64_t> pending;
+
+    // worker 상태
+    uint32_t threshold = 0;
+    uint64_t max_samples = 0;
+    uint64_t clock = 0;
+    struct Entry { uint64_t time; uint32_t hash; };
+    std::unordered_map<long long, Entry> last;
+    TimeTree times;
+    std::set<std::pair<uint32_t, long long>> by_hash;   // fixed-size 모드에서 evict 순서
+    // reuse distance histogram 과 sampled reference 수 (현재 rate 기준 raw count, rate 가 낮아지면 R'/R 로 rescale)
+    std::vector<double> bins;
+    double refs = 0.0;
+    struct Snapshot { std::vector<double> bins; double refs; double rate; };
+    std::vector<Snapshot> snapshots;                    // checkpoint 별
+};
+
+StreamingMrc::StreamingMrc(double sample_rate, uint64_t max_samples,
+                           long long total_dataset_size, int num_buckets, int num_threads)
+    : sample_rate_(sample_rate),
+      total_dataset_size_(total_dataset_size),
+      num_buckets_(num_buckets)
+{
+    bin_size_ = std::llround(std::ceil((double)total_dataset_size_ / num_buckets_));
+    if (bin_size_ <= 0) bin_size_ = 1;
+    threshold_ = static_cast<uint32_t>(std::min(1.0, sample_rate_) * HASH_MOD);
+    if (threshold_ == 0) threshold_ = 1;
+    if (num_threads <= 0) num_threads = 1;
+
+    const uint64_t per_part_max = max_samples ? std::max<uint64_t>(1, max_samples / num_threads) : 0;
+    for (int t = 0; t < num_threads; ++t) {
+        Partition* p = new Partition();
+        p->threshold = threshold_;
+        p->max_samples = per_part_max;
+        p->bins.assign(num_buckets_, 0.0);
+        p->pending.reserve(BATCH);
+        parts_.push_back(p);
+    }
+    for (Partition* p : parts_) {
+        workers_.emplace_back(&StreamingMrc::worker, this, p);
+    }
+}
+
+StreamingMrc::~StreamingMrc() {
+    if (!finished_) finish();
+    for (Partition* p : parts_) delete p;
+}
+
+void StreamingMrc::access(long long key) {
+    ++accesses_;
+    const uint64_t h = mix64(static_cast<uint64_t>(key));
+    if (sample_hash(h) >= threshold_) return;
+    Partition* p = parts_[static_cast<uint32_t>(h) % parts_.size()];
+    p->pending.push_back(static_cast<uint64_t>(key));
+    if (p->pending.size() >= BATCH) flush(p);
+}
+
+void StreamingMrc::checkpoint() {
+    checkpoints_.push_back(accesses_);
+    for (Partition* p : parts_) {
+        p->pending.push_back(CHECKPOINT_MARK);
+        flush(p);
+    }
+}
+
+void StreamingMrc::flush(Partition* p) {
+    if (p->pending.empty()) return;
+    std::unique_lock<std::mutex> lk(p->mu);
+    p->not_full.wait(lk, [&] { return p->queue.size() < MAX_QUEUED_BATCHES; });
+    p->queue.push_back(std::move(p->pending));
+    lk.unlock();
+    p->not_empty.notify_one();
+    p->pending = std::vector<uint64_t>();
+    p->pending.reserve(BATCH);
+}
+
+void StreamingMrc::worker(Partition* p) {
+    // partition 하나는 key 공간의 1/P, 그 중 threshold/2^24 만 sampling
+    const double part_frac = 1.0 / parts_.size();
+    for (;;) {
+        std::vector<uint64_t> batch;
+        {
+            std::unique_lock<std::mutex> lk(p->mu);
+            p->not_empty.wait(lk, [&] { return !p->queue.empty() || p->done; });
+            if (p->queue.empty()) return;
+            batch = std::move(p->queue.front());
+            p->queue.pop_front();
+        }
+        p->not_full.notify_one();
+
+        for (uint64_t raw : batch) {
+            if (raw == CHECKPOINT_MARK) {
+                p->snapshots.push_back({p->bins, p->refs, p->threshold / HASH_MOD});
+                continue;
+            }
+            const long long key = static_cast<long long>(raw);
+            const uint32_t u = sample_hash(mix64(raw));
+            if (u >= p->threshold) continue;   // fixed-size 모드에서 rate 가 낮아진 경우
+
+            // 거리는 partition 안의 key 만 세므로 rate * (1/P) 로 환산, 1/rate 배는 finish 에서
+            const double rate = p->threshold / HASH_MOD;
+            const double dist_rate = rate * part_frac;
+            p->refs += 1.0;
+            auto it = p->last.find(key);
+            if (it != p->last.end()) {
+                const uint64_t prev = it->second.time;
+                const uint64_t newer = p->times.size() - p->times.order_of_key(prev + 1);
+                long long idx = static_cast<long long>(newer / dist_rate) / bin_size_;
+                if (idx >= num_buckets_) idx = num_buckets_ - 1;
+                p->bins[(size_t)idx] += 1.0;
+                p->times.erase(prev);
+                it->second.time = p->clock;
+            } else {
+                p->last.emplace(key, Partition::Entry{p->clock, u});
+                if (p->max_samples) p->by_hash.emplace(u, key);
+            }
+            p->times.insert(p->clock);
+            ++p->clock;
+
+            // fixed-size SHARDS: 추적 key 수가 넘치면 hash 가 가장 큰 key 들을 버리고 rate 를 낮춘다.
+            // 지금까지의 count 는 옛 rate 로 모은 것이므로 R'/R 배 해서 새 rate 기준으로 맞춘다
+            while (p->max_samples && p->last.size() > p->max_samples) {
+                const uint32_t top = p->by_hash.rbegin()->first;
+                while (!p->by_hash.empty() && p->by_hash.rbegin()->first == top) {
+                    auto victim = std::prev(p->by_hash.end());
+                    auto lit = p->last.find(victim->second);
+                    p->times.erase(lit->second.time);
+                    p->last.erase(lit);
+                    p->by_hash.erase(victim);
+                }
+                const double scale = static_cast<double>(top) / p->threshold;
+                for (double& b : p->bins) b *= scale;
+                p->refs *= scale;
+                p->threshold = top;
+            }
+        }
+    }
+}
+
+std::vector<std::pair<size_t, std::map<long long,double>>> StreamingMrc::finish() {
+    std::vector<std::pair<size_t, std::map<long long,double>>> out;
+    if (finished_) return out;
+    if (checkpoints_.empty() || checkpoints_.back() != accesses_) checkpoint();
+    for (Partition* p : parts_) {
+        flush(p);
+        {
+            std::lock_guard<std::mutex> lk(p->mu);
+            p->done = true;
+        }
+        p->not_empty.notify_one();
+    }
+    for (auto& w : workers_) w.join();
+    finished_ = true;
+
+    // partition 별 partial histogram 을 checkpoint 마다 1/rate 로 환산해 합산.
+    // 분모는 sampled reference 로 추정한 access 수 (Σ refs / rate), 여기에 SHARDS_adj:
+    // 실제 access 수와의 차이 (= 기대보다 덜/더 뽑힌 reference) 를 거리 0 bucket 에 더한다
+    for (size_t c = 0; c < checkpoints_.size(); ++c) {
+        const size_t total_accesses = checkpoints_[c];
+        if (total_accesses == 0) continue;
+        std::vector<double> bins(num_buckets_, 0.0);
+        double refs = 0.0;
+        for (Partition* p : parts_) {
+            const Partition::Snapshot& s = p->snapshots[c];
+            for (int b = 0; b < num_buckets_; ++b) bins[b] += s.bins[b] / s.rate;
+            refs += s.refs / s.rate;
+        }
+        if (refs <= 0.0) continue;
+        const double adj = (double)total_accesses - refs;
+        bins[0] += adj;
+        const double denom = refs + adj;
+        std::map<long long,double> mrc;
+        double hit_cum = 0.0;
+        for (int b = 0; b < num_buckets_; ++b) {
+            hit_cum += bins[b];
+            long long cache_blocks = (long long)(b + 1) * bin_size_;
+            if (cache_blocks > total_dataset_size_) cache_blocks = total_dataset_size_;
+            double miss = 1.0 - hit_cum / denom;
+            mrc[cache_blocks] = std::min(1.0, std::max(0.0, miss));
+            if (cache_blocks == total_dataset_size_) break;
+        }
+        out.emplace_back(total_accesses, std::move(mrc));
+    }
+    return out;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ===== Streaming LRU MRC (SHARDS) =====
+// trace 를 메모리에 올리지 않고 block key 를 하나씩 access() 로 흘려보내면서
+// spatial hash sampling 된 key 들에 대해서만 LRU reuse distance 를 구한다.
+//  - sample_rate R : hash < R 인 key 만 추적 (fixed-rate SHARDS)
+//  - max_samples   : 0 이 아니면 추적 key 수를 고정 (fixed-size SHARDS),
+//                    넘치면 hash 가 가장 큰 key 부터 버리며 rate 를 낮춘다
+// key 공간을 hash 로 thread 수만큼 partition 해서 병렬로 처리하고,
+// checkpoint 마다 partition 별 histogram 을 합쳐서 MRC 를 만든다.
+class StreamingMrc {
+public:
+    StreamingMrc(double sample_rate, uint64_t max_samples,
+                 long long total_dataset_size, int num_buckets, int num_threads);
+    ~StreamingMrc();
+
+    void access(long long key);
+    // 지금까지 access 된 prefix 에 대한 MRC 를 checkpoint 로 남긴다
+    void checkpoint();
+    // 모든 worker 를 끝내고 checkpoint 별 MRC 반환 (prefix 길이, MRC)
+    std::vector<std::pair<size_t, std::map<long long,double>>> finish();
+
+private:
+    struct Partition;
+    static constexpr size_t BATCH = 1 << 14;
+    static constexpr size_t MAX_QUEUED_BATCHES = 16;
+    static constexpr uint64_t CHECKPOINT_MARK = UINT64_MAX;
+
+    void worker(Partition* p);
+    void flush(Partition* p);
+
+    double sample_rate_;
+    long long total_dataset_size_;
+    int num_buckets_;
+    long long bin_size_;
+    uint32_t threshold_;           // 초기 sampling threshold (24 bit)
+    std::vector<Partition*> parts_;
+    std::vector<std::thread> workers_;
+    std::vector<size_t> checkpoints_;  // 각 checkpoint 의 prefix 길이
+    size_t accesses_ = 0;
+    bool finished_ = false;
+};
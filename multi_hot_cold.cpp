@@ -1,9 +1,11 @@
 #include "multi_hot_cold.h"
+#include <algorithm>
 #include <cfloat>
+#include <climits>
 #include <cstring>
 
-int g_stream_cycles[IStream::MAX_STREAMS] = {0};
-uint64_t g_cycle_length = 0;
+thread_local int g_stream_cycles[IStream::MAX_STREAMS] = {0};
+thread_local uint64_t g_cycle_length = 0;
 
 MultiHotCold::MultiHotCold(int max_gc_streams, int timestamp_granularity, bool check_created_timestamp_only, bool classify_for_host_append, bool classfy_for_gc_append, int num_host_streams){
     mMaxGcStreams = max_gc_streams;
@@ -13,14 +15,16 @@ MultiHotCold::MultiHotCold(int max_gc_streams, int timestamp_granularity, bool c
     mClassifyForGcAppend = classfy_for_gc_append;
     mNumHostStreams = num_host_streams;
     mAvgLifespan = DBL_MAX;
-    mLba2Fifo = new FIFO();
-    mMetadata = new Metadata();
+    // Append 가 꺼져 있어 FIFO/Metadata 는 쓰지 않는다
+    mLba2Fifo = nullptr;
+    mMetadata = nullptr;
     std::memset(mStreamCycles, -1, sizeof(mStreamCycles));
     std::memset(g_stream_cycles, 0, sizeof(g_stream_cycles));
     g_cycle_length = (uint64_t)mTimestampGranularity * mMaxGcStreams;
 }
 
-extern uint64_t g_threshold;
+extern thread_local uint64_t g_threshold;
+extern thread_local uint64_t interval;
 
 int MultiHotCold::Classify(uint64_t blockAddr, bool isGcAppend, uint64_t global_timestamp, uint64_t created_timestamp) {
     uint64_t time_diff = global_timestamp - created_timestamp;
@@ -66,6 +70,23 @@ int MultiHotCold::Classify(uint64_t blockAddr, bool isGcAppend, uint64_t global_
     return stream_id + Segment::GC_STREAM_START;
 }
 
+// 실행 중 GC stream 수 / age interval 변경. 이미 GC stream 에 있는 segment 는 그대로 두고
+// 이후 relocation 부터 새 구성을 쓴다. create-timestamp 모드의 cycle 추적은 새 구성 기준으로 다시 시작
+// (is_old_cycle_segment 가 보는 interval / g_stream_cycles 도 함께 맞춘다)
+bool MultiHotCold::SetGcLayout(int num_gc_streams, uint64_t granularity) {
+    num_gc_streams = std::max(1, std::min(num_gc_streams, IStream::MAX_STREAMS - Segment::GC_STREAM_START));
+    granularity = std::max<uint64_t>(1, std::min<uint64_t>(granularity, INT_MAX));
+    if (num_gc_streams == mMaxGcStreams && (int)granularity == mTimestampGranularity) return false;
+    mMaxGcStreams = num_gc_streams;
+    mTimestampGranularity = (int)granularity;
+    std::memset(mStreamCycles, -1, sizeof(mStreamCycles));
+    mPendingVictimStreams.clear();
+    std::memset(g_stream_cycles, 0, sizeof(g_stream_cycles));
+    g_cycle_length = (uint64_t)mTimestampGranularity * mMaxGcStreams;
+    interval = (uint64_t)mTimestampGranularity;
+    return true;
+}
+
 int MultiHotCold::GetVictimStreamId(uint64_t global_timestamp, uint64_t threshold) {
     if (!mCheckCreatedTimestampOnly) return -1;
 
@@ -87,8 +108,8 @@ void MultiHotCold::Append(uint64_t blockAddr, uint64_t global_timestamp, void *a
 }
 
 void MultiHotCold::CollectSegment(Segment *segment, uint64_t global_timestamp) {
-  static uint64_t totLifespan = 0;
-  static int nCollects = 0;
+  static thread_local uint64_t totLifespan = 0;
+  static thread_local int nCollects = 0;
   if (segment->get_class_num() == 0) {
     //printf("CollectSegment: %lu, class_num: %d\n mAvgLifespan %f\n", segment->get_create_time(), segment->get_class_num(), mAvgLifespan);
     totLifespan += global_timestamp - segment->get_create_time();
@@ -6,8 +6,8 @@
 #include "fifo.h"
 #include "metadata.h"
 
-extern int g_stream_cycles[IStream::MAX_STREAMS];
-extern uint64_t g_cycle_length;  // = granularity * max_gc_streams
+extern thread_local int g_stream_cycles[IStream::MAX_STREAMS];
+extern thread_local uint64_t g_cycle_length;  // = granularity * max_gc_streams
 
 class MultiHotCold: public IStream {
 public:
@@ -18,6 +18,8 @@ public:
     void CollectSegment(Segment *segment, uint64_t global_timestamp) override;
     int GetVictimStreamId(uint64_t global_timestamp, uint64_t threshold) override;
     int getNumHostStreams() const override { return mNumHostStreams; }
+    int  getNumGcStreams() const override { return mMaxGcStreams; }
+    bool SetGcLayout(int num_gc_streams, uint64_t granularity) override;
 private:
     int mMaxGcStreams;
     int mTimestampGranularity;
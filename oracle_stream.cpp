@@ -0,0 +1,221 @@
+#include "oracle_stream.h"
+#include "trace_parser.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+thread_local bool g_oracle_trace_started = false;
+std::string g_oracle_sidecar_file;
+
+static const char ORACLE_MAGIC[8] = {'O', 'R', 'A', 'C', 'L', 'E', '1', '\0'};
+static constexpr std::size_t ORACLE_READ_BATCH = 1 << 16;
+
+/* ------------------------------------------------------------------ */
+/* pass 1 : sidecar 생성                                               */
+/* ------------------------------------------------------------------ */
+int write_oracle_sidecar(const std::string& trace_file, const std::string& trace_format,
+                         const std::string& rw_policy, int block_size, int lba_scale,
+                         const std::string& out_file)
+{
+    std::ifstream infile(trace_file);
+    if (!infile) {
+        std::cerr << "[oracle] cannot open trace: " << trace_file << std::endl;
+        return 1;
+    }
+    std::unique_ptr<ITraceParser> parser(createTraceParser(trace_format));
+
+    // issue_op_to_cache 와 동일한 block 분할 / 순서(std::map → block 오름차순)로 write block 나열
+    std::vector<uint64_t> keys;
+    std::string line;
+    uint64_t line_count = 0;
+    while (std::getline(infile, line)) {
+        if (++line_count % 10000000 == 0) {
+            printf("[oracle] pass1 decoded %lu lines, %zu block writes\n", line_count, keys.size());
+        }
+        ParsedRow parsed = parser->parseTrace(line);
+        if (parsed.dev_id.empty()) continue;
+        if (parsed.op_type != "W" && parsed.op_type != "WS") continue;
+        if (rw_policy != "all" && rw_policy != "write-only") continue;
+        parsed.lba_offset *= lba_scale;
+        parsed.lba_size   *= lba_scale;
+
+        const long long req_start = parsed.lba_offset;
+        const long long req_end   = parsed.lba_offset + parsed.lba_size;
+        const long start_block = static_cast<long>(req_start / block_size);
+        const long end_block   = static_cast<long>(req_end / block_size);
+        for (long block = start_block; block <= end_block; block++) {
+            long long left  = std::max<long long>(static_cast<long long>(block) * block_size, req_start);
+            long long right = std::min<long long>(static_cast<long long>(block + 1) * block_size, req_end);
+            if (right <= left) continue;
+            keys.push_back(static_cast<uint64_t>(block));
+        }
+    }
+
+    // 뒤에서부터 훑으면서 next occurrence 연결 (mrc_calculator 의 OPT next 와 같은 방식)
+    std::vector<uint64_t> next(keys.size(), ORACLE_NEVER);
+    std::unordered_map<uint64_t, uint64_t> seen;
+    seen.reserve(keys.size() / 4 + 1);
+    for (std::size_t i = keys.size(); i-- > 0;) {
+        auto it = seen.find(keys[i]);
+        if (it != seen.end()) {
+            next[i] = it->second;
+            it->second = i;
+        } else {
+            seen.emplace(keys[i], i);
+        }
+    }
+
+    FILE* fp = fopen(out_file.c_str(), "wb");
+    if (fp == nullptr) {
+        std::cerr << "[oracle] cannot open sidecar: " << out_file << std::endl;
+        return 1;
+    }
+    OracleSidecarHeader hdr;
+    std::memcpy(hdr.magic, ORACLE_MAGIC, sizeof(hdr.magic));
+    hdr.block_size   = static_cast<uint64_t>(block_size);
+    hdr.record_count = keys.size();
+    hdr.first_count  = seen.size();
+    fwrite(&hdr, sizeof(hdr), 1, fp);
+
+    std::vector<OracleRecord> buf;
+    buf.reserve(ORACLE_READ_BATCH);
+    uint64_t never_cnt = 0;
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        if (next[i] == ORACLE_NEVER) ++never_cnt;
+        buf.push_back({keys[i], next[i]});
+        if (buf.size() == ORACLE_READ_BATCH) {
+            fwrite(buf.data(), sizeof(OracleRecord), buf.size(), fp);
+            buf.clear();
+        }
+    }
+    for (auto& [key, first] : seen) {
+        buf.push_back({key, first});
+        if (buf.size() == ORACLE_READ_BATCH) {
+            fwrite(buf.data(), sizeof(OracleRecord), buf.size(), fp);
+            buf.clear();
+        }
+    }
+    if (!buf.empty()) fwrite(buf.data(), sizeof(OracleRecord), buf.size(), fp);
+    fclose(fp);
+
+    printf("[oracle] sidecar %s: %zu block writes, %zu unique blocks, %lu never rewritten\n",
+           out_file.c_str(), keys.size(), seen.size(), never_cnt);
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* pass 2 : OracleStream                                              */
+/* ------------------------------------------------------------------ */
+OracleStream::OracleStream(const std::string& sidecar_file, uint64_t cache_block_count, uint64_t keep_blocks)
+    : cache_block_count_(cache_block_count ? cache_block_count : 1),
+      keep_blocks_(std::min(keep_blocks ? keep_blocks : cache_block_count_, cache_block_count_))
+{
+    fp_ = fopen(sidecar_file.c_str(), "rb");
+    if (fp_ == nullptr) {
+        std::cerr << "[oracle] cannot open sidecar: " << sidecar_file << std::endl;
+        throw std::runtime_error("OracleStream: no sidecar");
+    }
+    OracleSidecarHeader hdr;
+    if (fread(&hdr, sizeof(hdr), 1, fp_) != 1 || std::memcmp(hdr.magic, ORACLE_MAGIC, sizeof(hdr.magic)) != 0) {
+        throw std::runtime_error("OracleStream: bad sidecar header");
+    }
+    records_left_ = hdr.record_count;
+
+    // key 별 첫 write 순번을 먼저 읽어서 prefill / 첫 write 전 GC 에 사용
+    long records_end = static_cast<long>(sizeof(hdr) + hdr.record_count * sizeof(OracleRecord));
+    fseek(fp_, records_end, SEEK_SET);
+    next_write_.reserve(hdr.first_count);
+    std::vector<OracleRecord> tmp(ORACLE_READ_BATCH);
+    uint64_t left = hdr.first_count;
+    while (left > 0) {
+        std::size_t n = fread(tmp.data(), sizeof(OracleRecord), std::min<uint64_t>(left, tmp.size()), fp_);
+        if (n == 0) throw std::runtime_error("OracleStream: truncated sidecar");
+        for (std::size_t i = 0; i < n; i++) next_write_[tmp[i].key] = tmp[i].next;
+        left -= n;
+    }
+    fseek(fp_, sizeof(hdr), SEEK_SET);
+    printf("[oracle] sidecar %s: %lu block writes, %lu unique blocks, block_size %lu\n",
+           sidecar_file.c_str(), hdr.record_count, hdr.first_count, hdr.block_size);
+}
+
+OracleStream::~OracleStream()
+{
+    if (fp_) fclose(fp_);
+}
+
+bool OracleStream::next_record(OracleRecord& rec)
+{
+    if (buf_pos_ == buf_.size()) {
+        if (records_left_ == 0) return false;
+        buf_.resize(std::min<uint64_t>(records_left_, ORACLE_READ_BATCH));
+        std::size_t n = fread(buf_.data(), sizeof(OracleRecord), buf_.size(), fp_);
+        buf_.resize(n);
+        buf_pos_ = 0;
+        records_left_ = n ? records_left_ - n : 0;
+        if (n == 0) return false;
+    }
+    rec = buf_[buf_pos_++];
+    return true;
+}
+
+uint64_t OracleStream::NextWrite(uint64_t blockAddr) const
+{
+    auto it = next_write_.find(blockAddr);
+    return it == next_write_.end() ? ORACLE_NEVER : it->second;
+}
+
+// 남은 lifetime 을 cache 크기 기준 배수 구간으로 나눈다: <C/8, <C/4, <C/2, <C, <2C, 그 이상
+int OracleStream::lifetime_class(uint64_t next) const
+{
+    if (next == ORACLE_NEVER) return NEVER_STREAM;
+    const uint64_t remain = next > now_ ? next - now_ : 0;
+    uint64_t bound = cache_block_count_ / 8;
+    for (int c = 0; c < NUM_LIFETIME_CLASSES - 1; c++) {
+        if (remain < bound) return c;
+        bound *= 2;
+    }
+    return NUM_LIFETIME_CLASSES - 1;
+}
+
+int OracleStream::Classify(uint64_t blockAddr, bool isGcAppend, uint64_t global_timestamp, uint64_t created_timestamp)
+{
+    if (isGcAppend) {
+        return lifetime_class(NextWrite(blockAddr)) + Segment::GC_STREAM_START;
+    }
+    if (!g_oracle_trace_started) {
+        // prefill write: trace 의 첫 write 까지가 lifetime
+        return lifetime_class(NextWrite(blockAddr));
+    }
+
+    OracleRecord rec;
+    if (!next_record(rec)) {
+        next_write_[blockAddr] = ORACLE_NEVER;
+        return NEVER_STREAM;
+    }
+    if (rec.key != blockAddr) {
+        // 한 번 어긋나면 이후 모든 stream / next write 가 틀리므로 계속 돌리지 않는다
+        printf("[oracle] sidecar mismatch at %lu: expected %lu got %lu\n", now_, rec.key, blockAddr);
+        throw std::runtime_error("OracleStream: host writes do not follow the sidecar order");
+    }
+    next_write_[blockAddr] = rec.next;
+    int cls = lifetime_class(rec.next);
+    ++now_;
+    return cls;
+}
+
+// 다시 쓰이지 않거나 마지막 lifetime 구간(>= 2C) 이후에야 쓰일 block 은 relocate 하지 않고 내린다.
+// KEEP 은 keep_blocks_ 안에 다시 쓰일 block 에만 준다: 앞으로 N 번의 write 가 덮는 key 는 N 개 이하라
+// KEEP 집합이 keep_blocks_ (<= C) 를 넘지 않고, GC 가 항상 내릴 block 을 찾는다.
+// 그 밖 (C 근처 ~ 2C, 또는 예측한 write 시각이 이미 지난 block) 은 보통의 age threshold 에 맡긴다.
+IStream::EvictHint OracleStream::GetEvictHint(uint64_t blockAddr, uint64_t global_timestamp)
+{
+    const uint64_t next = NextWrite(blockAddr);
+    if (next != ORACLE_NEVER && next < now_) return EvictHint::NONE;
+    if (lifetime_class(next) >= NUM_LIFETIME_CLASSES - 1) return EvictHint::EVICT;
+    return next - now_ < keep_blocks_ ? EvictHint::KEEP : EvictHint::NONE;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "istream.h"
+
+// ===== Oracle (next-write-time) placement =====
+// pass 1 (write_oracle_sidecar): trace 의 block write 마다 "다음 overwrite 시각"
+//   (block write 순번, 없으면 ORACLE_NEVER) 을 sidecar 파일로 남긴다.
+// pass 2 (OracleStream): sidecar 를 trace 순서대로 따라가며 host write / GC relocation 을
+//   실제 남은 lifetime 구간별 stream 에 배치한다. WAF 하한(upper-bound placement) 측정용.
+//   host write 가 sidecar 와 1:1 로 맞아야 하므로 어긋나면 예외로 멈춘다 (bypass / admission /
+//   write buffer / mini_sim / TIERED 와의 조합은 cache_sim 이 미리 거절한다)
+//
+// sidecar 형식 (little endian, binary)
+//   header  : OracleSidecarHeader
+//   records : {key, next} x record_count   (trace write 순서)
+//   firsts  : {key, first} x first_count   (key 별 첫 write 순번, prefill 용)
+
+static constexpr uint64_t ORACLE_NEVER = UINT64_MAX;
+
+struct OracleSidecarHeader {
+    char     magic[8];          // "ORACLE1\0"
+    uint64_t block_size;
+    uint64_t record_count;
+    uint64_t first_count;
+};
+
+struct OracleRecord {
+    uint64_t key;
+    uint64_t next;
+};
+
+// prefill 이 끝나고 trace replay 가 시작되면 cache_sim 이 true 로 세팅.
+// 그 전의 host write(prefill) 는 sidecar 순번을 소비하지 않는다.
+extern thread_local bool g_oracle_trace_started;
+// LOG_ORACLE 이 읽을 sidecar 경로 (cache_sim --oracle)
+extern std::string g_oracle_sidecar_file;
+
+int write_oracle_sidecar(const std::string& trace_file, const std::string& trace_format,
+                         const std::string& rw_policy, int block_size, int lba_scale,
+                         const std::string& out_file);
+
+class OracleStream : public IStream {
+public:
+    // host stream 수 = lifetime 구간 수 + never stream
+    static constexpr int NUM_LIFETIME_CLASSES = 6;
+    static constexpr int NEVER_STREAM = NUM_LIFETIME_CLASSES;
+
+    // keep_blocks: GetEvictHint 가 KEEP 을 줄 다음 write 거리 상한 (0 이면 cache_block_count)
+    OracleStream(const std::string& sidecar_file, uint64_t cache_block_count, uint64_t keep_blocks = 0);
+    ~OracleStream();
+
+    int  Classify(uint64_t blockAddr, bool isGcAppend, uint64_t global_timestamp, uint64_t created_timestamp) override;
+    void Append(uint64_t blockAddr, uint64_t global_timestamp, void *arg) override {}
+    void GcAppend(uint64_t blockAddr) override {}
+    void CollectSegment(Segment *segment, uint64_t global_timestamp) override {}
+    EvictHint GetEvictHint(uint64_t blockAddr, uint64_t global_timestamp) override;
+    int  getNumHostStreams() const override { return NUM_LIFETIME_CLASSES + 1; }
+
+    // key 의 다음 write 순번 (없으면 ORACLE_NEVER)
+    uint64_t NextWrite(uint64_t blockAddr) const;
+
+private:
+    bool next_record(OracleRecord& rec);
+    int  lifetime_class(uint64_t next) const;
+
+    FILE* fp_ = nullptr;
+    std::vector<OracleRecord> buf_;
+    std::size_t buf_pos_ = 0;
+    uint64_t records_left_ = 0;
+    uint64_t now_ = 0;                              // 소비한 trace block write 수
+    uint64_t cache_block_count_;
+    uint64_t keep_blocks_;                          // 이 거리 안에 다시 쓰일 block 만 KEEP (<= cache 크기)
+    std::unordered_map<uint64_t, uint64_t> next_write_;
+};
@@ -4,15 +4,16 @@
 #include "fifo.h"
 #include "metadata.h"
 
-SepBIT::SepBIT() {
+SepBIT::SepBIT(uint64_t lba_space_blocks) {
     mAvgLifespan = DBL_MAX;
     mClassNumOfLastCollectedSegment = 0;
-    mLba2Fifo = new FIFO();
-    mMetadata = new Metadata();
+    mLba2Fifo = new FIFO(lba_space_blocks);
+    // Metadata 는 blockAddr 를 offset 으로 받는다 (4096 개 block 이 한 칸)
+    mMetadata = new Metadata(lba_space_blocks);
 }
 
 int SepBIT::Classify(uint64_t blockAddr, bool isGcAppend, uint64_t global_timestamp, uint64_t created_timestamp) {
-  static uint64_t hot = 0, cold = 0;
+  static thread_local uint64_t hot = 0, cold = 0;
   if (!isGcAppend) {
     uint64_t lifespan = mLba2Fifo->Query(blockAddr);
     if (lifespan != UINT64_MAX && lifespan < mAvgLifespan) {
@@ -41,8 +42,8 @@ int SepBIT::Classify(uint64_t blockAddr, bool isGcAppend, uint64_t global_timest
 }
 
 void SepBIT::CollectSegment(Segment *segment, uint64_t global_timestamp) {
-  static uint64_t totLifespan = 0;
-  static int nCollects = 0;
+  static thread_local uint64_t totLifespan = 0;
+  static thread_local int nCollects = 0;
   if (segment->get_class_num() == 0) {
     //printf("CollectSegment: %lu, class_num: %d\n mAvgLifespan %f\n", segment->get_create_time(), segment->get_class_num(), mAvgLifespan);
     totLifespan += global_timestamp - segment->get_create_time();
@@ -9,7 +9,7 @@ class Metadata;
 
 class SepBIT: public IStream {
   public:
-    SepBIT();
+    explicit SepBIT(uint64_t lba_space_blocks = 0);
     int  Classify(uint64_t blockAddr, bool isGcAppend, uint64_t global_timestamp, uint64_t created_timestamp) override;
     void Append(uint64_t blockAddr, uint64_t global_timestamp, void *arg) override;
     void GcAppend(uint64_t blockAddr) override;
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+// ===== 순차 write stream 감지 =====
+// volume 마다 최근 stream 의 끝(다음에 올 block)만 TAILS 개 들고, 요청이 어떤 끝에서 바로 이어지면 그 stream 의 run 을 늘린다.
+// 이어지는 끝이 없으면 그 volume 에서 가장 오래 안 쓰인 칸을 새 stream 으로 쓴다.
+// volume 별로 표를 나누므로 주소 구간이 겹치는 volume 끼리 (trace_remap 안 한 trace) stream 이 섞이거나 칸을 뺏지 않는다.
+class SeqDetector {
+public:
+    static constexpr int TAILS = 32;
+
+    // volume 의 요청 [start, start + blocks) 를 반영하고 이 요청을 포함한 stream 의 run 길이 (block) 를 돌려준다
+    uint64_t observe(int volume, uint64_t start, uint64_t blocks)
+    {
+        ++clock_;
+        std::array<Tail, TAILS>& tails = tables_[volume];
+        Tail* victim = &tails[0];
+        for (Tail& t : tails) {
+            if (t.run > 0 && t.next == start) {
+                t.next = start + blocks;
+                t.run += blocks;
+                t.last_use = clock_;
+                return t.run;
+            }
+            if (t.last_use < victim->last_use) victim = &t;
+        }
+        *victim = {start + blocks, blocks, clock_};
+        return blocks;
+    }
+
+private:
+    struct Tail {
+        uint64_t next = 0;       // stream 이 이어지면 다음에 올 block
+        uint64_t run = 0;        // 지금까지 연속으로 쓴 block 수 (0 = 빈 칸)
+        uint64_t last_use = 0;
+    };
+    std::unordered_map<int, std::array<Tail, TAILS>> tables_;   // volume → tail 표
+    uint64_t clock_ = 0;
+};
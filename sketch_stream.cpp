@@ -0,0 +1,171 @@
+#include "sketch_stream.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+
+int  g_sketch_mb = 64;
+bool g_sketch_accuracy = false;
+
+namespace {
+constexpr uint64_t kRowSeed[4] = {0x9e3779b97f4a7c15ull, 0xc2b2ae3d27d4eb4full,
+                                  0x165667b19e3779f9ull, 0xd6e8feb86659fd93ull};
+
+inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+// top-k 한 entry 의 대략적인 비용 (entry + hash map node)
+constexpr uint64_t kTopEntryBytes = sizeof(uint64_t) * 3 + 48;
+}
+
+SketchStream::SketchStream(uint64_t budget_bytes, uint64_t window_blocks, bool shadow_sepbit)
+    : window_blocks_(std::max<uint64_t>(1, window_blocks)), avg_lifespan_(DBL_MAX)
+{
+    // 1/8 은 top-k, 나머지는 sketch 두 개 (column 당 ROWS x (2 + 4) B)
+    uint64_t topk_bytes = budget_bytes / 8;
+    topk_cap_ = std::max<uint64_t>(16, topk_bytes / kTopEntryBytes);
+    width_ = std::max<uint64_t>(1024, (budget_bytes - topk_bytes) / (ROWS * (sizeof(uint16_t) + sizeof(uint32_t))));
+    freq_.assign(ROWS * width_, 0);
+    recent_.assign(ROWS * width_, 0);
+    topk_.reserve(topk_cap_);
+    topk_idx_.reserve(topk_cap_);
+    if (shadow_sepbit) shadow_.emplace(0);
+    printf("sketch_stream: budget=%lu MB width=%lu x %d rows, top-k=%zu, decay window=%lu blocks%s\n",
+           budget_bytes >> 20, width_, ROWS, topk_cap_, window_blocks_,
+           shadow_ ? ", exact SepBIT shadow on" : "");
+}
+
+SketchStream::~SketchStream()
+{
+    print_accuracy();
+}
+
+uint64_t SketchStream::slot(int row, uint64_t key) const
+{
+    return row * width_ + mix64(key ^ kRowSeed[row]) % width_;
+}
+
+// 마지막 write 시각 추정 (없으면 NEVER). top-k 에 있으면 정확한 값
+uint64_t SketchStream::last_write(uint64_t key) const
+{
+    auto it = topk_idx_.find(key);
+    if (it != topk_idx_.end()) return topk_[it->second].last_write;
+    uint32_t m = UINT32_MAX;
+    for (int r = 0; r < ROWS; r++) m = std::min(m, recent_[slot(r, key)]);
+    if (m == 0) return NEVER;
+    return static_cast<uint64_t>(m - 1) << TIME_SHIFT;
+}
+
+// 가득 찼으면 entry TOPK_SAMPLES 개를 골라 count 최솟값보다 sketch 추정치가 크면 그것과 바꾼다
+void SketchStream::topk_update(uint64_t key, uint32_t est, uint64_t now)
+{
+    auto it = topk_idx_.find(key);
+    if (it != topk_idx_.end()) {
+        TopEntry& e = topk_[it->second];
+        e.count = std::max(e.count + 1, est);
+        e.last_write = now;
+        return;
+    }
+    if (topk_.size() < topk_cap_) {
+        topk_idx_[key] = static_cast<uint32_t>(topk_.size());
+        topk_.push_back({key, est, now});
+        return;
+    }
+    std::size_t victim = 0;
+    uint32_t victim_count = UINT32_MAX;
+    for (int i = 0; i < TOPK_SAMPLES; i++) {
+        rng_ = rng_ * 6364136223846793005ull + 1442695040888963407ull;
+        std::size_t j = (rng_ >> 33) % topk_.size();
+        if (topk_[j].count < victim_count) {
+            victim = j;
+            victim_count = topk_[j].count;
+        }
+    }
+    if (est <= victim_count) return;
+    topk_idx_.erase(topk_[victim].key);
+    topk_[victim] = {key, est, now};
+    topk_idx_[key] = static_cast<uint32_t>(victim);
+}
+
+void SketchStream::decay()
+{
+    for (uint16_t& c : freq_) c >>= 1;
+    for (TopEntry& e : topk_) e.count >>= 1;
+}
+
+void SketchStream::print_accuracy() const
+{
+    if (!shadow_) return;
+    uint64_t total = agree_[0][0] + agree_[0][1] + agree_[1][0] + agree_[1][1];
+    if (total == 0) return;
+    printf("sketch_stream: host writes=%lu agree=%.2f%% (hot/hot %lu cold/cold %lu, sketch hot & sepbit cold %lu, "
+           "sketch cold & sepbit hot %lu)\n",
+           total, 100.0 * (agree_[0][0] + agree_[1][1]) / total, agree_[0][0], agree_[1][1], agree_[0][1], agree_[1][0]);
+}
+
+int SketchStream::Classify(uint64_t blockAddr, bool isGcAppend, uint64_t global_timestamp, uint64_t created_timestamp)
+{
+    if (isGcAppend) {
+        if (last_collected_class_ == 0) return 2 + Segment::GC_STREAM_START;
+        uint64_t age = global_timestamp - created_timestamp;
+        if (age < 4 * avg_lifespan_) return 3 + Segment::GC_STREAM_START;
+        if (age < 16 * avg_lifespan_) return 4 + Segment::GC_STREAM_START;
+        return 5 + Segment::GC_STREAM_START;
+    }
+    // SepBIT FIFO 에서 빠진 LBA 는 UINT32_MAX 로 본다 (평균 lifespan 이 나오기 전엔 전부 hot)
+    uint64_t last = last_write(blockAddr);
+    uint64_t lifespan = UINT32_MAX;
+    if (last != NEVER && host_writes_ - last <= fifo_len_) lifespan = host_writes_ - last;
+    int cls = lifespan < avg_lifespan_ ? 0 : 1;
+    if (shadow_) {
+        int exact = shadow_->Classify(blockAddr, false, global_timestamp, created_timestamp);
+        ++agree_[cls][exact == 0 ? 0 : 1];
+    }
+    return cls;
+}
+
+void SketchStream::Append(uint64_t blockAddr, uint64_t global_timestamp, void *arg)
+{
+    if (shadow_) shadow_->Append(blockAddr, global_timestamp, arg);
+    double valid_blocks = static_cast<double>(reinterpret_cast<uint64_t>(arg));
+    if (++fifo_len_ > std::min(avg_lifespan_, valid_blocks)) {
+        --fifo_len_;
+        if (fifo_len_ > avg_lifespan_) --fifo_len_;
+    }
+    uint64_t now = host_writes_;
+    uint32_t t = static_cast<uint32_t>(now >> TIME_SHIFT) + 1;
+    uint32_t est = UINT16_MAX;
+    for (int r = 0; r < ROWS; r++) {
+        uint64_t s = slot(r, blockAddr);
+        if (freq_[s] < UINT16_MAX) ++freq_[s];
+        est = std::min<uint32_t>(est, freq_[s]);
+        recent_[s] = t;
+    }
+    topk_update(blockAddr, est, now);
+
+    if (++host_writes_ % window_blocks_ == 0) {
+        decay();
+        print_accuracy();
+    }
+}
+
+// SepBIT 과 같은 평균 lifespan (class 0 segment 16 개 평균)
+void SketchStream::CollectSegment(Segment *segment, uint64_t global_timestamp)
+{
+    if (shadow_) shadow_->CollectSegment(segment, global_timestamp);
+    if (segment->get_class_num() == 0) {
+        tot_lifespan_ += global_timestamp - segment->get_create_time();
+        n_collects_ += 1;
+    }
+    if (n_collects_ == 16) {
+        avg_lifespan_ = 1.0 * tot_lifespan_ / n_collects_;
+        n_collects_ = 0;
+        tot_lifespan_ = 0;
+    }
+    last_collected_class_ = segment->get_class_num();
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "istream.h"
+#include "sepbit.h"
+
+// ===== 고정 메모리 write 빈도/최근성 분류 =====
+// LBA 범위와 상관없이 --sketch_mb 안에서 동작하는 SepBIT 대체.
+//  - 빈도: decaying count-min sketch (uint16, window 마다 반감)
+//  - 최근성: 같은 hash 의 마지막 write 시각 sketch (host write 수 기준, 충돌은 시각을 늦추기만 하므로 row 최솟값)
+//  - top-k: 빈도 상위 LBA 는 정확한 마지막 write 시각을 따로 든다 (sample 한 최솟값과 교체)
+// host write: SepBIT 과 같은 기준. FIFO 는 길이만 흉내내서 (min(평균 lifespan, valid 수)),
+//             추정 lifespan 이 FIFO 안이고 평균 lifespan 보다 짧으면 hot
+// GC write  : SepBIT 과 같은 age 구간, age 는 LogCache 가 넘기는 block 생성 시각으로 계산
+// --sketch_accuracy: 정확한 per-LBA 상태의 SepBIT 을 같이 돌려 host 분류 일치율을 출력
+class SketchStream : public IStream {
+public:
+    SketchStream(uint64_t budget_bytes, uint64_t window_blocks, bool shadow_sepbit);
+    ~SketchStream();
+
+    int  Classify(uint64_t blockAddr, bool isGcAppend, uint64_t global_timestamp, uint64_t created_timestamp) override;
+    void Append(uint64_t blockAddr, uint64_t global_timestamp, void *arg) override;
+    void GcAppend(uint64_t blockAddr) override {}
+    void CollectSegment(Segment *segment, uint64_t global_timestamp) override;
+
+private:
+    static constexpr int ROWS = 4;
+    static constexpr int TIME_SHIFT = 2;      // 최근성 sketch 시각 단위 (4 host write), uint32 로 16G write 까지
+    static constexpr uint64_t NEVER = UINT64_MAX;
+    static constexpr int TOPK_SAMPLES = 8;
+
+    struct TopEntry {
+        uint64_t key;
+        uint32_t count;
+        uint64_t last_write;
+    };
+
+    uint64_t slot(int row, uint64_t key) const;
+    uint64_t last_write(uint64_t key) const;
+    void     topk_update(uint64_t key, uint32_t est, uint64_t now);
+    void     decay();
+    void     print_accuracy() const;
+
+    uint64_t width_;
+    std::vector<uint16_t> freq_;              // ROWS x width_
+    std::vector<uint32_t> recent_;            // ROWS x width_, (timestamp >> TIME_SHIFT) + 1
+    std::size_t topk_cap_;
+    std::vector<TopEntry> topk_;
+    std::unordered_map<uint64_t, uint32_t> topk_idx_;
+    uint64_t rng_ = 1;
+
+    uint64_t window_blocks_;
+    uint64_t host_writes_ = 0;                // 최근성 시계
+    uint64_t fifo_len_ = 0;                   // SepBIT FIFO 가 지금 들고 있을 길이
+    double   avg_lifespan_;
+    uint64_t tot_lifespan_ = 0;
+    int      n_collects_ = 0;
+    uint64_t last_collected_class_ = 0;
+
+    std::optional<SepBIT> shadow_;
+    uint64_t agree_[2][2] = {};               // [sketch][sepbit], 0 = hot
+};
+
+// cache_sim --sketch_mb, --sketch_accuracy
+extern int  g_sketch_mb;
+extern bool g_sketch_accuracy;
@@ -0,0 +1,271 @@
+#include "tiered_cache.h"
+
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+
+std::string g_tiers;
+
+extern thread_local double g_segment_scale;
+extern thread_local bool g_detached_cold_ftl;
+
+namespace {
+// "8G", "512M", "65536" → bytes
+bool parse_bytes(const std::string& s, uint64_t& out)
+{
+    if (s.empty()) return false;
+    std::size_t pos = 0;
+    double v = 0.0;
+    try {
+        v = std::stod(s, &pos);
+    } catch (...) {
+        return false;
+    }
+    uint64_t mul = 1;
+    if (pos < s.size()) {
+        if (pos + 1 != s.size()) return false;
+        switch (s[pos]) {
+        case 'K': case 'k': mul = 1ull << 10; break;
+        case 'M': case 'm': mul = 1ull << 20; break;
+        case 'G': case 'g': mul = 1ull << 30; break;
+        default: return false;
+        }
+    }
+    if (v <= 0.0) return false;
+    out = static_cast<uint64_t>(v * mul);
+    return true;
+}
+}
+
+bool TieredCache::parse_tiers(const std::string& spec, std::vector<TierSpec>& out, std::string& error)
+{
+    out.clear();
+    int midas_tiers = 0;
+    std::stringstream ss(spec);
+    std::string tok;
+    while (std::getline(ss, tok, ',')) {
+        if (tok.empty()) continue;
+        std::vector<std::string> fields;
+        std::stringstream ts(tok);
+        std::string f;
+        while (std::getline(ts, f, ':')) fields.push_back(f);
+        if (fields.size() < 2 || fields.size() > 3) {
+            error = "expected TYPE:SIZE[:SEG_SCALE], got '" + tok + "'";
+            return false;
+        }
+        TierSpec t;
+        t.cache_type = fields[0];
+        if (t.cache_type == "TIERED") {
+            error = "TIERED cannot be nested";
+            return false;
+        }
+        // 아래 tier 는 위 tier 의 새 write 를 trim 으로 받아 자기 옛 copy 를 버려야 한다 (LRU/FIFO 는 그 경로가 없다)
+        if (t.cache_type.compare(0, 4, "LOG_") != 0 && t.cache_type != "FAIRYWREN" && t.cache_type != "MIDAS_CACHE") {
+            error = "tier type '" + t.cache_type + "' cannot drop stale copies on trim";
+            return false;
+        }
+        if (t.cache_type == "MIDAS_CACHE" && ++midas_tiers > 1) {
+            error = "only one MIDAS_CACHE tier is supported";
+            return false;
+        }
+        if (!parse_bytes(fields[1], t.capacity_bytes)) {
+            error = "bad tier size '" + fields[1] + "'";
+            return false;
+        }
+        if (fields.size() == 3) {
+            try {
+                t.segment_scale = std::stod(fields[2]);
+            } catch (...) {
+                t.segment_scale = 0.0;
+            }
+            if (t.segment_scale <= 0.0) {
+                error = "bad segment scale '" + fields[2] + "'";
+                return false;
+            }
+        }
+        out.push_back(t);
+    }
+    if (out.empty()) {
+        error = "no tiers given";
+        return false;
+    }
+    return true;
+}
+
+TieredCache::TieredCache(uint64_t cold_capacity, int cache_block_size, const std::vector<TierSpec>& specs,
+                         const std::string& waf_log_file, const std::string& stat_log_file)
+    : ICache(cold_capacity, waf_log_file, stat_log_file),
+      cache_block_size_(cache_block_size),
+      specs_(specs),
+      pending_(specs.size()),
+      evict_bytes_(specs.size(), 0),
+      next_stats_bytes_(STATS_PRINT_INTERVAL)
+{
+    assert(!specs_.empty());
+    const std::string ts = get_timestamp();
+    const double saved_scale = g_segment_scale;
+    for (std::size_t i = 0; i < specs_.size(); ++i) {
+        const TierSpec& t = specs_[i];
+        std::string tier_waf = waf_log_file + ".tier" + std::to_string(i);
+        std::string tier_stat = "TIERED.tier" + std::to_string(i) + "." + t.cache_type + ".stat.log." + ts;
+        long blocks = static_cast<long>(t.capacity_bytes / cache_block_size_);
+        printf("tier %zu: %s, %lu bytes (%ld blocks), segment scale %.3f\n",
+               i, t.cache_type.c_str(), t.capacity_bytes, blocks, t.segment_scale);
+        g_segment_scale = t.segment_scale;
+        g_detached_cold_ftl = true;     // cold 쓰기는 evict_sink 로 가고, 마지막 tier 도 이 객체의 ftl 을 쓴다
+        ICache* tier = createCache(t.cache_type, blocks, cold_capacity, cache_block_size_, false, "", "",
+                                   tier_waf, 0.0, tier_stat);
+        g_detached_cold_ftl = false;
+        g_segment_scale = saved_scale;
+        assert(tier);
+        tier->rename_stat_log(tier_stat);
+        links_.emplace_back(new TierLink(*this, i));
+        tier->evict_sink = links_.back().get();
+        tiers_.emplace_back(tier);
+    }
+}
+
+TieredCache::~TieredCache()
+{
+    print_tier_stats(stdout);
+    print_tier_stats(fp_stats);
+}
+
+bool TieredCache::exists(long key)
+{
+    for (auto& t : tiers_) {
+        if (t->exists(key)) return true;
+    }
+    return false;
+}
+
+void TieredCache::touch(long key, OP_TYPE op_type)
+{
+    tiers_[0]->touch(key, op_type);
+}
+
+bool TieredCache::is_cache_filled()
+{
+    return tiers_[0]->is_cache_filled();
+}
+
+std::size_t TieredCache::size()
+{
+    std::size_t n = 0;
+    for (auto& t : tiers_) n += t->size();
+    return n;
+}
+
+void TieredCache::batch_insert(int stream_id, const std::map<long, int>& newBlocks, OP_TYPE op_type)
+{
+    // host 요청 범위 / volume 은 맨 위 tier 만 본다 (아래 tier 로는 block 단위 eviction 만 내려간다)
+    tiers_[0]->set_request(req_offset, req_size, req_volume);
+    tiers_[0]->batch_insert(stream_id, newBlocks, op_type);
+    tiers_[0]->set_request(-1, 0);
+    drain();
+    sync_counters();
+}
+
+void TieredCache::evict_one_block()
+{
+    tiers_[0]->evict_one_block();
+    drain();
+    sync_counters();
+}
+
+// 위 tier 부터: tier i 를 채우는 동안 생긴 eviction 은 pending_[i + 1] 로 가므로 한 번 내려가면 끝난다
+void TieredCache::drain()
+{
+    for (std::size_t i = 1; i < tiers_.size(); ++i) {
+        if (pending_[i].empty()) continue;
+        std::map<long, int> batch;
+        batch.swap(pending_[i]);
+        tiers_[i]->batch_insert(0, batch, OP_TYPE::WRITE);
+    }
+}
+
+void TieredCache::on_tier_evict(std::size_t from, uint64_t lba_offset, int lba_size)
+{
+    evict_bytes_[from] += lba_size;
+    std::size_t below = from + 1;
+    if (below == tiers_.size()) {
+        // 마지막 tier → cold tier (ftl), waf log 는 hierarchy 전체 기준
+        evicted_blocks += (lba_size + cache_block_size_ - 1) / cache_block_size_;
+        sync_counters();
+        _evict_one_block(lba_offset, lba_size, OP_TYPE::WRITE);
+        return;
+    }
+    // eviction 은 여러 block (64K / 순차 bypass) 일 수 있으니 block 단위로 쪼갠다
+    uint64_t end = lba_offset + lba_size;
+    for (uint64_t off = lba_offset; off < end; ) {
+        uint64_t key = off / cache_block_size_;
+        uint64_t block_end = std::min<uint64_t>((key + 1) * cache_block_size_, end);
+        pending_[below][static_cast<long>(key)] = static_cast<int>(block_end - off);
+        off = block_end;
+    }
+}
+
+bool TieredCache::valid_mpc_enabled()
+{
+    for (auto& tier : tiers_) {
+        if (tier->valid_mpc_enabled()) return true;
+    }
+    return false;
+}
+
+void TieredCache::on_tier_trim(std::size_t from, uint64_t lba_offset, int lba_size)
+{
+    std::size_t below = from + 1;
+    if (below == tiers_.size()) {
+        _invalidate_cold_block(lba_offset, lba_size, OP_TYPE::TRIM);
+        return;
+    }
+    uint64_t end = lba_offset + lba_size;
+    for (uint64_t off = lba_offset; off < end; ) {
+        uint64_t key = off / cache_block_size_;
+        uint64_t block_end = std::min<uint64_t>((key + 1) * cache_block_size_, end);
+        // 아직 안 넘긴 eviction 이면 그 copy 만 버린다 (below tier 의 옛 copy 는 그 block 이 위로 올 때 이미 무효화됨)
+        auto it = pending_[below].find(static_cast<long>(key));
+        if (it != pending_[below].end()) {
+            pending_[below].erase(it);
+            ++pending_trims_;
+        } else {
+            tiers_[below]->trim(static_cast<long>(key), static_cast<int>(block_end - off));
+        }
+        off = block_end;
+    }
+}
+
+// cache_sim 은 get_status() 로 이 객체의 member 를 읽는다: cache write 는 tier 0, evicted 는 cold tier 로 간 block
+void TieredCache::sync_counters()
+{
+    write_size_to_cache = tiers_[0]->write_size_to_cache;
+    write_hit_size = tiers_[0]->write_hit_size;
+}
+
+void TieredCache::print_stats()
+{
+    for (auto& t : tiers_) t->print_stats();
+    if (static_cast<uint64_t>(write_size_to_cache) >= next_stats_bytes_) {
+        print_tier_stats(fp_stats);
+        fflush(fp_stats);
+        next_stats_bytes_ += STATS_PRINT_INTERVAL;
+    }
+}
+
+// tier 별 host (위 tier 에서 admit 된 것 포함) / GC / eviction bytes 와 tier WAF = (host + GC) / host
+void TieredCache::print_tier_stats(FILE* fp)
+{
+    if (!fp) return;
+    for (std::size_t i = 0; i < tiers_.size(); ++i) {
+        uint64_t host = static_cast<uint64_t>(tiers_[i]->write_size_to_cache);
+        uint64_t gc = tiers_[i]->gc_write_blocks() * static_cast<uint64_t>(cache_block_size_);
+        fprintf(fp, "TIERED tier: %zu type: %s capacity: %lu host_bytes: %lu gc_bytes: %lu evict_bytes: %lu waf: %.4f\n",
+                i, specs_[i].cache_type.c_str(), specs_[i].capacity_bytes, host, gc, evict_bytes_[i],
+                host ? static_cast<double>(host + gc) / host : 0.0);
+    }
+    uint64_t cold_host = ftl.GetHostWriteBytes();
+    uint64_t cold_nand = ftl.GetNandWriteBytes();
+    fprintf(fp, "TIERED cold host_bytes: %lu nand_bytes: %lu waf: %.4f pending_trims: %lu\n",
+            cold_host, cold_nand, cold_host ? static_cast<double>(cold_nand) / cold_host : 0.0, pending_trims_);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "icache.h"
+
+// ===== N-tier cache hierarchy (SLC → TLC → QLC ...) =====
+// --cache_policy TIERED --tiers "TYPE:SIZE[:SEG_SCALE],..." (위 tier 부터, SIZE 는 bytes 이고 K/M/G 접미사 가능)
+// 각 tier 는 createCache 로 만든 보통 cache 라서 policy, segment 크기 (LogCache 계열: 1 GB × SEG_SCALE), stat/waf log 를 따로 가진다.
+// tier i 의 eviction / trim 은 IEvictSink 로 받아 tier i+1 로 넘기고, 마지막 tier 의 eviction 은 이 객체의 ftl (cold tier) 로 간다.
+//  - host write 는 tier 0 로. tier 0 에 없던 block 은 trim 이 아래 tier 로 내려가며 옛 copy 를 무효화한다
+//  - tier 간 eviction 은 host 요청 하나가 끝날 때까지 모았다가 위 tier 부터 차례로 batch_insert 한다
+//    (한 tier 의 GC 도중에 다른 tier 의 GC 가 돌면 score 함수가 보는 thread_local g_threshold / g_timestamp 가 섞인다)
+//  - read 는 tier 0 에만 넘긴다 (아래 tier 에서 위로의 promotion 은 모델링하지 않음)
+//  - stream interval 처럼 tier 간 공유되는 전역은 마지막에 만든 tier 기준이고, MIDAS_CACHE 는 전역 상태 때문에 한 tier 만 가능
+struct TierSpec {
+    std::string cache_type;
+    uint64_t    capacity_bytes = 0;
+    double      segment_scale = 1.0;
+};
+
+class TieredCache : public ICache {
+public:
+    TieredCache(uint64_t cold_capacity, int cache_block_size, const std::vector<TierSpec>& specs,
+                const std::string& waf_log_file, const std::string& stat_log_file);
+    ~TieredCache() override;
+
+    bool        exists(long key) override;
+    void        touch(long key, OP_TYPE op_type) override;
+    void        batch_insert(int stream_id, const std::map<long, int>& newBlocks, OP_TYPE op_type) override;
+    bool        is_cache_filled() override;
+    int         get_block_size() override { return cache_block_size_; }
+    void        evict_one_block() override;
+    std::size_t size() override;
+    void        print_stats() override;
+    bool        valid_mpc_enabled() override;
+
+    // "TYPE:SIZE[:SEG_SCALE],..." → specs, 잘못된 spec 이면 false 와 이유
+    static bool parse_tiers(const std::string& spec, std::vector<TierSpec>& out, std::string& error);
+
+private:
+    // tier from 이 내보내는 write / trim 을 받아 owner 의 tier from + 1 (없으면 cold) 로 넘긴다
+    class TierLink : public IEvictSink {
+    public:
+        TierLink(TieredCache& owner, std::size_t from) : owner_(owner), from_(from) {}
+        void sink_write(uint64_t lba_offset, int lba_size) override { owner_.on_tier_evict(from_, lba_offset, lba_size); }
+        void sink_trim(uint64_t lba_offset, int lba_size) override { owner_.on_tier_trim(from_, lba_offset, lba_size); }
+    private:
+        TieredCache& owner_;
+        std::size_t  from_;
+    };
+
+    void on_tier_evict(std::size_t from, uint64_t lba_offset, int lba_size);
+    void on_tier_trim(std::size_t from, uint64_t lba_offset, int lba_size);
+    void drain();
+    void sync_counters();
+    void print_tier_stats(FILE* fp);
+
+    const int cache_block_size_;
+    std::vector<TierSpec>                 specs_;
+    std::vector<std::unique_ptr<ICache>>  tiers_;
+    std::vector<std::unique_ptr<TierLink>> links_;
+    std::vector<std::map<long, int>>      pending_;     // [i] = tier i 로 아직 안 넘긴 eviction (i >= 1)
+    std::vector<uint64_t>                 evict_bytes_; // [i] = tier i 가 내보낸 bytes
+    uint64_t pending_trims_ = 0;      // 넘기기 전에 위에서 다시 쓰여 버려진 eviction block
+    uint64_t next_stats_bytes_;
+    static constexpr uint64_t STATS_PRINT_INTERVAL = 10ull * 1024ull * 1024ull * 1024ull; // 10 GB
+};
+
+// cache_sim --tiers: createCache("TIERED") 가 읽는다
+extern std::string g_tiers;
@@ -0,0 +1,207 @@
+#include "valid_mpc.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+int    g_valid_mpc_horizon = 0;
+double g_valid_mpc_step_gb = 10.0;
+
+namespace {
+int util_bin(double u) {
+    return static_cast<int>(std::lround(std::min(1.0, std::max(0.0, u)) * 100.0));
+}
+double copy_cost(double a) {
+    return a / (1.0 - a);
+}
+}
+
+void CompactionCurve::record(double util, double copied_fraction) {
+    Bin& b = bins_[util_bin(util)];
+    b.a.push_back(copied_fraction);
+    b.sum += copied_fraction;
+    if (b.a.size() > WINDOW) {
+        b.sum -= b.a.front();
+        b.a.pop_front();
+    }
+}
+
+// (a-1)/ln a 는 (0,1) 에서 단조 증가라 이분 탐색으로 푼다
+double CompactionCurve::model(double util) {
+    util = std::min(0.999, std::max(0.001, util));
+    double lo = 1e-9, hi = 1.0 - 1e-9;
+    for (int i = 0; i < 50; ++i) {
+        double mid = 0.5 * (lo + hi);
+        if ((mid - 1.0) / std::log(mid) < util) lo = mid;
+        else hi = mid;
+    }
+    return 0.5 * (lo + hi);
+}
+
+double CompactionCurve::copied_fraction(double level) const {
+    const int bin = util_bin(level);
+    double a = model(level);
+    for (int d = 0; d <= 100; ++d) {
+        for (int n : {bin - d, bin + d}) {
+            if (n < 0 || n > 100 || bins_[n].a.size() < MIN_SAMPLES) continue;
+            a += bins_[n].sum / bins_[n].a.size() - model(n / 100.0);
+            return std::min(0.99, std::max(0.0, a));
+        }
+    }
+    return std::min(0.99, a);
+}
+
+double CompactionCurve::delta(double util, double level) const {
+    return copy_cost(copied_fraction(level)) - copy_cost(copied_fraction(util));
+}
+
+void ValidRateMpc::Window::push(Delta x) {
+    d.push_back(x);
+    sum_c += x.compaction;
+    sum_e += x.eviction;
+    if (d.size() > static_cast<std::size_t>(MA_WINDOW)) {
+        sum_c -= d.front().compaction;
+        sum_e -= d.front().eviction;
+        d.pop_front();
+    }
+}
+
+ValidRateMpc::ValidRateMpc(int horizon, double qlc_factor, const std::vector<double>& shadow_ratios,
+                           uint64_t total_cache_blocks, double hard_limit,
+                           const CompactionCurve* curve, uint64_t step_blocks)
+    : horizon_(std::max(1, horizon)), qlc_(qlc_factor), ratios_(shadow_ratios),
+      total_blocks_(static_cast<double>(total_cache_blocks)), hard_limit_(hard_limit),
+      curve_(curve), step_blocks_(static_cast<double>(step_blocks)),
+      prev_shadow_(shadow_ratios.size(), 0), shadow_(shadow_ratios.size()), bins_(101)
+{
+    std::sort(ratios_.begin(), ratios_.end());
+}
+
+void ValidRateMpc::step(double util, uint64_t compacted_total, uint64_t evicted_total,
+                        const std::vector<uint64_t>& shadow_evicted_total) {
+    if (!started_) {
+        started_ = true;
+        prev_compacted_ = compacted_total;
+        prev_evicted_ = evicted_total;
+        prev_shadow_ = shadow_evicted_total;
+        return;
+    }
+    Delta d{static_cast<double>(compacted_total - prev_compacted_),
+            static_cast<double>(evicted_total - prev_evicted_)};
+    prev_compacted_ = compacted_total;
+    prev_evicted_ = evicted_total;
+    recent_.push(d);
+    int bin = static_cast<int>(std::lround(util * 100.0));
+    if (bin >= 0 && bin <= 100) bins_[bin].push(d);
+    for (std::size_t i = 0; i < shadow_.size(); ++i) {
+        shadow_[i].push({0.0, static_cast<double>(shadow_evicted_total[i] - prev_shadow_[i])});
+        prev_shadow_[i] = shadow_evicted_total[i];
+    }
+    ++steps_;
+    total_compaction_ += d.compaction;
+    total_eviction_ += d.eviction;
+}
+
+/* level 에서 한 step 동안의 예상 비용.
+ * 실측 bin 이 있으면 그것, 없으면 추정:
+ *   eviction   : +r 은 shadow(r), -r 은 지금 기준 대칭 외삽
+ *   compaction : 지금 + GC victim 곡선에서 util → level 의 변화량 (step 당 block 으로 환산) */
+double ValidRateMpc::level_cost(double level, double util, const Delta& cur) const {
+    int bin = static_cast<int>(std::lround(level * 100.0));
+    if (std::fabs(level - util) > 0.005 && bin >= 0 && bin <= 100 &&
+        bins_[bin].d.size() >= MIN_BIN_SAMPLES) {
+        Delta m = bins_[bin].mean();
+        return m.compaction + qlc_ * m.eviction;
+    }
+    double diff = level - util;
+    if (std::fabs(diff) <= 0.005) return cur.compaction + qlc_ * cur.eviction;
+
+    // 가장 가까운 shadow ratio
+    std::size_t best = 0;
+    for (std::size_t i = 1; i < ratios_.size(); ++i) {
+        if (std::fabs(ratios_[i] - std::fabs(diff)) < std::fabs(ratios_[best] - std::fabs(diff))) best = i;
+    }
+    double e_up = std::min(cur.eviction, shadow_[best].mean().eviction);
+    double compaction = cur.compaction;
+    if (curve_) compaction = std::max(0.0, compaction + curve_->delta(util, level) * step_blocks_);
+    return compaction + qlc_ * (diff > 0 ? e_up : 2 * cur.eviction - e_up);
+}
+
+double ValidRateMpc::decide(double util, double current_target) {
+    if (recent_.d.empty()) return current_target;
+    for (const auto& s : shadow_) {
+        if (s.d.empty()) return current_target;
+    }
+    Delta cur = recent_.mean();
+
+    // level: util 기준 -r ... 0 ... +r (범위 밖 제외)
+    std::vector<double> levels;
+    for (auto it = ratios_.rbegin(); it != ratios_.rend(); ++it) {
+        if (util - *it >= 0.0) levels.push_back(util - *it);
+    }
+    std::size_t start = levels.size();
+    levels.push_back(util);
+    for (double r : ratios_) {
+        if (util + r <= hard_limit_) levels.push_back(util + r);
+    }
+    const std::size_t K = levels.size();
+
+    std::vector<double> F(K);
+    for (std::size_t k = 0; k < K; ++k) F[k] = level_cost(levels[k], util, cur);
+
+    auto trans_penalty = [&](std::size_t from, std::size_t to) {
+        double diff = levels[to] - levels[from];
+        return diff > 0 ? diff * total_blocks_ : -diff * total_blocks_ * qlc_;
+    };
+
+    // DP[t][k]: t step 후 level k 에 있을 때 최소 누적 비용, first[t][k]: 그 경로의 첫 level
+    const double INF = std::numeric_limits<double>::infinity();
+    std::vector<double> dp(K, INF), next(K);
+    std::vector<std::size_t> first(K, start), next_first(K);
+    dp[start] = 0.0;
+    for (int t = 0; t < horizon_; ++t) {
+        std::fill(next.begin(), next.end(), INF);
+        for (std::size_t k = 0; k < K; ++k) {
+            for (std::size_t j = (k > 0 ? k - 1 : 0); j <= std::min(K - 1, k + 1); ++j) {
+                if (dp[j] == INF) continue;
+                double cand = dp[j] + trans_penalty(j, k) + F[k];
+                if (cand < next[k]) {
+                    next[k] = cand;
+                    next_first[k] = (t == 0) ? k : first[j];
+                }
+            }
+        }
+        dp.swap(next);
+        first.swap(next_first);
+    }
+    std::size_t bestk = start;
+    for (std::size_t k = 0; k < K; ++k) {
+        if (dp[k] < dp[bestk]) bestk = k;
+    }
+    std::size_t move = first[bestk];
+    double target = std::min(hard_limit_, std::max(0.0, levels[move]));
+
+    if (last_level_ >= 0.0 && std::fabs(target - last_level_) > 1e-9) {
+        double diff = target - last_level_;
+        total_transition_ += diff > 0 ? diff * total_blocks_ : -diff * total_blocks_ * qlc_;
+    }
+    last_level_ = target;
+    printf("valid_mpc: step=%lu util=%.4f F_hold=%.0f F_best=%.0f (level %.4f) horizon_cost=%.0f target=%.4f\n",
+           steps_, util, F[start], F[bestk], levels[bestk], dp[bestk], target);
+    return target;
+}
+
+void ValidRateMpc::print_summary(FILE* fp, uint64_t step_blocks, int block_size) const {
+    if (!fp) return;
+    double blk_to_tb = block_size / 1e12;
+    double host = static_cast<double>(steps_) * step_blocks;
+    fprintf(fp, "=== valid_mpc Cost Breakdown (TB) === steps=%lu horizon=%d qlc_factor=%.2f\n",
+            steps_, horizon_, qlc_);
+    fprintf(fp, "Host write:  %.6f\n", host * blk_to_tb);
+    fprintf(fp, "Compaction:  %.6f\n", total_compaction_ * blk_to_tb);
+    fprintf(fp, "Eviction:    %.6f (x%.2f = %.6f)\n", total_eviction_ * blk_to_tb, qlc_,
+            total_eviction_ * qlc_ * blk_to_tb);
+    fprintf(fp, "Total:       %.6f\n", (host + total_compaction_ + total_eviction_ * qlc_) * blk_to_tb);
+    fprintf(fp, "(planned transition penalty: %.6f, compare with: dp_optimizer --compare <stat log>)\n",
+            total_transition_ * blk_to_tb);
+}
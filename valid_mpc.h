@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+// ===== utilization 별 compaction 비용 곡선 =====
+// GC victim 마다 복사(compaction)한 block 비율 a 를 그때의 utilization(1% bin) 에 모은다.
+// victim 하나가 (1-a) 만큼 비우며 a 만큼 복사하므로 host block 당 compaction 은 a/(1-a).
+// 샘플이 부족한 bin 은 greedy/uniform 모델 u = (a-1)/ln a 를 가장 가까운 실측 bin 에
+// 맞춰(offset) 옮겨 쓴다. 실측이 하나도 없으면 delta 는 모델만으로 구한다.
+class CompactionCurve {
+public:
+    static constexpr std::size_t WINDOW = 64;      // bin 별 최근 victim 수
+    static constexpr std::size_t MIN_SAMPLES = 8;
+
+    void record(double util, double copied_fraction);
+    // utilization 을 util 에서 level 로 옮겼을 때 host block 당 compaction 변화량
+    double delta(double util, double level) const;
+
+private:
+    struct Bin {
+        std::deque<double> a;
+        double sum = 0.0;
+    };
+    double copied_fraction(double level) const;
+    static double model(double util);              // greedy 모델의 victim 복사 비율
+
+    std::array<Bin, 101> bins_;
+};
+
+// ===== Online model-predictive valid-ratio controller =====
+// dp_optimizer.cpp 의 offline DP 를 LogCache 안에서 짧은 horizon 으로 매 step 다시 푼다.
+//  - step   : host write step_blocks 마다 (기본 10 GB = dp.* log 한 줄 간격)
+//  - cost   : F = compaction + qlc_factor * eviction (step 당 block 수, MA_WINDOW 이동평균)
+//  - level  : 현재 utilization 과 ±shadow ratio 만큼 떨어진 utilization 들.
+//             그 utilization(1% bin) 에서 실제로 돌았던 기록이 있으면 그 이동평균을 쓰고,
+//             없으면 eviction 은 ghost shadow 로, compaction 은 CompactionCurve 로 추정한다
+//             (LogCache::periodic_ghost_shadow 와 같은 모델)
+//  - 전이   : step 당 인접 level 로만 (dp_optimizer 의 ±1), 올릴 때 diff*blocks (compaction),
+//             내릴 때 diff*blocks*qlc_factor (eviction) penalty
+// horizon 끝까지의 최소 비용 경로 중 첫 step 의 level 을 target 으로 돌려준다.
+class ValidRateMpc {
+public:
+    static constexpr int MA_WINDOW = 24;          // dp_optimizer 와 동일 (240 GB)
+    static constexpr std::size_t MIN_BIN_SAMPLES = 4;
+
+    // curve 는 호출자(LogCache) 소유, step_blocks 는 step 당 host write block 수
+    ValidRateMpc(int horizon, double qlc_factor, const std::vector<double>& shadow_ratios,
+                 uint64_t total_cache_blocks, double hard_limit,
+                 const CompactionCurve* curve, uint64_t step_blocks);
+
+    // step 끝에서 누적 counter 를 넣는다 (첫 호출은 baseline)
+    void step(double util, uint64_t compacted_total, uint64_t evicted_total,
+              const std::vector<uint64_t>& shadow_evicted_total);
+
+    // util 에서 DP 를 풀어 다음 target. 데이터가 부족하면 current_target 그대로
+    double decide(double util, double current_target);
+
+    // dp_optimizer 의 "Cost Breakdown (TB)" 와 같은 형식
+    void print_summary(FILE* fp, uint64_t step_blocks, int block_size) const;
+
+private:
+    struct Delta {
+        double compaction;
+        double eviction;
+    };
+    struct Window {
+        std::deque<Delta> d;
+        double sum_c = 0.0;
+        double sum_e = 0.0;
+        void push(Delta x);
+        Delta mean() const { return {sum_c / d.size(), sum_e / d.size()}; }
+    };
+
+    double level_cost(double level, double util, const Delta& cur) const;
+
+    int horizon_;
+    double qlc_;
+    std::vector<double> ratios_;                 // shadow ratio (오름차순)
+    double total_blocks_;
+    double hard_limit_;
+    const CompactionCurve* curve_;
+    double step_blocks_;
+
+    bool started_ = false;
+    uint64_t prev_compacted_ = 0;
+    uint64_t prev_evicted_ = 0;
+    std::vector<uint64_t> prev_shadow_;
+
+    Window recent_;                              // 최근 step (utilization 무관)
+    std::vector<Window> shadow_;                 // shadow 별 eviction (compaction 칸은 미사용)
+    std::vector<Window> bins_;                   // utilization 1% bin 별 실측
+
+    // 보고용 누적
+    uint64_t steps_ = 0;
+    double total_compaction_ = 0.0;
+    double total_eviction_ = 0.0;
+    double total_transition_ = 0.0;              // target 변경 시 penalty 추정치
+    double last_level_ = -1.0;
+};
+
+// cache_sim --valid_mpc H [--valid_mpc_step_gb G]. 0 이면 끔
+extern int    g_valid_mpc_horizon;
+extern double g_valid_mpc_step_gb;
@@ -0,0 +1,195 @@
+#include "write_buffer.h"
+
+#include <algorithm>
+
+namespace {
+// destage batch: 1 MiB (4 KiB block 기준), buffer 가 작으면 1/4
+constexpr uint64_t kDestageBatchBlocks = 256;
+
+// mask 가 [k, top) 꼴 (block 끝까지 이어짐) / [0, k) 꼴 (block 처음부터 이어짐) 인지
+inline bool reaches_end(uint64_t mask, uint64_t full)   { return mask && ((mask | (mask - 1)) & full) == full; }
+inline bool starts_at_zero(uint64_t mask)               { return mask && (mask & (mask + 1)) == 0; }
+}
+
+WriteBuffer::WriteBuffer(ICache& cache, uint64_t capacity_blocks, Policy policy)
+    : cache_(cache),
+      capacity_(std::max<uint64_t>(1, capacity_blocks)),
+      batch_(std::max<uint64_t>(1, std::min(kDestageBatchBlocks, capacity_ / 4))),
+      policy_(policy),
+      block_size_(cache.get_block_size())
+{
+    // sector 단위, block 당 64 개가 넘으면 더 굵게
+    unit_ = std::max<int>(static_cast<int>(g_nand_geometry.sector_size), (block_size_ + 63) / 64);
+    const int units = (block_size_ + unit_ - 1) / unit_;
+    full_mask_ = units >= 64 ? ~0ull : ((1ull << units) - 1);
+    entries_.reserve(capacity_);
+    printf("write_buffer: %lu blocks, policy=%s, destage batch=%lu blocks, unit=%d bytes\n",
+           capacity_, policy_name(policy_), batch_, unit_);
+}
+
+bool WriteBuffer::parse_policy(const std::string& name, Policy& out)
+{
+    if (name == "fifo")  { out = Policy::FIFO;  return true; }
+    if (name == "lru")   { out = Policy::LRU;   return true; }
+    if (name == "clock") { out = Policy::CLOCK; return true; }
+    return false;
+}
+
+const char* WriteBuffer::policy_name(Policy p)
+{
+    switch (p) {
+    case Policy::FIFO:  return "fifo";
+    case Policy::LRU:   return "lru";
+    case Policy::CLOCK: return "clock";
+    }
+    return "?";
+}
+
+// block key 안에서 요청이 덮는 unit. 요청 범위를 모르면 앞에서부터 size bytes
+uint64_t WriteBuffer::unit_mask(long key, long long lba_offset, int lba_size, int size) const
+{
+    const long long blk_start = static_cast<long long>(key) * block_size_;
+    const long long blk_end = blk_start + block_size_;
+    long long s = 0, e = std::min(size, block_size_);
+    if (lba_offset >= 0 && lba_offset < blk_end && lba_offset + lba_size > blk_start) {
+        s = std::max(lba_offset, blk_start) - blk_start;
+        e = std::min(lba_offset + lba_size, blk_end) - blk_start;
+    }
+    const long long first = s / unit_;
+    const long long n = (e + unit_ - 1) / unit_ - first;
+    if (n <= 0) return 0;
+    return (n >= 64 ? ~0ull : ((1ull << n) - 1) << first) & full_mask_;
+}
+
+int WriteBuffer::mask_bytes(uint64_t mask) const
+{
+    return mask == full_mask_ ? block_size_ : std::min(block_size_, __builtin_popcountll(mask) * unit_);
+}
+
+void WriteBuffer::submit(long long lba_offset, int lba_size, const std::map<long, int>& blocks, OP_TYPE op_type, int volume)
+{
+    if (op_type == OP_TYPE::READ) {
+        std::map<long, int> miss;
+        for (const auto& kv : blocks) {
+            ++read_blocks_;
+            auto found = entries_.find(kv.first);
+            if (found != entries_.end()) {
+                if ((unit_mask(kv.first, lba_offset, lba_size, kv.second) & ~found->second.mask) == 0) {
+                    ++read_hits_;
+                    continue;
+                }
+                ++read_partial_hits_;
+            }
+            miss.insert(kv);
+        }
+        if (miss.empty()) return;
+        cache_.set_request(lba_offset, lba_size, volume);
+        cache_.batch_insert(0, miss, op_type);
+        cache_.set_request(-1, 0);
+        return;
+    }
+    for (const auto& kv : blocks) {
+        insert(kv.first, unit_mask(kv.first, lba_offset, lba_size, kv.second), kv.second, volume);
+    }
+}
+
+void WriteBuffer::insert(long key, uint64_t mask, int size, int volume)
+{
+    ++host_blocks_;
+    host_bytes_ += size;
+    auto found = entries_.find(key);
+    if (found != entries_.end()) {
+        Entry& e = found->second;
+        ++absorbed_blocks_;
+        if (mask & ~e.mask) ++merged_blocks_;
+        e.mask |= mask;
+        e.volume = volume;
+        if (policy_ == Policy::LRU) {
+            order_.splice(order_.end(), order_, e.it);
+        } else if (policy_ == Policy::CLOCK) {
+            e.ref = true;
+        }
+        return;
+    }
+    if (entries_.size() >= capacity_) {
+        destage(batch_);
+    }
+    order_.push_back(key);
+    entries_[key] = {std::prev(order_.end()), mask, volume, false};
+}
+
+void WriteBuffer::flush()
+{
+    while (!entries_.empty()) {
+        destage(batch_);
+    }
+}
+
+// n 개를 골라 LBA 순으로 정렬하고, host 요청 하나로 이어 붙일 수 있는 구간마다 batch_insert
+// (같은 volume, 앞 block 은 끝까지 / 뒤 block 은 처음부터 쓰였을 때만 잇는다)
+void WriteBuffer::destage(uint64_t n)
+{
+    std::map<long, std::pair<uint64_t, int>> batch;   // key → (mask, volume)
+    while (batch.size() < n && !order_.empty()) {
+        long key = order_.front();
+        auto found = entries_.find(key);
+        if (policy_ == Policy::CLOCK && found->second.ref) {
+            found->second.ref = false;
+            order_.splice(order_.end(), order_, order_.begin());
+            continue;
+        }
+        batch[key] = {found->second.mask, found->second.volume};
+        destaged_bytes_ += mask_bytes(found->second.mask);
+        order_.pop_front();
+        entries_.erase(found);
+    }
+    if (batch.empty()) return;
+    ++destage_batches_;
+    destaged_blocks_ += batch.size();
+
+    std::map<long, uint64_t> run;
+    long prev = 0;
+    uint64_t prev_mask = 0;
+    int run_volume = 0;
+    for (const auto& kv : batch) {
+        const uint64_t mask = kv.second.first;
+        const int volume = kv.second.second;
+        if (!run.empty() && (kv.first != prev + 1 || volume != run_volume ||
+                             !reaches_end(prev_mask, full_mask_) || !starts_at_zero(mask))) {
+            emit(run, run_volume);
+            run.clear();
+        }
+        run[kv.first] = mask;
+        prev = kv.first;
+        prev_mask = mask;
+        run_volume = volume;
+    }
+    emit(run, run_volume);
+}
+
+void WriteBuffer::emit(const std::map<long, uint64_t>& run, int volume)
+{
+    std::map<long, int> blocks;
+    for (const auto& kv : run) blocks[kv.first] = mask_bytes(kv.second);
+    // 요청 범위: 첫 block 의 첫 unit ~ 마지막 block 의 마지막 unit (한 block 안의 mask 가 끊겨 있으면 그 사이도 포함)
+    const long first = run.begin()->first, last = run.rbegin()->first;
+    const long long start = static_cast<long long>(first) * block_size_ + __builtin_ctzll(run.begin()->second) * unit_;
+    const long long end = std::min(static_cast<long long>(last) * block_size_ + (64 - __builtin_clzll(run.rbegin()->second)) * unit_,
+                                   static_cast<long long>(last + 1) * block_size_);
+    cache_.set_request(start, static_cast<int>(end - start), volume);
+    cache_.batch_insert(0, blocks, OP_TYPE::WRITE);
+    cache_.set_request(-1, 0);
+    ++destage_runs_;
+}
+
+void WriteBuffer::print_stats(FILE* fp) const
+{
+    if (!fp) return;
+    fprintf(fp, "write_buffer policy: %s capacity_blocks: %lu host_blocks: %lu host_bytes: %lu absorbed_blocks: %lu "
+                "absorbed_ratio: %.4f merged_blocks: %lu destaged_blocks: %lu destaged_bytes: %lu destage_batches: %lu destage_runs: %lu "
+                "buffered_blocks: %zu read_hits: %lu read_partial_hits: %lu read_blocks: %lu\n",
+            policy_name(policy_), capacity_, host_blocks_, host_bytes_, absorbed_blocks_,
+            host_blocks_ ? static_cast<double>(absorbed_blocks_) / host_blocks_ : 0.0, merged_blocks_,
+            destaged_blocks_, destaged_bytes_, destage_batches_, destage_runs_,
+            entries_.size(), read_hits_, read_partial_hits_, read_blocks_);
+}
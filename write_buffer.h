@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include "icache.h"
+
+// ===== DRAM/NVDIMM write-back buffer (cache 앞단) =====
+// host write 를 block 단위로 먼저 받아서 buffer 에 있는 동안의 overwrite 는 흡수(coalesce)하고,
+// 가득 차면 destage 정책으로 고른 batch 를 LBA 순으로 정렬해 연속 구간마다 cache->batch_insert 로 넘긴다.
+//  - FIFO : 처음 들어온 순서
+//  - LRU  : overwrite 되면 맨 뒤로
+//  - CLOCK: overwrite 되면 reference bit, destage 때 bit 가 있으면 지우고 한 바퀴 더 (second chance)
+// block 안에서 쓰인 부분은 unit (sector, block 당 최대 64 개) mask 로 합친다.
+// read 는 buffer 가 요청 부분을 다 갖고 있는 block 은 buffer 에서 끝내고 나머지만 cache 로 넘긴다.
+// trace 가 끝나면 flush() 로 남은 block 을 전부 destage 한다.
+class WriteBuffer {
+public:
+    enum class Policy { FIFO, LRU, CLOCK };
+
+    WriteBuffer(ICache& cache, uint64_t capacity_blocks, Policy policy);
+
+    // blocks 는 host 요청 [lba_offset, lba_offset + lba_size) 를 block 으로 나눈 것 (lba_offset < 0 이면 block 앞에서부터 채운 것으로 본다)
+    void submit(long long lba_offset, int lba_size, const std::map<long, int>& blocks, OP_TYPE op_type, int volume = 0);
+    void flush();
+    void print_stats(FILE* fp) const;
+    uint64_t host_bytes() const { return host_bytes_; }
+
+    static bool parse_policy(const std::string& name, Policy& out);
+    static const char* policy_name(Policy p);
+
+private:
+    struct Entry {
+        std::list<long>::iterator it;
+        uint64_t mask;              // block 안에서 쓰인 unit
+        int  volume;
+        bool ref;                   // CLOCK reference bit
+    };
+
+    uint64_t unit_mask(long key, long long lba_offset, int lba_size, int size) const;
+    int      mask_bytes(uint64_t mask) const;
+    void insert(long key, uint64_t mask, int size, int volume);
+    void destage(uint64_t n);
+    void emit(const std::map<long, uint64_t>& run, int volume);
+
+    ICache&  cache_;
+    uint64_t capacity_;
+    uint64_t batch_;                // destage 한 번에 내보내는 block 수
+    Policy   policy_;
+    int      block_size_;
+    int      unit_;                 // mask 1 bit 의 bytes
+    uint64_t full_mask_;
+    std::list<long> order_;         // 앞쪽이 destage 후보
+    std::unordered_map<long, Entry> entries_;
+
+    uint64_t host_blocks_ = 0;      // buffer 로 들어온 host write block
+    uint64_t host_bytes_ = 0;
+    uint64_t absorbed_blocks_ = 0;  // buffer 안에서 overwrite 되어 cache 로 안 간 block
+    uint64_t merged_blocks_ = 0;    // 그중 이전 write 와 다른 부분을 써서 mask 가 넓어진 block
+    uint64_t destaged_blocks_ = 0;
+    uint64_t destaged_bytes_ = 0;
+    uint64_t destage_batches_ = 0;
+    uint64_t destage_runs_ = 0;     // batch_insert 호출 수 (연속 구간 수)
+    uint64_t read_blocks_ = 0;
+    uint64_t read_hits_ = 0;        // buffer 에서 끝낸 read block (cache 로 안 넘김)
+    uint64_t read_partial_hits_ = 0;// buffer 에 일부만 있어서 cache 로 넘긴 read block
+};